@@ -0,0 +1,122 @@
+/**
+ * Spawns 10k bodies the way PhysicsSystem does, a pooled CollisionBody with a shape and a
+ * btRigidBody each, with a shape allocated per entity against shapes from the
+ * CollisionShapeCache. The entities draw their dimensions from a palette of range(0) sizes,
+ * from a few prefabs up to every entity its own. Reports the time per body and the number and
+ * bytes of the shape objects alive once all bodies exist.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <btBulletDynamicsCommon.h>
+
+#include "collision-shape-cache.hpp"
+#include "component-pool.hpp"
+#include "components/collision-body.hpp"
+
+namespace tec {
+namespace {
+const std::int64_t ENTITY_COUNT = 10000;
+
+// Boxes, spheres and capsules in turn, sizes stepping by 1cm through the palette.
+struct ShapeSpec {
+	int kind;
+	float size;
+};
+
+ShapeSpec GetSpec(const std::int64_t entity, const std::int64_t palette_size) {
+	const std::int64_t variant = entity % palette_size;
+	return ShapeSpec{static_cast<int>(variant % 3), 0.25f + static_cast<float>(variant) * 0.01f};
+}
+
+btRigidBody* CreateRigidBody(CollisionBody* collision_body) {
+	btVector3 inertia(0, 0, 0);
+	collision_body->shape->calculateLocalInertia(collision_body->mass, inertia);
+	btRigidBody::btRigidBodyConstructionInfo info(
+			collision_body->mass, &collision_body->motion_state, collision_body->shape.get(), inertia);
+	return new btRigidBody(info);
+}
+
+void Teardown(std::vector<btRigidBody*>& bodies) {
+	for (btRigidBody* body : bodies) {
+		delete body;
+	}
+	bodies.clear();
+	ComponentPool<CollisionBody>::Get().ReleaseAll();
+}
+
+void ReportPerBody(benchmark::State& state, const std::size_t shapes, const std::size_t shape_bytes) {
+	state.counters["time_per_body"] = benchmark::Counter(
+			static_cast<double>(state.iterations() * ENTITY_COUNT),
+			benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+	state.counters["shapes"] = static_cast<double>(shapes);
+	state.counters["shape_bytes"] = static_cast<double>(shape_bytes);
+}
+
+// What CollisionBody::Set*Shape() did before the cache.
+void BM_SpawnPerEntityShapes(benchmark::State& state) {
+	std::vector<btRigidBody*> bodies;
+	bodies.reserve(ENTITY_COUNT);
+	std::size_t shape_bytes = 0;
+	for (auto _ : state) {
+		shape_bytes = 0;
+		for (std::int64_t entity = 0; entity < ENTITY_COUNT; ++entity) {
+			CollisionBody* collision_body = ComponentPool<CollisionBody>::Create();
+			collision_body->mass = 1.f;
+			const ShapeSpec spec = GetSpec(entity, state.range(0));
+			switch (spec.kind) {
+			case 0:
+				collision_body->shape.reset(new btBoxShape(btVector3(spec.size, spec.size, spec.size)));
+				shape_bytes += sizeof(btBoxShape);
+				break;
+			case 1:
+				collision_body->shape.reset(new btSphereShape(spec.size));
+				shape_bytes += sizeof(btSphereShape);
+				break;
+			default:
+				collision_body->shape.reset(new btCapsuleShape(spec.size, spec.size * 2.f));
+				shape_bytes += sizeof(btCapsuleShape);
+				break;
+			}
+			bodies.push_back(CreateRigidBody(collision_body));
+		}
+		state.PauseTiming();
+		Teardown(bodies);
+		state.ResumeTiming();
+	}
+	ReportPerBody(state, ENTITY_COUNT, shape_bytes);
+}
+BENCHMARK(BM_SpawnPerEntityShapes)->Arg(16)->Arg(256)->Arg(ENTITY_COUNT)->Unit(benchmark::kMillisecond);
+
+void BM_SpawnCachedShapes(benchmark::State& state) {
+	CollisionShapeCache& cache = CollisionShapeCache::Get();
+	std::vector<btRigidBody*> bodies;
+	bodies.reserve(ENTITY_COUNT);
+	CollisionShapeCacheStats spawned;
+	for (auto _ : state) {
+		for (std::int64_t entity = 0; entity < ENTITY_COUNT; ++entity) {
+			CollisionBody* collision_body = ComponentPool<CollisionBody>::Create();
+			collision_body->mass = 1.f;
+			const ShapeSpec spec = GetSpec(entity, state.range(0));
+			switch (spec.kind) {
+			case 0: collision_body->SetBoxShape(spec.size, spec.size, spec.size); break;
+			case 1: collision_body->SetSphereShape(spec.size); break;
+			default: collision_body->SetCapsuleShape(spec.size, spec.size * 2.f); break;
+			}
+			bodies.push_back(CreateRigidBody(collision_body));
+		}
+		state.PauseTiming();
+		spawned = cache.GetStats();
+		Teardown(bodies);
+		state.ResumeTiming();
+	}
+	cache.Evict();
+	ReportPerBody(state, spawned.live_shapes, spawned.live_bytes);
+}
+BENCHMARK(BM_SpawnCachedShapes)->Arg(16)->Arg(256)->Arg(ENTITY_COUNT)->Unit(benchmark::kMillisecond);
+} // namespace
+} // namespace tec
@@ -0,0 +1,103 @@
+/**
+ * Compares the per-entity Entity::GetList lookups against ComponentView joins.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "component-view.hpp"
+#include "components/transforms.hpp"
+#include "entity.hpp"
+
+namespace tec {
+namespace {
+const eid BASE_ENTITY_ID = 10000;
+
+// Every entity gets a Position, every other an Orientation and every fourth a Scale.
+void PopulateEntities(const std::int64_t count) {
+	for (eid entity_id = BASE_ENTITY_ID; entity_id < BASE_ENTITY_ID + count; ++entity_id) {
+		Entity entity(entity_id);
+		entity.Add<Position>(glm::vec3(static_cast<float>(entity_id)));
+		if (entity_id % 2 == 0) {
+			entity.Add<Orientation>(glm::vec3(0.f));
+		}
+		if (entity_id % 4 == 0) {
+			entity.Add<Scale>(glm::vec3(1.f));
+		}
+	}
+}
+
+void ClearEntities(const std::int64_t count) {
+	for (eid entity_id = BASE_ENTITY_ID; entity_id < BASE_ENTITY_ID + count; ++entity_id) {
+		Entity entity(entity_id);
+		entity.Remove<Position>();
+		entity.Remove<Orientation>();
+		entity.Remove<Scale>();
+	}
+}
+
+void BM_EntityGetList(benchmark::State& state) {
+	PopulateEntities(state.range(0));
+	for (auto _ : state) {
+		glm::vec3 sum{0.f};
+		for (auto itr = Multiton<eid, Position*>::Begin(); itr != Multiton<eid, Position*>::End(); ++itr) {
+			auto [position, orientation, scale] = Entity(itr->first).GetList<Position, Orientation, Scale>();
+			if (orientation && scale) {
+				sum += position->value * scale->value;
+			}
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	ClearEntities(state.range(0));
+}
+BENCHMARK(BM_EntityGetList)->Arg(1000)->Arg(10000)->Arg(100000);
+
+void BM_ComponentView(benchmark::State& state) {
+	PopulateEntities(state.range(0));
+	ComponentView<Position, Orientation, Scale> view;
+	for (auto _ : state) {
+		glm::vec3 sum{0.f};
+		view.Each([&sum](eid, const Position* position, const Orientation*, const Scale* scale) {
+			sum += position->value * scale->value;
+		});
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	ClearEntities(state.range(0));
+}
+BENCHMARK(BM_ComponentView)->Arg(1000)->Arg(10000)->Arg(100000);
+
+void BM_CachedComponentView(benchmark::State& state) {
+	PopulateEntities(state.range(0));
+	CachedComponentView<Position, Orientation, Scale> view;
+	for (auto _ : state) {
+		glm::vec3 sum{0.f};
+		view.Each([&sum](eid, const Position* position, const Orientation*, const Scale* scale) {
+			sum += position->value * scale->value;
+		});
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	ClearEntities(state.range(0));
+}
+BENCHMARK(BM_CachedComponentView)->Arg(1000)->Arg(10000)->Arg(100000);
+
+// The render list shape: one required component with several optional ones.
+void BM_OptionalComponentView(benchmark::State& state) {
+	PopulateEntities(state.range(0));
+	CachedComponentView<Position, Optional<Orientation>, Optional<Scale>> view;
+	for (auto _ : state) {
+		glm::vec3 sum{0.f};
+		view.Each([&sum](eid, const Position* position, const Orientation* orientation, const Scale* scale) {
+			if (orientation && scale) {
+				sum += position->value * scale->value;
+			}
+		});
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	ClearEntities(state.range(0));
+}
+BENCHMARK(BM_OptionalComponentView)->Arg(1000)->Arg(10000)->Arg(100000);
+} // namespace
+} // namespace tec
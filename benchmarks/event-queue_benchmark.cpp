@@ -0,0 +1,140 @@
+/**
+ * Compares the lock-free EventQueue storage against the mutex guarded double queue it replaced,
+ * both for producer throughput under contention and for the time the consumer takes to drain,
+ * and emitting through EventSystem against the by-value EventBus.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+#include "event-bus.hpp"
+#include "event-queue.hpp"
+#include "event-system.hpp"
+
+namespace tec {
+namespace {
+struct BenchmarkEvent {
+	int value{0};
+};
+
+// The previous EventQueue storage: a std::queue per buffer, locked on every write and while draining.
+class MutexDoubleQueue {
+public:
+	void Push(Event<BenchmarkEvent>&& e) {
+		Buffer* buffer = this->write_buffer.load();
+		std::scoped_lock lock(buffer->mutex);
+		buffer->queue.emplace(std::move(e));
+	}
+
+	template <typename F> std::size_t ConsumeAll(F&& fn) {
+		this->read_buffer = this->write_buffer.exchange(this->read_buffer);
+		std::scoped_lock lock(this->read_buffer->mutex);
+		std::size_t count = 0;
+		while (!this->read_buffer->queue.empty()) {
+			Event<BenchmarkEvent> e = std::move(this->read_buffer->queue.front());
+			this->read_buffer->queue.pop();
+			fn(std::move(e));
+			++count;
+		}
+		return count;
+	}
+
+private:
+	struct Buffer {
+		std::queue<Event<BenchmarkEvent>> queue;
+		std::mutex mutex;
+	};
+	Buffer buffers[2];
+	Buffer* read_buffer{&buffers[0]};
+	std::atomic<Buffer*> write_buffer{&buffers[1]};
+};
+
+const auto shared_data = std::make_shared<BenchmarkEvent>();
+
+// Every thread produces, the first one also drains periodically like the simulation thread does.
+template <class Q> void BM_ProduceContended(benchmark::State& state) {
+	static Q* queue = nullptr;
+	if (state.thread_index() == 0) {
+		queue = new Q();
+	}
+	std::size_t produced = 0;
+	for (auto _ : state) {
+		queue->Push(Event<BenchmarkEvent>(produced, shared_data));
+		if (state.thread_index() == 0 && ++produced % 256 == 0) {
+			queue->ConsumeAll([](Event<BenchmarkEvent>&& e) { benchmark::DoNotOptimize(e.entity_id); });
+		}
+	}
+	state.SetItemsProcessed(state.iterations());
+	if (state.thread_index() == 0) {
+		delete queue;
+		queue = nullptr;
+	}
+}
+BENCHMARK_TEMPLATE(BM_ProduceContended, MutexDoubleQueue)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ProduceContended, MPSCQueue<Event<BenchmarkEvent>>)->ThreadRange(1, 8)->UseRealTime();
+
+// Time to drain a tick's worth of events.
+template <class Q> void BM_Drain(benchmark::State& state) {
+	Q queue;
+	for (auto _ : state) {
+		state.PauseTiming();
+		for (std::int64_t i = 0; i < state.range(0); ++i) {
+			queue.Push(Event<BenchmarkEvent>(i, shared_data));
+		}
+		state.ResumeTiming();
+		queue.ConsumeAll([](Event<BenchmarkEvent>&& e) { benchmark::DoNotOptimize(e.entity_id); });
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_Drain, MutexDoubleQueue)->Arg(100)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_Drain, MPSCQueue<Event<BenchmarkEvent>>)->Arg(100)->Arg(10000);
+
+class SystemReceiver : public EventQueue<BenchmarkEvent> {
+public:
+	~SystemReceiver() { EventSystem<BenchmarkEvent>::Get()->Unsubscribe(this); }
+	void On(const eid, std::shared_ptr<BenchmarkEvent> data) override { this->sum += data->value; }
+	int sum{0};
+};
+
+class BusReceiver : public BufferedEventQueue<BenchmarkEvent> {
+public:
+	void On(const eid, const BenchmarkEvent& data) override { this->sum += data.value; }
+	int sum{0};
+};
+
+// A burst of events, each built and emitted the way the mouse handler does, to a few subscribers.
+template <class Receiver, typename EmitFn> void EmitBurst(benchmark::State& state, EmitFn&& emit) {
+	std::vector<std::unique_ptr<Receiver>> receivers;
+	for (int i = 0; i < 4; ++i) {
+		receivers.push_back(std::make_unique<Receiver>());
+	}
+	for (auto _ : state) {
+		for (std::int64_t i = 0; i < state.range(0); ++i) {
+			emit(static_cast<int>(i));
+		}
+		for (auto& receiver : receivers) {
+			receiver->ProcessEventQueue();
+			benchmark::DoNotOptimize(receiver->sum);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_EventSystemEmit(benchmark::State& state) {
+	EmitBurst<SystemReceiver>(state, [](const int value) {
+		EventSystem<BenchmarkEvent>::Get()->Emit(std::make_shared<BenchmarkEvent>(BenchmarkEvent{value}));
+	});
+}
+BENCHMARK(BM_EventSystemEmit)->Arg(100)->Arg(5000);
+
+void BM_EventBusEmit(benchmark::State& state) {
+	EmitBurst<BusReceiver>(state, [](const int value) { EventBus<BenchmarkEvent>::Get().Emit(BenchmarkEvent{value}); });
+}
+BENCHMARK(BM_EventBusEmit)->Arg(100)->Arg(5000);
+} // namespace
+} // namespace tec
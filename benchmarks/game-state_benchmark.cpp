@@ -0,0 +1,135 @@
+/**
+ * Compares the map based GameState against the sorted structure-of-arrays FlatGameState
+ * for the operations done on every tick: copying, merging an update and serializing, and
+ * the cost of keeping a GameStateSnapshot of every tick.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "flat-game-state.hpp"
+#include "game-state-snapshot.hpp"
+#include "game-state.hpp"
+
+namespace tec {
+namespace {
+const eid BASE_ENTITY_ID = 10000;
+
+// Every entity gets a Position and Orientation, every other a Velocity.
+GameState MakeGameState(const std::int64_t count) {
+	GameState state;
+	for (eid entity_id = BASE_ENTITY_ID; entity_id < BASE_ENTITY_ID + count; ++entity_id) {
+		state.positions[entity_id] = Position(glm::vec3(static_cast<float>(entity_id)));
+		state.orientations[entity_id] = Orientation();
+		if (entity_id % 2 == 0) {
+			state.velocities[entity_id] = Velocity(glm::vec3(1.f), glm::vec3(0.f));
+		}
+	}
+	return state;
+}
+
+// An update moving every tenth entity.
+GameState MakeUpdate(const std::int64_t count) {
+	GameState update;
+	for (eid entity_id = BASE_ENTITY_ID; entity_id < BASE_ENTITY_ID + count; entity_id += 10) {
+		update.positions[entity_id] = Position(glm::vec3(1.f));
+	}
+	return update;
+}
+
+void BM_GameStateCopy(benchmark::State& state) {
+	const GameState source = MakeGameState(state.range(0));
+	for (auto _ : state) {
+		GameState copy = source;
+		benchmark::DoNotOptimize(copy);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GameStateCopy)->Arg(1000)->Arg(10000)->Arg(100000);
+
+void BM_FlatGameStateCopy(benchmark::State& state) {
+	const FlatGameState source = FlatGameState::From(MakeGameState(state.range(0)));
+	for (auto _ : state) {
+		FlatGameState copy = source;
+		benchmark::DoNotOptimize(copy);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FlatGameStateCopy)->Arg(1000)->Arg(10000)->Arg(100000);
+
+void BM_GameStateMerge(benchmark::State& state) {
+	const GameState source = MakeGameState(state.range(0));
+	const GameState update = MakeUpdate(state.range(0));
+	for (auto _ : state) {
+		state.PauseTiming();
+		GameState merged = source;
+		state.ResumeTiming();
+		for (const auto& [entity_id, position] : update.positions) {
+			merged.positions[entity_id] = position;
+		}
+		benchmark::DoNotOptimize(merged);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GameStateMerge)->Arg(1000)->Arg(10000)->Arg(100000);
+
+void BM_FlatGameStateMerge(benchmark::State& state) {
+	const FlatGameState source = FlatGameState::From(MakeGameState(state.range(0)));
+	const FlatGameState update = FlatGameState::From(MakeUpdate(state.range(0)));
+	for (auto _ : state) {
+		state.PauseTiming();
+		FlatGameState merged = source;
+		state.ResumeTiming();
+		merged.Merge(update);
+		benchmark::DoNotOptimize(merged);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FlatGameStateMerge)->Arg(1000)->Arg(10000)->Arg(100000);
+
+void BM_GameStateSerialize(benchmark::State& state) {
+	const GameState source = MakeGameState(state.range(0));
+	std::string out;
+	for (auto _ : state) {
+		proto::GameStateUpdate gsu;
+		gsu.set_command_id(1);
+		source.Out(&gsu);
+		gsu.SerializeToString(&out);
+		benchmark::DoNotOptimize(out);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GameStateSerialize)->Arg(1000)->Arg(10000)->Arg(100000);
+
+void BM_FlatGameStateSerialize(benchmark::State& state) {
+	const FlatGameState source = FlatGameState::From(MakeGameState(state.range(0)));
+	std::string out;
+	for (auto _ : state) {
+		proto::GameStateUpdate gsu;
+		gsu.set_command_id(1);
+		source.Out(&gsu);
+		gsu.SerializeToString(&out);
+		benchmark::DoNotOptimize(out);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FlatGameStateSerialize)->Arg(1000)->Arg(10000)->Arg(100000);
+
+// One tick of history when 1% of the entities moved, compare with BM_GameStateCopy.
+void BM_GameStateHistoryCapture(benchmark::State& state) {
+	GameState source = MakeGameState(state.range(0));
+	source.TrackChanges();
+	GameStateHistory history;
+	history.Capture(source);
+	eid moved = BASE_ENTITY_ID;
+	for (auto _ : state) {
+		for (std::int64_t i = 0; i < state.range(0) / 100; ++i) {
+			source.SetPosition(moved, Position(glm::vec3(1.f)));
+			moved = moved + 1 < BASE_ENTITY_ID + state.range(0) ? moved + 1 : BASE_ENTITY_ID;
+		}
+		benchmark::DoNotOptimize(history.Capture(source));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GameStateHistoryCapture)->Arg(1000)->Arg(10000)->Arg(100000);
+} // namespace
+} // namespace tec
@@ -0,0 +1,93 @@
+/**
+ * Measures the JobSystem's per-job scheduling overhead and how a ParallelFor scales with the
+ * number of workers, from 1 to 64. Worker counts past the machine's core count only show the
+ * cost of oversubscription.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "job-system.hpp"
+
+namespace tec {
+namespace {
+constexpr std::size_t ELEMENT_COUNT = 1 << 20;
+
+// Some floating point work per element, roughly an animation or interpolation step.
+void Work(std::vector<float>& values, const std::size_t begin, const std::size_t end) {
+	for (std::size_t i = begin; i < end; ++i) {
+		values[i] = std::sqrt(values[i] * 1.0001f + 0.5f) * std::sin(values[i]);
+	}
+}
+
+// Empty jobs added and waited on from the benchmark thread, which isn't a worker.
+void BM_RunEmptyJobs(benchmark::State& state) {
+	JobSystem jobs(static_cast<std::size_t>(state.range(0)));
+	constexpr int JOB_COUNT = 1024;
+	for (auto _ : state) {
+		JobGroup group;
+		for (int i = 0; i < JOB_COUNT; ++i) {
+			jobs.Run(group, []() {});
+		}
+		jobs.Wait(group);
+	}
+	state.SetItemsProcessed(state.iterations() * JOB_COUNT);
+}
+BENCHMARK(BM_RunEmptyJobs)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
+
+// Empty chunks, so all of the time is splitting, stealing and joining.
+void BM_ParallelForEmptyChunks(benchmark::State& state) {
+	JobSystem jobs(static_cast<std::size_t>(state.range(0)));
+	constexpr std::size_t CHUNK_COUNT = 1024;
+	for (auto _ : state) {
+		jobs.ParallelFor(0, CHUNK_COUNT, 1, [](std::size_t begin, std::size_t) { benchmark::DoNotOptimize(begin); });
+	}
+	state.SetItemsProcessed(state.iterations() * CHUNK_COUNT);
+}
+BENCHMARK(BM_ParallelForEmptyChunks)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
+
+void BM_SerialFor(benchmark::State& state) {
+	std::vector<float> values(ELEMENT_COUNT, 1.0f);
+	for (auto _ : state) {
+		Work(values, 0, values.size());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * ELEMENT_COUNT);
+}
+BENCHMARK(BM_SerialFor)->UseRealTime();
+
+void BM_ParallelFor(benchmark::State& state) {
+	JobSystem jobs(static_cast<std::size_t>(state.range(0)));
+	std::vector<float> values(ELEMENT_COUNT, 1.0f);
+	for (auto _ : state) {
+		jobs.ParallelFor(0, values.size(), 4096, [&values](std::size_t begin, std::size_t end) {
+			Work(values, begin, end);
+		});
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * ELEMENT_COUNT);
+}
+BENCHMARK(BM_ParallelFor)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
+
+// Uneven nested ranges, as when each entity of a batch splits its own work further.
+void BM_NestedParallelFor(benchmark::State& state) {
+	JobSystem jobs(static_cast<std::size_t>(state.range(0)));
+	constexpr std::size_t OUTER_COUNT = 64;
+	std::vector<float> values(ELEMENT_COUNT, 1.0f);
+	for (auto _ : state) {
+		jobs.ParallelFor(0, OUTER_COUNT, 1, [&](std::size_t outer, std::size_t) {
+			const std::size_t slice = ELEMENT_COUNT / OUTER_COUNT;
+			const std::size_t begin = outer * slice;
+			// every other slice does a quarter of the work
+			const std::size_t end = begin + (outer % 2 ? slice : slice / 4);
+			jobs.ParallelFor(begin, end, 1024, [&values](std::size_t b, std::size_t e) { Work(values, b, e); });
+		});
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK(BM_NestedParallelFor)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
+} // namespace
+} // namespace tec
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include <components.pb.h>
+
+#include "event-system.hpp"
+#include "events.hpp"
+#include "game-state.hpp"
+
+namespace tec {
+inline constexpr eid SCENE_FLOOR_ENTITY_ID = 10000;
+inline constexpr eid SCENE_BASE_ENTITY_ID = 10001; // The first of the falling bodies.
+inline constexpr std::int64_t SCENE_COLUMNS_PER_ROW = 32;
+
+/// Emit the EntityCreated of the floor or a falling body and put its transform in the state.
+inline void SpawnSceneBody(GameState& state, const eid entity_id, const glm::vec3& position, const bool dynamic) {
+	auto data = std::make_shared<EntityCreated>();
+	data->entity.set_id(entity_id);
+	proto::CollisionBody* body = data->entity.add_components()->mutable_collision_body();
+	if (!dynamic) {
+		body->set_mass(0.f);
+		body->mutable_box()->set_x(100.f);
+		body->mutable_box()->set_y(1.f);
+		body->mutable_box()->set_z(100.f);
+	}
+	else if (entity_id % 2 == 0) {
+		body->set_mass(1.f);
+		body->mutable_box()->set_x(0.5f);
+		body->mutable_box()->set_y(0.5f);
+		body->mutable_box()->set_z(0.5f);
+	}
+	else {
+		body->set_mass(1.f);
+		body->mutable_capsule()->set_radius(0.4f);
+		body->mutable_capsule()->set_height(0.8f);
+	}
+	EventSystem<EntityCreated>::Get()->Emit(data);
+	state.positions[entity_id] = Position(position);
+	state.orientations[entity_id] = Orientation();
+}
+
+/**
+* \brief A static floor with count boxes and capsules above it, to be dropped onto it.
+*
+* The bodies stand in columns on a 1.5 unit grid, each 1.5 units above the one below.
+*/
+inline GameState MakePileScene(const std::int64_t count) {
+	GameState state;
+	SpawnSceneBody(state, SCENE_FLOOR_ENTITY_ID, glm::vec3(0.f, -1.f, 0.f), false);
+	for (std::int64_t i = 0; i < count; ++i) {
+		const std::int64_t column = i % (SCENE_COLUMNS_PER_ROW * SCENE_COLUMNS_PER_ROW);
+		const glm::vec3 position(
+				static_cast<float>(column % SCENE_COLUMNS_PER_ROW) * 1.5f - 24.f,
+				static_cast<float>(i / (SCENE_COLUMNS_PER_ROW * SCENE_COLUMNS_PER_ROW)) * 1.5f + 1.f,
+				static_cast<float>(column / SCENE_COLUMNS_PER_ROW) * 1.5f - 24.f);
+		SpawnSceneBody(state, SCENE_BASE_ENTITY_ID + static_cast<eid>(i), position, true);
+	}
+	state.TrackChanges();
+	return state;
+}
+} // namespace tec
@@ -0,0 +1,91 @@
+/**
+ * Rolls a scene of boxes and capsules back to a snapshot and steps it forward again, the way
+ * the client replays its unacked commands when an ack comes in. The snapshot is taken half a
+ * second into the drop, with the lower bodies landing and piling, so the replayed steps are busy
+ * ones. The client only rolls back the entity it predicts, which is timed as well, with the rest
+ * of the pile held in place. Also measures taking a snapshot on its own, which the client does for
+ * every command.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "game-state.hpp"
+#include "physics-bench-scene.hpp"
+#include "physics-system.hpp"
+#include "tick-arena.hpp"
+
+namespace tec {
+namespace {
+const double STEP = 1.0 / 60.0;
+const int WARMUP_STEPS = 30;
+const state_id_t SNAPSHOT_ID = 1;
+
+// Puts range(0) bodies in the world and drops them for WARMUP_STEPS.
+void Warmup(PhysicsSystem& physics, const GameState& scene) {
+	physics.SetSubstepping(0);
+	for (int i = 0; i < WARMUP_STEPS; ++i) {
+		TickArena::BeginTick();
+		physics.Update(STEP, scene);
+	}
+}
+
+void BM_PhysicsSnapshotSave(benchmark::State& state) {
+	PhysicsSystem physics;
+	const GameState scene = MakePileScene(state.range(0));
+	Warmup(physics, scene);
+	state_id_t id = 0;
+	for (auto _ : state) {
+		// goes around the ring buffer like the client does, reusing the replaced snapshots
+		physics.SaveSnapshot(id++);
+	}
+	state.counters["bodies_per_second"] = benchmark::Counter(
+			static_cast<double>(state.iterations() * state.range(0)), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_PhysicsSnapshotSave)->Arg(1000)->Arg(4000)->ArgName("bodies")->Unit(benchmark::kMicrosecond);
+
+// range(0) bodies, restored and stepped range(1) times per iteration.
+void BM_PhysicsRollback(benchmark::State& state) {
+	PhysicsSystem physics;
+	const GameState scene = MakePileScene(state.range(0));
+	Warmup(physics, scene);
+	physics.SaveSnapshot(SNAPSHOT_ID);
+	const int steps = static_cast<int>(state.range(1));
+	for (auto _ : state) {
+		TickArena::BeginTick();
+		physics.RestoreSnapshot(SNAPSHOT_ID);
+		benchmark::DoNotOptimize(physics.Resimulate(steps, STEP).size());
+	}
+	state.counters["steps_per_second"] =
+			benchmark::Counter(static_cast<double>(state.iterations() * steps), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_PhysicsRollback)
+		->ArgsProduct({{1000, 4000}, {1, 2, 4, 8, 16}})
+		->ArgNames({"bodies", "steps"})
+		->Unit(benchmark::kMillisecond);
+
+// Like BM_PhysicsRollback, but only one body is rolled back and replayed the way the client does
+// with the entity it predicts. It's one near the bottom of a pile, so it pushes the bodies around it.
+void BM_PhysicsPartialRollback(benchmark::State& state) {
+	PhysicsSystem physics;
+	const GameState scene = MakePileScene(state.range(0));
+	Warmup(physics, scene);
+	physics.SaveSnapshot(SNAPSHOT_ID);
+	const std::vector<eid> predicted{SCENE_BASE_ENTITY_ID};
+	const int steps = static_cast<int>(state.range(1));
+	for (auto _ : state) {
+		TickArena::BeginTick();
+		physics.RestoreSnapshot(SNAPSHOT_ID, predicted);
+		benchmark::DoNotOptimize(physics.Resimulate(steps, STEP, predicted).size());
+	}
+	state.counters["steps_per_second"] =
+			benchmark::Counter(static_cast<double>(state.iterations() * steps), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_PhysicsPartialRollback)
+		->ArgsProduct({{1000, 4000}, {1, 2, 4, 8, 16}})
+		->ArgNames({"bodies", "steps"})
+		->Unit(benchmark::kMillisecond);
+} // namespace
+} // namespace tec
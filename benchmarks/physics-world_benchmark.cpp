@@ -0,0 +1,46 @@
+/**
+ * Steps a scene of boxes and capsules falling in columns onto a static floor, in the single
+ * threaded world and in the multithreaded one on an increasing number of threads. Every run
+ * simulates the same four seconds at 60Hz, so the time per iteration is the average step time
+ * from the first drop until most piles have settled. Thread counts above the cores available
+ * to the job system are clamped.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include "game-state.hpp"
+#include "physics-bench-scene.hpp"
+#include "physics-system.hpp"
+#include "tick-arena.hpp"
+
+namespace tec {
+namespace {
+const double STEP = 1.0 / 60.0;
+const std::int64_t STEPS = 240;
+
+// range(0) bodies, range(1) threads with 0 for the single threaded world.
+void BM_PhysicsStep(benchmark::State& state) {
+	PhysicsThreading threading;
+	threading.thread_count = static_cast<std::size_t>(state.range(1));
+	PhysicsSystem physics(threading);
+	physics.SetSubstepping(0);
+	const GameState scene = MakePileScene(state.range(0));
+	// the first update puts the bodies in the world
+	physics.Update(STEP, scene);
+	for (auto _ : state) {
+		TickArena::BeginTick();
+		benchmark::DoNotOptimize(physics.Update(STEP, scene).size());
+	}
+	state.counters["bodies_per_second"] = benchmark::Counter(
+			static_cast<double>(state.iterations() * state.range(0)), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_PhysicsStep)
+		->ArgsProduct({{1000, 4000}, {0, 1, 2, 4, 8}})
+		->ArgNames({"bodies", "threads"})
+		->Iterations(STEPS)
+		->UseRealTime()
+		->Unit(benchmark::kMillisecond);
+} // namespace
+} // namespace tec
@@ -0,0 +1,121 @@
+/**
+ * Compares building and parsing a GameStateUpdate on the heap against a reused ProtoArena, at
+ * entity counts from a small session up to a busy server. Reports heap allocations per
+ * iteration (counted by replacing the global operator new) and the time per entity in seconds.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include <game_state.pb.h>
+
+#include "game-state.hpp"
+#include "proto-arena.hpp"
+
+namespace {
+std::atomic<std::uint64_t> heap_allocations{0};
+} // namespace
+
+void* operator new(const std::size_t size) {
+	heap_allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+namespace tec {
+namespace {
+const eid BASE_ENTITY_ID = 10000;
+
+// Every entity gets a Position and Orientation, every other a Velocity, like a delta update.
+GameState MakeGameState(const std::int64_t count) {
+	GameState state;
+	for (eid entity_id = BASE_ENTITY_ID; entity_id < BASE_ENTITY_ID + count; ++entity_id) {
+		state.positions[entity_id] = Position(glm::vec3(static_cast<float>(entity_id)));
+		state.orientations[entity_id] = Orientation();
+		if (entity_id % 2 == 0) {
+			state.velocities[entity_id] = Velocity(glm::vec3(1.f), glm::vec3(0.f));
+		}
+	}
+	return state;
+}
+
+void ReportPerEntity(benchmark::State& state, const std::uint64_t allocations) {
+	state.counters["allocs"] = benchmark::Counter(
+			static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+	state.counters["time_per_entity"] = benchmark::Counter(
+			static_cast<double>(state.iterations() * state.range(0)),
+			benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+void BM_BuildOnHeap(benchmark::State& state) {
+	const GameState source = MakeGameState(state.range(0));
+	std::string bytes;
+	const std::uint64_t allocations_before = heap_allocations.load();
+	for (auto _ : state) {
+		proto::GameStateUpdate gsu;
+		source.Out(&gsu);
+		gsu.SerializeToString(&bytes);
+		benchmark::DoNotOptimize(bytes.data());
+	}
+	ReportPerEntity(state, heap_allocations.load() - allocations_before);
+}
+BENCHMARK(BM_BuildOnHeap)->Arg(64)->Arg(512)->Arg(4096)->Unit(benchmark::kMicrosecond);
+
+void BM_BuildOnArena(benchmark::State& state) {
+	const GameState source = MakeGameState(state.range(0));
+	std::string bytes;
+	ProtoArena arena;
+	const std::uint64_t allocations_before = heap_allocations.load();
+	for (auto _ : state) {
+		auto* gsu = google::protobuf::Arena::CreateMessage<proto::GameStateUpdate>(&arena.Get());
+		source.Out(gsu);
+		gsu->SerializeToString(&bytes);
+		benchmark::DoNotOptimize(bytes.data());
+		arena.Reset();
+	}
+	ReportPerEntity(state, heap_allocations.load() - allocations_before);
+}
+BENCHMARK(BM_BuildOnArena)->Arg(64)->Arg(512)->Arg(4096)->Unit(benchmark::kMicrosecond);
+
+void BM_ParseOnHeap(benchmark::State& state) {
+	proto::GameStateUpdate source;
+	MakeGameState(state.range(0)).Out(&source);
+	const std::string bytes = source.SerializeAsString();
+	const std::uint64_t allocations_before = heap_allocations.load();
+	for (auto _ : state) {
+		proto::GameStateUpdate gsu;
+		gsu.ParseFromString(bytes);
+		benchmark::DoNotOptimize(gsu.entity_size());
+	}
+	ReportPerEntity(state, heap_allocations.load() - allocations_before);
+}
+BENCHMARK(BM_ParseOnHeap)->Arg(64)->Arg(512)->Arg(4096)->Unit(benchmark::kMicrosecond);
+
+void BM_ParseOnArena(benchmark::State& state) {
+	proto::GameStateUpdate source;
+	MakeGameState(state.range(0)).Out(&source);
+	const std::string bytes = source.SerializeAsString();
+	ProtoArena arena;
+	const std::uint64_t allocations_before = heap_allocations.load();
+	for (auto _ : state) {
+		auto* gsu = google::protobuf::Arena::CreateMessage<proto::GameStateUpdate>(&arena.Get());
+		gsu->ParseFromString(bytes);
+		benchmark::DoNotOptimize(gsu->entity_size());
+		arena.Reset();
+	}
+	ReportPerEntity(state, heap_allocations.load() - allocations_before);
+}
+BENCHMARK(BM_ParseOnArena)->Arg(64)->Arg(512)->Arg(4096)->Unit(benchmark::kMicrosecond);
+} // namespace
+} // namespace tec
@@ -7,7 +7,7 @@
 
 namespace tec {
 
-ClientGameStateQueue::ClientGameStateQueue(ServerStats& s) : stats(s) {}
+ClientGameStateQueue::ClientGameStateQueue(ServerStats& s) : stats(s) { this->interpolated_state.TrackChanges(); }
 
 void ClientGameStateQueue::Interpolate(const double delta_time) {
 	std::lock_guard<std::mutex> lg(this->server_state_mutex);
@@ -33,15 +33,15 @@ void ClientGameStateQueue::Interpolate(const double delta_time) {
 		// also initialize the interpolated state with it
 		for (auto position : to_state.positions) {
 			this->base_state.positions[position.first] = position.second;
-			this->interpolated_state.positions[position.first] = position.second;
+			this->interpolated_state.SetPosition(position.first, position.second);
 		}
 		for (auto velocity : to_state.velocities) {
 			this->base_state.velocities[velocity.first] = velocity.second;
-			this->interpolated_state.velocities[velocity.first] = velocity.second;
+			this->interpolated_state.SetVelocity(velocity.first, velocity.second);
 		}
 		for (auto orientation : to_state.orientations) {
 			this->base_state.orientations[orientation.first] = orientation.second;
-			this->interpolated_state.orientations[orientation.first] = orientation.second;
+			this->interpolated_state.SetOrientation(orientation.first, orientation.second);
 		}
 		// the client controlled entities can use the predicted state
 		if (this->client_id != 0) {
@@ -49,8 +49,8 @@ void ClientGameStateQueue::Interpolate(const double delta_time) {
 			if (itr != this->predictions.end()) {
 				this->base_state.positions[this->client_id] = itr->second.positions[this->client_id];
 				this->base_state.velocities[this->client_id] = itr->second.velocities[this->client_id];
-				this->interpolated_state.positions[this->client_id] = itr->second.positions[this->client_id];
-				this->interpolated_state.velocities[this->client_id] = itr->second.velocities[this->client_id];
+				this->interpolated_state.SetPosition(this->client_id, itr->second.positions[this->client_id]);
+				this->interpolated_state.SetVelocity(this->client_id, itr->second.velocities[this->client_id]);
 			}
 		}
 
@@ -75,35 +75,39 @@ void ClientGameStateQueue::Interpolate(const double delta_time) {
 			for (auto position : to_state.positions) {
 				auto base_position_iter = this->base_state.positions.find(position.first);
 				if (base_position_iter != this->base_state.positions.end()) {
-					this->interpolated_state.positions[position.first].value =
-							glm::lerp(base_position_iter->second.value, position.second.value, lerp_percent);
+					Position interpolated = this->interpolated_state.positions[position.first];
+					interpolated.value = glm::lerp(base_position_iter->second.value, position.second.value, lerp_percent);
+					this->interpolated_state.SetPosition(position.first, interpolated);
 				}
 				else {
-					this->interpolated_state.positions[position.first] = position.second;
+					this->interpolated_state.SetPosition(position.first, position.second);
 				}
 			}
 			for (auto velocity : to_state.velocities) {
 				auto base_velocity_iter = this->base_state.velocities.find(velocity.first);
+				Velocity interpolated = this->interpolated_state.velocities[velocity.first];
 				if (base_velocity_iter != this->base_state.velocities.end()) {
-					this->interpolated_state.velocities[velocity.first].linear =
-							glm::lerp(base_velocity_iter->second.linear, velocity.second.linear, lerp_percent);
-					this->interpolated_state.velocities[velocity.first].angular =
+					interpolated.linear = glm::lerp(base_velocity_iter->second.linear, velocity.second.linear, lerp_percent);
+					interpolated.angular =
 							glm::lerp(base_velocity_iter->second.angular, velocity.second.angular, lerp_percent);
 				}
 				else {
-					this->interpolated_state.velocities[velocity.first].linear = velocity.second.linear;
-					this->interpolated_state.velocities[velocity.first].angular = velocity.second.angular;
+					interpolated.linear = velocity.second.linear;
+					interpolated.angular = velocity.second.angular;
 				}
+				this->interpolated_state.SetVelocity(velocity.first, interpolated);
 			}
 			// Quaternions, we use a slerp here instead
 			for (auto orientation : to_state.orientations) {
 				auto base_orientation_iter = this->base_state.orientations.find(orientation.first);
 				if (base_orientation_iter != this->base_state.orientations.end()) {
-					this->interpolated_state.orientations[orientation.first].value =
+					Orientation interpolated = this->interpolated_state.orientations[orientation.first];
+					interpolated.value =
 							glm::slerp(base_orientation_iter->second.value, orientation.second.value, lerp_percent);
+					this->interpolated_state.SetOrientation(orientation.first, interpolated);
 				}
 				else {
-					this->interpolated_state.orientations[orientation.first] = orientation.second;
+					this->interpolated_state.SetOrientation(orientation.first, orientation.second);
 				}
 			}
 		}
@@ -165,9 +169,22 @@ void ClientGameStateQueue::CheckPredictionResult(GameState& new_state) {
 		}
 		++itr;
 	}
-	// debugging stats, also used by reconciliation
+	// debugging stats
 	stats.client_position = position_diff;
 	stats.client_velocity = velocity_diff;
+
+	// the server repeats its last ack until it gets a newer command, only reconcile against each once
+	if (new_state.command_id > this->last_reconciled_id) {
+		this->last_reconciled_id = new_state.command_id;
+		ClientReconciliation& reconcile = this->reconciliation.emplace();
+		reconcile.command_id = new_state.command_id;
+		if (auto position = new_state.positions.find(this->client_id); position != new_state.positions.end()) {
+			reconcile.server_state.positions[this->client_id] = position->second;
+		}
+		if (auto velocity = new_state.velocities.find(this->client_id); velocity != new_state.velocities.end()) {
+			reconcile.server_state.velocities[this->client_id] = velocity->second;
+		}
+	}
 }
 
 /** \brief Explicitly update the current prediction
@@ -178,9 +195,8 @@ void ClientGameStateQueue::UpdatePredictions(GameState& new_state) {
 	}
 	this->stats.current_command_id = this->command_id;
 	GameState predict_state;
-	// basic reconciliation, attempt to resolve errors by nudging current predictions
-	predict_state.positions[this->client_id].value =
-			new_state.positions[this->client_id].value + stats.client_position * 0.125f;
+	// errors are resolved by replaying the unacked commands, see Simulation::Replay()
+	predict_state.positions[this->client_id] = new_state.positions[this->client_id];
 	predict_state.velocities[this->client_id] = new_state.velocities[this->client_id];
 	predict_state.orientations[this->client_id] = new_state.orientations[this->client_id];
 	this->predictions.emplace(std::make_pair(this->command_id, predict_state));
@@ -196,7 +212,7 @@ void ClientGameStateQueue::On(eid, std::shared_ptr<EntityCreated> data) {
 		{
 			Position pos;
 			pos.In(comp);
-			this->interpolated_state.positions[entity_id] = pos;
+			this->interpolated_state.SetPosition(entity_id, pos);
 			this->base_state.positions[entity_id] = pos;
 			break;
 		}
@@ -204,7 +220,7 @@ void ClientGameStateQueue::On(eid, std::shared_ptr<EntityCreated> data) {
 		{
 			Orientation orientation;
 			orientation.In(comp);
-			this->interpolated_state.orientations[entity_id] = orientation;
+			this->interpolated_state.SetOrientation(entity_id, orientation);
 			this->base_state.orientations[entity_id] = orientation;
 			break;
 		}
@@ -212,7 +228,7 @@ void ClientGameStateQueue::On(eid, std::shared_ptr<EntityCreated> data) {
 		{
 			Velocity vel;
 			vel.In(comp);
-			this->interpolated_state.velocities[entity_id] = vel;
+			this->interpolated_state.SetVelocity(entity_id, vel);
 			this->base_state.velocities[entity_id] = vel;
 			break;
 		}
@@ -222,12 +238,8 @@ void ClientGameStateQueue::On(eid, std::shared_ptr<EntityCreated> data) {
 }
 
 void ClientGameStateQueue::On(eid entity_id, std::shared_ptr<EntityDestroyed> data) {
-	this->interpolated_state.positions.erase(entity_id);
-	this->base_state.positions.erase(entity_id);
-	this->interpolated_state.orientations.erase(entity_id);
-	this->base_state.orientations.erase(entity_id);
-	this->interpolated_state.velocities.erase(entity_id);
-	this->base_state.velocities.erase(entity_id);
+	this->interpolated_state.RemoveEntity(entity_id);
+	this->base_state.RemoveEntity(entity_id);
 }
 
 } // end namespace tec
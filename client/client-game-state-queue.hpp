@@ -3,7 +3,9 @@
 #include <iostream>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <queue>
+#include <utility>
 
 #include "event-queue.hpp"
 #include "event-system.hpp"
@@ -12,6 +14,12 @@
 #include "tec-types.hpp"
 
 namespace tec {
+/// Where the server has the client's entity as of the last command it acked.
+struct ClientReconciliation {
+	state_id_t command_id{0};
+	GameState server_state; // Only the client's entity's position and velocity.
+};
+
 class ClientGameStateQueue :
 		public EventQueue<EntityCreated>,
 		public EventQueue<EntityDestroyed>,
@@ -33,6 +41,9 @@ public:
 
 	void SetCommandID(state_id_t _command_id) { this->command_id = _command_id; }
 
+	/// The server's state for the newest acked command, once per command, to replay the commands after it from.
+	std::optional<ClientReconciliation> TakeReconciliation() { return std::exchange(this->reconciliation, std::nullopt); }
+
 	virtual void On(eid, std::shared_ptr<EntityCreated> data) override;
 	virtual void On(eid, std::shared_ptr<EntityDestroyed> data) override;
 	virtual void On(eid, std::shared_ptr<NewGameStateEvent> data) override;
@@ -63,6 +74,8 @@ private:
 	double interpolation_accumulator{0.0};
 	eid client_id{0};
 	std::map<state_id_t, GameState> predictions;
+	std::optional<ClientReconciliation> reconciliation;
+	state_id_t last_reconciled_id{0};
 };
 
 } // end namespace tec
@@ -4,6 +4,7 @@
 #include <devices/tda.hpp>
 
 #include "components/lua-script.hpp"
+#include "components/transforms.hpp"
 #include "controllers/fps-controller.hpp"
 #include "event-system.hpp"
 #include "events.hpp"
@@ -14,6 +15,7 @@
 #include "graphics/view.hpp"
 #include "gui/console.hpp"
 #include "net-message.hpp"
+#include "tick-arena.hpp"
 #include "resources/pixel-buffer.hpp"
 
 constexpr double COMMAND_RATE = 1.0 / 30.0;
@@ -33,7 +35,7 @@ void CreateEngineEntities() { CreateManipulatorEntity(); }
 Game::Game(OS& _os, std::string config_file_name) :
 		stats(), os(_os), game_state_queue(this->stats), server_connection(this->stats),
 		ps(this->simulation.GetPhysicsSystem()), vcs(this->simulation.GetVComputerSystem()),
-		sound_thread([this]() { ss.Update(); }) {
+		systems(2), sound_thread([this]() { ss.Update(); }) {
 	this->config_script = this->lua_sys.LoadFile(Path::assets / config_file_name);
 	this->server_connection.RegisterMessageHandler(MessageType::CLIENT_ID, [this](networking::MessageIn&) {
 		auto client_id = server_connection.GetClientID();
@@ -50,10 +52,12 @@ Game::Game(OS& _os, std::string config_file_name) :
 	asio_thread = new std::thread([this]() { server_connection.StartDispatch(); });
 
 	CreateEngineEntities();
+	AddSystems();
 
 	{
 		auto& lua_state = this->lua_sys.GetGlobalState();
 		lua_state["placement_manipulator"] = &this->placement;
+		lua_state["physics"] = &this->ps;
 	}
 }
 
@@ -130,44 +134,93 @@ float Game::GetElapsedTime() {
 	return static_cast<float>(elapsed_time);
 }
 
+void Game::AddSystems() {
+	// In the order they used to run in, which is kept wherever they share something.
+	this->state_queue_system =
+			this->systems.Add("state_queue", SystemAccess().Writes<ClientGameStateQueue>(), [this](double delta) {
+				game_state_queue.ProcessEventQueue();
+				game_state_queue.Interpolate(delta);
+			});
+	this->voxel_system = this->systems.Add(
+			"voxels", SystemAccess().Writes<VoxelVolume, MeshFile>(), [this](double delta) { vox_sys.Update(delta); });
+	this->simulate_system = this->systems.Add(
+			"simulate",
+			SystemAccess().Writes<ClientGameStateQueue, ServerConnection, Position, Orientation, Computer>(),
+			[this](double delta) {
+				auto client_state = simulation.Simulate(delta, game_state_queue.GetInterpolatedState());
+				// roll back to where the server has us and replay what it hasn't seen yet
+				if (auto reconciliation = game_state_queue.TakeReconciliation()) {
+					std::erase_if(this->pending_commands, [&reconciliation](const proto::ClientCommands& sent) {
+						return sent.commandid() <= reconciliation->command_id;
+					});
+					simulation.Replay(
+							reconciliation->command_id,
+							reconciliation->server_state,
+							this->pending_commands,
+							COMMAND_RATE,
+							client_state);
+				}
+				game_state_queue.UpdatePredictions(client_state);
+
+				while (delta_accumulator >= COMMAND_RATE) {
+					if (this->player_camera) {
+						networking::MessageOut update_message(MessageType::CLIENT_COMMAND);
+						proto::ClientCommands client_commands = this->player_camera->GetClientCommands();
+						client_commands.set_commandid(command_id++);
+						client_commands.set_laststateid(server_connection.GetLastRecvStateID());
+						client_commands.SerializeToZeroCopyStream(&update_message);
+						server_connection.Send(std::move(update_message));
+						game_state_queue.SetCommandID(command_id);
+						// the world as this command left it, the server's ack of it is replayed from here
+						this->ps.SaveSnapshot(client_commands.commandid());
+						this->pending_commands.push_back(std::move(client_commands));
+						// older ones have no snapshot left to replay from
+						if (this->pending_commands.size() > PhysicsSystem::SNAPSHOT_CAPACITY) {
+							this->pending_commands.erase(this->pending_commands.begin());
+						}
+					}
+
+					delta_accumulator -= COMMAND_RATE;
+				}
+			});
+	// OpenGL calls have to stay on the thread owning the context
+	this->vcomputer_system = this->systems.Add(
+			"vcomputer_textures",
+			SystemAccess().Reads<Computer, Renderable>().Writes<TextureObject, Material>().OnCallerThread(),
+			[](double) { UpdateVComputerScreenTextures(); });
+	this->sound_system =
+			this->systems.Add("sound", SystemAccess().Writes<SoundSystem>(), [this](double delta) { ss.SetDelta(delta); });
+	this->render_system = this->systems.Add(
+			"render",
+			SystemAccess()
+					.Reads<Position, Orientation, MeshFile, TextureObject, Material>()
+					.Writes<RenderSystem, Renderable>()
+					.OnCallerThread(),
+			[this](double delta) { rs.Update(delta); });
+	// scripts can touch anything
+	this->lua_system = this->systems.Add(
+			"lua", SystemAccess().Exclusive().OnCallerThread(), [this](double delta) { lua_sys.Update(delta); });
+}
+
 void Game::Update(const double delta) {
+	TickArena::BeginTick();
 	this->ProcessEvents();
 	// Elapsed time spend outside game loop
 	tfm.outside_game_time = GetElapsedTime();
 	delta_accumulator += delta;
-	game_state_queue.ProcessEventQueue();
-	game_state_queue.Interpolate(delta);
-	vox_sys.Update(delta);
-
-	auto client_state = simulation.Simulate(delta, game_state_queue.GetInterpolatedState());
-	game_state_queue.UpdatePredictions(client_state);
-
-	while (delta_accumulator >= COMMAND_RATE) {
-		if (this->player_camera) {
-			networking::MessageOut update_message(MessageType::CLIENT_COMMAND);
-			proto::ClientCommands client_commands = this->player_camera->GetClientCommands();
-			client_commands.set_commandid(command_id++);
-			client_commands.set_laststateid(server_connection.GetLastRecvStateID());
-			client_commands.SerializeToZeroCopyStream(&update_message);
-			server_connection.Send(std::move(update_message));
-			game_state_queue.SetCommandID(command_id);
-		}
-
-		delta_accumulator -= COMMAND_RATE;
-	}
-	tfm.state_queue_time = GetElapsedTime();
-
-	UpdateVComputerScreenTextures();
-	tfm.vcomputer_time = GetElapsedTime();
-
-	ss.SetDelta(delta);
-	tfm.sound_system_time = GetElapsedTime();
 
-	rs.Update(delta);
-	tfm.render_system_time = GetElapsedTime();
-
-	lua_sys.Update(delta);
-	tfm.lua_system_time = GetElapsedTime();
+	this->systems.Run(delta);
+	GetElapsedTime();
+	// systems may overlap, so these add up to more than the time Run() took
+	const auto& timeline = this->systems.GetTimeline();
+	const auto seconds = [&timeline](const std::size_t system) {
+		return std::chrono::duration<float>(timeline[system].Duration()).count();
+	};
+	tfm.state_queue_time = seconds(state_queue_system) + seconds(voxel_system) + seconds(simulate_system);
+	tfm.vcomputer_time = seconds(vcomputer_system);
+	tfm.sound_system_time = seconds(sound_system);
+	tfm.render_system_time = seconds(render_system);
+	tfm.lua_system_time = seconds(lua_system);
 
 	// Frames per second
 	//
@@ -189,20 +242,26 @@ void Game::Update(const double delta) {
 			os.EnableMouseLock(); // TODO: create event to change to mouse look
 			mouse_x = static_cast<double>(window_width) / 2.0;
 			mouse_y = static_cast<double>(window_height) / 2.0;
-			const auto intersection = ps.GetLastRayPos();
 			const auto player_position = ps.GetPosition(player_entity_id);
-			placement.SetRayIntersectionPoint(player_position.value, intersection);
+			placement.SetRayIntersectionPoint(player_position.value, this->pick.point);
 		}
 		else {
 			os.DisableMouseLock(); // TODO: create event to change from mouse look
 			OS::GetMousePosition(&mouse_x, &mouse_y);
 		}
-		this->active_entity = ps.RayCastMousePick(
+		const PhysicsQueryHit hit = ps.RayCastMousePick(
 				this->server_connection.GetClientID(),
 				mouse_x,
 				mouse_y,
 				static_cast<float>(window_width),
 				static_cast<float>(window_height));
+		this->active_entity = hit.entity_id;
+		if (hit.hit) {
+			this->pick = hit;
+		}
+		else {
+			this->pick.entity_id = 0;
+		}
 	}
 	tfm.other_time = GetElapsedTime();
 	// clang-format off
@@ -218,6 +277,7 @@ void Game::Update(const double delta) {
 
 void Game::ProcessEvents() {
 	EventQueue<KeyboardEvent>::ProcessEventQueue();
+	EventQueue<MouseBtnEvent>::ProcessEventQueue();
 	EventQueue<MouseClickEvent>::ProcessEventQueue();
 }
 
@@ -227,6 +287,17 @@ void Game::On(eid, std::shared_ptr<KeyboardEvent> data) {
 	}
 }
 
+void Game::On(eid, std::shared_ptr<MouseBtnEvent> data) {
+	// clicks go to the entity the mouse points at
+	if (data->action == MouseBtnEvent::DOWN && this->pick.entity_id) {
+		std::shared_ptr<MouseClickEvent> mce_event = std::make_shared<MouseClickEvent>();
+		mce_event->button = data->button;
+		mce_event->ray_distance = this->pick.distance;
+		mce_event->ray_hit_point_world = this->pick.point;
+		EventSystem<MouseClickEvent>::Get()->Emit(this->pick.entity_id, mce_event);
+	}
+}
+
 void Game::On(eid, std::shared_ptr<MouseClickEvent> data) {
 	if (data->button == MouseBtnEvent::LEFT) {
 		this->placement.PlaceEntityInWorld(data->ray_hit_point_world);
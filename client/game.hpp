@@ -5,6 +5,7 @@
 #include <sstream>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include <vcomputer.hpp>
 
@@ -17,6 +18,7 @@
 #include "server-connection.hpp"
 #include "simulation.hpp"
 #include "sound-system.hpp"
+#include "system-scheduler.hpp"
 #include "time-frame-metrics.hpp"
 #include "vcomputer-system.hpp"
 #include "voxel-volume.hpp"
@@ -26,13 +28,17 @@
 namespace tec {
 struct FPSController;
 struct KeyboardEvent;
+struct MouseBtnEvent;
 class Console;
 
 using networking::ServerConnection;
 
 enum ENGINE_ENTITIES { MANIPULATOR = 1 };
 
-class Game : public EventQueue<KeyboardEvent>, public EventQueue<MouseClickEvent> {
+class Game :
+		public EventQueue<KeyboardEvent>,
+		public EventQueue<MouseBtnEvent>,
+		public EventQueue<MouseClickEvent> {
 public:
 	Game(OS& _os, std::string config_file_name = "scripts/config.lua");
 
@@ -48,6 +54,9 @@ public:
 
 	LuaSystem* GetLuaSystem() { return &this->lua_sys; }
 
+	/// When each system ran during the last Update().
+	const std::vector<SystemRun>& GetSystemTimeline() const { return this->systems.GetTimeline(); }
+
 	std::shared_ptr<LuaScript> config_script;
 
 	// Frames per second
@@ -63,7 +72,10 @@ private:
 
 	void ProcessEvents();
 
+	void AddSystems();
+
 	void On(eid, std::shared_ptr<KeyboardEvent> data) override;
+	void On(eid, std::shared_ptr<MouseBtnEvent> data) override;
 	void On(eid, std::shared_ptr<MouseClickEvent> data) override;
 
 	// Frames per second
@@ -85,10 +97,22 @@ private:
 	SoundSystem ss;
 	LuaSystem lua_sys;
 	VoxelSystem vox_sys;
+	SystemScheduler systems;
+
+	// Timeline indices of the systems, for the TimeFrameMetrics.
+	std::size_t state_queue_system{0};
+	std::size_t voxel_system{0};
+	std::size_t simulate_system{0};
+	std::size_t vcomputer_system{0};
+	std::size_t sound_system{0};
+	std::size_t render_system{0};
+	std::size_t lua_system{0};
 
 	double delta_accumulator = 0.0; // Accumulated deltas since the last update was sent.
 	state_id_t command_id = 0;
+	std::vector<proto::ClientCommands> pending_commands; // Sent but not acked yet, oldest first.
 	eid active_entity{0};
+	PhysicsQueryHit pick; // Where the mouse points, the point is kept while it points at nothing.
 	eid player_entity_id{0};
 	std::shared_ptr<tec::FPSController> player_camera{nullptr};
 
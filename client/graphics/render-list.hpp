@@ -5,6 +5,7 @@
 #include <utility>
 
 #include "animation.hpp"
+#include "component-view.hpp"
 #include "entity.hpp"
 #include "render-item.hpp"
 #include "renderable.hpp"
@@ -30,14 +31,28 @@ public:
 			this->default_shader = ShaderMap::Get(DEFAULT_SHADER_NAME);
 		}
 
-		// Loop through each renderable and update its model matrix.
-		for (auto& [entity_id, renderable] : RenderableMap::Instances()) {
+		// Model transforms are only recomputed for render items that were just (re)built, or whose
+		// entity had a transform component written since the last update (see below).
+		const bool transforms_known = RenderableMap::Changes().IsValid(this->renderable_cursor)
+									  && Multiton<eid, Position*>::Changes().IsValid(this->position_cursor)
+									  && Multiton<eid, Orientation*>::Changes().IsValid(this->orientation_cursor)
+									  && Multiton<eid, Scale*>::Changes().IsValid(this->scale_cursor);
+
+		// Loop through each renderable and update its render item.
+		this->renderable_view.Each([this, delta, transforms_known](
+				const eid entity_id,
+				Renderable* renderable,
+				const Position* _position,
+				const Orientation* _orientation,
+				const Scale* _scale,
+				Animation* _animation) {
 			if (renderable->hidden) {
-				continue;
+				return;
 			}
 
 			auto& mesh = renderable->mesh;
 			auto& ri = renderable->render_item;
+			bool rebuilt = false;
 			if (!mesh && ri) {
 				renderable->render_item.reset();
 				ri.reset();
@@ -67,6 +82,7 @@ public:
 						ri->vertex_groups.push_back(*buffer->GetVertexGroup(i));
 					}
 					renderable->render_item = ri;
+					rebuilt = true;
 				}
 				else {
 					_log->warn("[RenderSystem] empty mesh on Renderable [{}]", entity_id);
@@ -85,26 +101,15 @@ public:
 						ri->vertex_groups.push_back(*ri->vbo->GetVertexGroup(i));
 					}
 				}
-				auto [_position, _orientation, _scale, _animation] =
-						Entity(entity_id).GetList<Position, Orientation, Scale, Animation>();
-				ri->model_position = renderable->local_translation;
-				if (_position) {
-					ri->model_position += _position->value;
-				}
-				ri->model_quat = renderable->local_orientation.value;
-				if (_orientation) {
-					ri->model_quat *= _orientation->value;
-				}
-				ri->model_scale = glm::vec3{1.0};
-				if (_scale) {
-					ri->model_scale = _scale->value;
+				if (rebuilt || !transforms_known) {
+					SetModelTransform(*ri, *renderable, _position, _orientation, _scale);
 				}
 
 				if (_animation) {
-					const_cast<Animation*>(_animation)->UpdateAnimation(delta);
+					_animation->UpdateAnimation(delta);
 					if (_animation->HasBoneTransforms()) {
 						ri->animated = true;
-						ri->animation = const_cast<Animation*>(_animation);
+						ri->animation = _animation;
 					}
 				}
 				if (!renderable->shader) {
@@ -113,10 +118,34 @@ public:
 				}
 				this->render_items[renderable->shader].insert(ri.get());
 			}
+		});
+
+		// Now catch up with the transform writes made since the last update.
+		if (transforms_known) {
+			const auto update_transform = [](const eid entity_id) {
+				const Renderable* renderable = RenderableMap::Get(entity_id);
+				if (renderable && renderable->render_item) {
+					SetModelTransform(
+							*renderable->render_item,
+							*renderable,
+							Multiton<eid, Position*>::Get(entity_id),
+							Multiton<eid, Orientation*>::Get(entity_id),
+							Multiton<eid, Scale*>::Get(entity_id));
+				}
+			};
+			RenderableMap::Changes().ForEachChanged(this->renderable_cursor, update_transform);
+			Multiton<eid, Position*>::Changes().ForEachChanged(this->position_cursor, update_transform);
+			Multiton<eid, Orientation*>::Changes().ForEachChanged(this->orientation_cursor, update_transform);
+			Multiton<eid, Scale*>::Changes().ForEachChanged(this->scale_cursor, update_transform);
+		}
+		else {
+			this->renderable_cursor = RenderableMap::Changes().GetCursor();
+			this->position_cursor = Multiton<eid, Position*>::Changes().GetCursor();
+			this->orientation_cursor = Multiton<eid, Orientation*>::Changes().GetCursor();
+			this->scale_cursor = Multiton<eid, Scale*>::Changes().GetCursor();
 		}
 
-		for (auto& [entity_id, view] : Multiton<eid, View*>::Instances()) {
-			auto [_position, _orientation] = Entity(entity_id).GetList<Position, Orientation>();
+		this->view_view.Each([this](eid, View* view, const Position* _position, const Orientation* _orientation) {
 			if (_position) {
 				view->view_pos = -_position->value;
 			}
@@ -126,16 +155,47 @@ public:
 			if (view->active) {
 				this->current_view = *view;
 			}
-		}
+		});
 	}
 
 	RenderItems& GetRenderItems() { return this->render_items; }
 	[[nodiscard]] std::optional<View> GetCurrentView() const { return this->current_view; }
 
 private:
+	static void SetModelTransform(
+			RenderItem& ri,
+			const Renderable& renderable,
+			const Position* _position,
+			const Orientation* _orientation,
+			const Scale* _scale) {
+		ri.model_position = renderable.local_translation;
+		if (_position) {
+			ri.model_position += _position->value;
+		}
+		ri.model_quat = renderable.local_orientation.value;
+		if (_orientation) {
+			ri.model_quat *= _orientation->value;
+		}
+		ri.model_scale = glm::vec3{1.0};
+		if (_scale) {
+			ri.model_scale = _scale->value;
+		}
+	}
+
 	std::map<std::shared_ptr<MeshFile>, std::shared_ptr<VertexBufferObject>> mesh_buffers{};
 	RenderItems render_items{};
 	std::shared_ptr<Shader> default_shader;
 	std::optional<View> current_view{};
+
+	// Joins of each Renderable/View with its transform components, rebuilt when entities gain or lose components.
+	CachedComponentView<Renderable, Optional<Position>, Optional<Orientation>, Optional<Scale>, Optional<Animation>>
+			renderable_view;
+	CachedComponentView<View, Optional<Position>, Optional<Orientation>> view_view;
+
+	// How far into each component's change history the model transforms are up to date.
+	ChangeTracker::Cursor renderable_cursor;
+	ChangeTracker::Cursor position_cursor;
+	ChangeTracker::Cursor orientation_cursor;
+	ChangeTracker::Cursor scale_cursor;
 };
 } // namespace tec::graphics
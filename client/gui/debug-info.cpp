@@ -1,5 +1,12 @@
 #include "debug-info.hpp"
 
+#include <chrono>
+#include <cinttypes>
+
+#include "component-pool.hpp"
+#include "queue-instrumentation.hpp"
+#include "tick-arena.hpp"
+
 namespace tec {
 DebugInfo::DebugInfo(Game& game) : game(game) { this->window_name = "debug_info"; }
 
@@ -31,6 +38,42 @@ void DebugInfo::Draw(IMGUISystem*) {
 	ImGui::ProgressBar(LS, ImVec2(0, 0), "LS");
 	ImGui::ProgressBar(other, ImVec2(0, 0), "other");
 	ImGui::ProgressBar(outside, ImVec2(0, 0), "outside");
+	for (const auto& run : game.GetSystemTimeline()) {
+		ImGui::Text(
+				"%s: %.2f-%.2fms",
+				run.name,
+				std::chrono::duration<double, std::milli>(run.start).count(),
+				std::chrono::duration<double, std::milli>(run.end).count());
+	}
+	for (const auto& pool : ComponentPoolBase::GetAllStats()) {
+		ImGui::Text(
+				"%s: %zu live | %zu slots | %" PRIu64 " allocs | %" PRIu64 " frees",
+				pool.name,
+				pool.live,
+				pool.capacity,
+				pool.allocations,
+				pool.releases);
+	}
+	for (const auto& arena : TickArena::GetAllStats()) {
+		ImGui::Text(
+				"tick arena %zu: %zu bytes high water | %zu in blocks | %" PRIu64 " block allocs",
+				arena.thread,
+				arena.high_water,
+				arena.capacity,
+				arena.block_allocations);
+	}
+	// empty unless built with TEC_EVENT_INSTRUMENTATION
+	for (const auto& queue : QueueInstrument::GetAll()) {
+		ImGui::Text(
+				"%s %s: %" PRIu64 " handled | depth %zu (max %zu) | p50 %" PRIu64 "us p99 %" PRIu64 "us",
+				queue.kind.c_str(),
+				queue.name.c_str(),
+				queue.handled,
+				queue.depth,
+				queue.max_depth,
+				queue.latency_p50_ns / 1000,
+				queue.latency_p99_ns / 1000);
+	}
 	ImGui::SetWindowPos("debug_info", ImVec2(10, 30));
 	ImGui::End();
 	ImGui::SetWindowSize("debug_info", ImVec2(0, 0));
@@ -132,7 +132,7 @@ void IMGUISystem::Update(double delta) {
 	auto& io = ImGui::GetIO();
 	io.DeltaTime = static_cast<float>(delta);
 	EventQueue<WindowResizedEvent>::ProcessEventQueue();
-	EventQueue<MouseMoveEvent>::ProcessEventQueue();
+	BufferedEventQueue<MouseMoveEvent>::ProcessEventQueue();
 	EventQueue<MouseScrollEvent>::ProcessEventQueue();
 	EventQueue<MouseBtnEvent>::ProcessEventQueue();
 	EventQueue<KeyboardEvent>::ProcessEventQueue();
@@ -398,9 +398,9 @@ void IMGUISystem::UpdateDisplaySize() {
 
 void IMGUISystem::On(eid, std::shared_ptr<WindowResizedEvent>) { this->UpdateDisplaySize(); }
 
-void IMGUISystem::On(eid, std::shared_ptr<MouseMoveEvent> data) {
-	this->mouse_pos.x = static_cast<float>(data->new_x);
-	this->mouse_pos.y = static_cast<float>(data->new_y);
+void IMGUISystem::On(eid, const MouseMoveEvent& data) {
+	this->mouse_pos.x = static_cast<float>(data.new_x);
+	this->mouse_pos.y = static_cast<float>(data.new_y);
 }
 
 void IMGUISystem::On(eid, std::shared_ptr<MouseScrollEvent> data) {
@@ -10,6 +10,7 @@
 #include <imgui.h>
 
 #include "command-queue.hpp"
+#include "event-bus.hpp"
 #include "event-system.hpp"
 #include "events.hpp"
 
@@ -25,7 +26,7 @@ class ServerConnection;
 class IMGUISystem :
 		public CommandQueue<IMGUISystem>,
 		public EventQueue<KeyboardEvent>,
-		public EventQueue<MouseMoveEvent>,
+		public BufferedEventQueue<MouseMoveEvent>,
 		public EventQueue<MouseScrollEvent>,
 		public EventQueue<MouseBtnEvent>,
 		public EventQueue<WindowResizedEvent> {
@@ -63,7 +64,7 @@ public:
 
 private:
 	void On(eid, std::shared_ptr<WindowResizedEvent> data) override;
-	void On(eid, std::shared_ptr<MouseMoveEvent> data) override;
+	void On(eid, const MouseMoveEvent& data) override;
 	void On(eid, std::shared_ptr<MouseScrollEvent> data) override;
 	void On(eid, std::shared_ptr<MouseBtnEvent> data) override;
 	void On(eid, std::shared_ptr<KeyboardEvent> data) override;
@@ -46,6 +46,7 @@ void Placement::SetRayIntersectionPoint(const glm::vec3 start, const glm::vec3 i
 	const float distance = glm::distance(start, intersection);
 	const glm::vec3 direction = glm::normalize(intersection - start);
 	renderable->local_translation = start + direction * std::min<float>(distance, this->max_distance);
+	RenderableMap::MarkChanged(ENGINE_ENTITIES::MANIPULATOR);
 }
 
 void Placement::PlaceEntityInWorld(glm::vec3 _position) {
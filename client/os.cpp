@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <iostream>
 
+#include "event-bus.hpp"
 #include "event-system.hpp"
 #include "events.hpp"
 
@@ -396,14 +397,13 @@ void OS::DispatchMouseMoveEvent(const double x, const double y) {
 	if (OS::mouse_locked) {
 		// mouse lock is where we hide the cursor and constrain it to the window
 		// we also request raw mouse motion if available
-		std::shared_ptr<MouseMoveEvent> mmov_event = std::make_shared<MouseMoveEvent>(MouseMoveEvent{
+		EventBus<MouseMoveEvent>::Get().Emit(MouseMoveEvent{
 				x / this->client_width,
 				y / this->client_height,
 				static_cast<int>(this->old_mouse_x),
 				static_cast<int>(this->old_mouse_y),
 				static_cast<int>(x),
 				static_cast<int>(y)});
-		EventSystem<MouseMoveEvent>::Get()->Emit(mmov_event);
 		double client_center_x = static_cast<double>(this->client_width / 2);
 		double client_center_y = static_cast<double>(this->client_height / 2);
 		// constrain the mouse towards the center of the window
@@ -425,14 +425,13 @@ void OS::DispatchMouseMoveEvent(const double x, const double y) {
 		glfwSetCursorPos(this->window, this->old_mouse_x, this->old_mouse_y);
 		return;
 	}
-	std::shared_ptr<MouseMoveEvent> mmov_event = std::make_shared<MouseMoveEvent>(MouseMoveEvent{
+	EventBus<MouseMoveEvent>::Get().Emit(MouseMoveEvent{
 			x / this->client_width,
 			y / this->client_height,
 			static_cast<int>(this->old_mouse_x),
 			static_cast<int>(this->old_mouse_y),
 			static_cast<int>(x),
 			static_cast<int>(y)});
-	EventSystem<MouseMoveEvent>::Get()->Emit(mmov_event);
 	this->old_mouse_x = x;
 	this->old_mouse_y = y;
 }
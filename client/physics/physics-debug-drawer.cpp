@@ -60,7 +60,7 @@ void PhysicsDebugDrawer::drawContactPoint(
 }
 void PhysicsDebugDrawer::UpdateVertexBuffer() {
 	if (!this->vert_buffer) {
-		Renderable* ren = new Renderable(std::make_shared<VertexBufferObject>());
+		Renderable* ren = ComponentPool<Renderable>::Create(std::make_shared<VertexBufferObject>());
 		this->vert_buffer = ren->buffer;
 		this->vert_buffer->Load(verts, indices);
 		this->verts.clear();
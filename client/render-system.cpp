@@ -11,6 +11,7 @@
 #include <google/protobuf/util/json_util.h>
 
 #include "components/transforms.hpp"
+#include "entity.hpp"
 #include "events.hpp"
 #include "graphics/animation.hpp"
 #include "graphics/gl-symbol.hpp"
@@ -275,50 +276,51 @@ void RenderSystem::On(eid, std::shared_ptr<WindowResizedEvent> data) {
 }
 
 void RenderSystem::On(const eid entity_id, std::shared_ptr<EntityDestroyed> data) {
-	RenderableMap::Remove(entity_id);
-	PointLightMap::Remove(entity_id);
-	DirectionalLightMap::Remove(entity_id);
-	AnimationMap::Remove(entity_id);
-	ScaleMap::Remove(entity_id);
+	Entity entity(entity_id);
+	entity.Remove<Renderable>();
+	entity.Remove<PointLight>();
+	entity.Remove<DirectionalLight>();
+	entity.Remove<Animation>();
+	entity.Remove<Scale>();
 }
 
 void RenderSystem::On(eid, const std::shared_ptr<EntityCreated> data) {
-	const eid entity_id = data->entity.id();
+	Entity entity(data->entity.id());
 	for (int i = 0; i < data->entity.components_size(); ++i) {
 		switch (const proto::Component& comp = data->entity.components(i); comp.component_case()) {
 		case proto::Component::kRenderable:
 		{
-			const auto renderable = new Renderable();
+			auto* renderable = ComponentPool<Renderable>::Create();
 			renderable->In(comp);
-			RenderableMap::Set(entity_id, renderable);
+			entity.Update(renderable);
 			break;
 		}
 		case proto::Component::kPointLight:
 		{
-			auto* point_light = new PointLight();
+			auto* point_light = ComponentPool<PointLight>::Create();
 			point_light->In(comp);
-			PointLightMap::Set(entity_id, point_light);
+			entity.Update(point_light);
 			break;
 		}
 		case proto::Component::kDirectionalLight:
 		{
-			auto* dir_light = new DirectionalLight();
+			auto* dir_light = ComponentPool<DirectionalLight>::Create();
 			dir_light->In(comp);
-			DirectionalLightMap::Set(entity_id, dir_light);
+			entity.Update(dir_light);
 			break;
 		}
 		case proto::Component::kAnimation:
 		{
-			auto* animation = new Animation();
+			auto* animation = ComponentPool<Animation>::Create();
 			animation->In(comp);
-			AnimationMap::Set(entity_id, animation);
+			entity.Update(animation);
 			break;
 		}
 		case proto::Component::kScale:
 		{
-			auto* scale = new Scale();
+			auto* scale = ComponentPool<Scale>::Create();
 			scale->In(comp);
-			ScaleMap::Set(entity_id, scale);
+			entity.Update(scale);
 			break;
 		}
 		default: break;
@@ -2,6 +2,7 @@
 #include "event-system.hpp"
 #include "events.hpp"
 #include "game-state.hpp"
+#include "proto-arena.hpp"
 
 using asio::ip::tcp;
 
@@ -28,11 +29,11 @@ ServerConnection::ServerConnection(ServerStats& s) : socket(io_context), stats(s
 	});
 	RegisterMessageHandler(MessageType::CLIENT_ID, [this](MessageIn& message) {
 		std::string id_message = message.ToString();
-		this->client_id = std::atoi(id_message.c_str());
+		this->client_id = std::strtoull(id_message.c_str(), nullptr, 10);
 	});
 	RegisterMessageHandler(MessageType::CLIENT_LEAVE, [](MessageIn& message) {
 		std::string id_message = message.ToString();
-		eid entity_id = std::atoi(id_message.c_str());
+		eid entity_id = std::strtoull(id_message.c_str(), nullptr, 10);
 		_log->info("Entity {} left", entity_id);
 		std::shared_ptr<EntityDestroyed> data = std::make_shared<EntityDestroyed>();
 		EventSystem<EntityDestroyed>::Get()->Emit(entity_id, data);
@@ -45,7 +46,7 @@ ServerConnection::ServerConnection(ServerStats& s) : socket(io_context), stats(s
 	RegisterMessageHandler(MessageType::ENTITY_DESTROY, [](MessageIn& message) {
 		std::string entity_id_message = message.ToString();
 		std::shared_ptr<EntityDestroyed> data = std::make_shared<EntityDestroyed>();
-		eid entity_id = std::atoi(entity_id_message.c_str());
+		eid entity_id = std::strtoull(entity_id_message.c_str(), nullptr, 10);
 		EventSystem<EntityDestroyed>::Get()->Emit(entity_id, data);
 	});
 	RegisterMessageHandler(MessageType::WORLD_SENT, [this](MessageIn&) {
@@ -338,20 +339,23 @@ void ServerConnection::SyncHandler(Message::cptr_type message) {
 }
 
 void ServerConnection::GameStateUpdateHandler(MessageIn& message) {
-	proto::GameStateUpdate gsu;
-	gsu.ParseFromZeroCopyStream(&message);
-	state_id_t recv_state_id = gsu.state_id();
+	// parsed on this thread's arena, which is reset once the state is read out
+	ProtoArena& arena = ProtoArena::ForThread();
+	auto* gsu = google::protobuf::Arena::CreateMessage<proto::GameStateUpdate>(&arena.Get());
+	gsu->ParseFromZeroCopyStream(&message);
+	state_id_t recv_state_id = gsu->state_id();
 	if (recv_state_id <= this->last_received_state_id) {
 		_log->warn("Received an older GameStateUpdate");
 	}
 	else {
 		this->last_received_state_id = recv_state_id;
 		GameState next_state;
-		next_state.In(gsu);
+		next_state.In(*gsu);
 		std::shared_ptr<NewGameStateEvent> new_game_state_msg = std::make_shared<NewGameStateEvent>();
 		new_game_state_msg->new_state = std::move(next_state);
 		EventSystem<NewGameStateEvent>::Get()->Emit(new_game_state_msg);
 	}
+	arena.Reset();
 }
 
 } // namespace networking
@@ -113,13 +113,13 @@ void SoundSystem::On(eid, std::shared_ptr<EntityCreated> data) {
 		switch (comp.component_case()) {
 		case proto::Component::kAudioSource:
 		{
-			AudioSource* audio_source = new AudioSource();
+			AudioSource* audio_source = ComponentPool<AudioSource>::Create();
 			audio_source->In(comp);
 			if (audio_source->vorbis_stream) {
-				AudioSourceComponentMap::Set(entity_id, audio_source);
+				Entity(entity_id).Update(audio_source);
 			}
 			else {
-				delete audio_source;
+				ComponentPool<AudioSource>::Destroy(audio_source);
 			}
 		} break;
 		case proto::Component::kRenderable:
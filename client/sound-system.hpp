@@ -1,6 +1,7 @@
 #ifndef TRILLEK_CLIENT_SOUND_SYSTEM_HPP
 #define TRILLEK_CLIENT_SOUND_SYSTEM_HPP
 
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <set>
@@ -0,0 +1,73 @@
+#include "bullet-task-scheduler.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "job-system.hpp"
+
+namespace tec {
+BulletTaskScheduler::BulletTaskScheduler() : btITaskScheduler("tec::JobSystem"), jobs(JobSystem::Get()) {
+	this->max_thread_count = std::min(
+			static_cast<int>(this->jobs.GetWorkerCount()) + 2, static_cast<int>(BT_MAX_THREAD_COUNT));
+	// the workers and the stepping thread
+	this->thread_count = this->max_thread_count - 1;
+}
+
+BulletTaskScheduler& BulletTaskScheduler::Get() {
+	static BulletTaskScheduler instance;
+	static const bool installed = []() {
+		btSetTaskScheduler(&instance);
+		return true;
+	}();
+	(void)installed;
+	return instance;
+}
+
+bool BulletTaskScheduler::FitsJobSystem() {
+	return JobSystem::Get().GetWorkerCount() + 2 <= static_cast<std::size_t>(BT_MAX_THREAD_COUNT);
+}
+
+void BulletTaskScheduler::setNumThreads(const int num_threads) {
+	this->thread_count = std::clamp(num_threads, 1, this->max_thread_count);
+}
+
+int BulletTaskScheduler::GetChunkSize(const int begin, const int end, const int grain_size) const {
+	const int threads = getNumThreads();
+	return std::max({grain_size, (end - begin + threads - 1) / threads, 1});
+}
+
+void BulletTaskScheduler::parallelFor(
+		const int begin, const int end, const int grain_size, const btIParallelForBody& body) {
+	if (end <= begin) {
+		return;
+	}
+	this->jobs.ParallelFor(
+			static_cast<std::size_t>(begin),
+			static_cast<std::size_t>(end),
+			static_cast<std::size_t>(GetChunkSize(begin, end, grain_size)),
+			[&body](const std::size_t chunk_begin, const std::size_t chunk_end) {
+				body.forLoop(static_cast<int>(chunk_begin), static_cast<int>(chunk_end));
+			});
+}
+
+btScalar BulletTaskScheduler::parallelSum(
+		const int begin, const int end, const int grain_size, const btIParallelSumBody& body) {
+	if (end <= begin) {
+		return btScalar(0);
+	}
+	const int chunk_size = GetChunkSize(begin, end, grain_size);
+	const int chunk_count = (end - begin + chunk_size - 1) / chunk_size;
+	std::vector<btScalar> sums(static_cast<std::size_t>(chunk_count));
+	this->jobs.ParallelFor(0, sums.size(), 1, [&](const std::size_t first, const std::size_t last) {
+		for (std::size_t chunk = first; chunk < last; ++chunk) {
+			const int chunk_begin = begin + static_cast<int>(chunk) * chunk_size;
+			sums[chunk] = body.sumLoop(chunk_begin, std::min(chunk_begin + chunk_size, end));
+		}
+	});
+	btScalar sum(0);
+	for (const btScalar chunk_sum : sums) {
+		sum += chunk_sum;
+	}
+	return sum;
+}
+} // namespace tec
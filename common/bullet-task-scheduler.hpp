@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+
+#include <LinearMath/btThreads.h>
+
+namespace tec {
+class JobSystem;
+
+/**
+* \brief Runs Bullet's parallel loops on the engine-wide JobSystem.
+*
+* Bullet has one task scheduler per process, so this is a singleton that installs itself on
+* first use. Bullet keeps per-thread data indexed by the number it hands each thread the first
+* time it asks, and only accepts a new scheduler from the thread numbered 0. Get() therefore
+* has to be called before anything else uses Bullet's threading, and the threaded worlds have
+* to be stepped from one thread, so only that thread, the installing one and the JobSystem's
+* workers are numbered, which keeps the numbers below getMaxNumThreads().
+*
+* setNumThreads() caps how many threads a loop is spread over, by handing out at most that
+* many chunks. The workers themselves are shared with the rest of the engine.
+*/
+class BulletTaskScheduler final : public btITaskScheduler {
+public:
+	/// The process-wide scheduler, installed with Bullet by the first call.
+	static BulletTaskScheduler& Get();
+
+	/**
+	* \brief Check if Bullet can number every thread that may run its loops.
+	*
+	* Bullet numbers at most BT_MAX_THREAD_COUNT threads, a JobSystem with more workers than
+	* that (less the installing and stepping threads) can't run them. Doesn't install anything.
+	* \return bool False if threaded worlds have to stay single threaded on this machine.
+	*/
+	static bool FitsJobSystem();
+
+	/// The JobSystem's workers, the installing thread and the stepping thread.
+	int getMaxNumThreads() const override { return this->max_thread_count; }
+	int getNumThreads() const override { return this->thread_count.load(std::memory_order_relaxed); }
+	/// Clamped to [1, getMaxNumThreads()].
+	void setNumThreads(int num_threads) override;
+
+	void parallelFor(int begin, int end, int grain_size, const btIParallelForBody& body) override;
+	/// The chunks are summed in order, so the result doesn't depend on which thread ran what.
+	btScalar parallelSum(int begin, int end, int grain_size, const btIParallelSumBody& body) override;
+
+private:
+	BulletTaskScheduler();
+
+	/// The chunk size that splits [begin, end) over at most getNumThreads() threads.
+	int GetChunkSize(int begin, int end, int grain_size) const;
+
+	JobSystem& jobs;
+	int max_thread_count{1};
+	std::atomic<int> thread_count{1};
+};
+} // namespace tec
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "component-store.hpp"
+#include "tec-types.hpp"
+
+namespace tec {
+/**
+* \brief Records which entities had a component written, so readers only visit what changed.
+*
+* Every MarkChanged() or MarkRemoved() bumps the tracker's version and stamps the entity
+* with it. Each reader keeps its own Cursor and asks for the entities changed since it
+* last looked, so several systems can consume the same changes at their own pace.
+*
+* Changes are also appended to a log, which makes ForEachChanged() proportional to the
+* number of changes rather than the number of entities. The log is trimmed as it grows;
+* a reader that fell behind the trimmed part (or whose cursor belongs to another tracker)
+* is told so and has to do a full pass instead.
+*
+* Not thread-safe, like the stores it tracks.
+*/
+class ChangeTracker {
+public:
+	/// A reader's position in the change history of a tracker.
+	struct Cursor {
+		std::uint64_t tracker{0}; // ID of the tracker the cursor reads, 0 if it never read one.
+		std::uint64_t version{0};
+	};
+
+	ChangeTracker() : id(NextTrackerId()) {}
+	ChangeTracker(const ChangeTracker&) = delete;
+	ChangeTracker& operator=(const ChangeTracker&) = delete;
+	ChangeTracker(ChangeTracker&&) noexcept = default;
+	ChangeTracker& operator=(ChangeTracker&&) noexcept = default;
+
+	/// Records a write to the entity's component.
+	void MarkChanged(const eid entity_id) {
+		++this->version;
+		this->stamps.Overwrite(entity_id, this->version);
+		this->removals.Remove(entity_id);
+		Append(entity_id, false);
+	}
+
+	/// Records the removal of the entity's component, readers see it as a change as well.
+	void MarkRemoved(const eid entity_id) {
+		++this->version;
+		this->stamps.Remove(entity_id);
+		this->removals.Overwrite(entity_id, this->version);
+		Append(entity_id, true);
+	}
+
+	/**
+	* \brief Checks if the entity's component was written after the cursor's position.
+	*
+	* A cursor of another tracker reports every entity as changed.
+	* \param[in] const eid entity_id The entity to check.
+	* \param[in] const Cursor& cursor The reader's cursor.
+	* \return bool True if the component changed since the cursor.
+	*/
+	bool ChangedSince(const eid entity_id, const Cursor& cursor) const {
+		if (cursor.tracker != this->id) {
+			return true;
+		}
+		const std::uint64_t* stamp = this->stamps.Find(entity_id);
+		return stamp && *stamp > cursor.version;
+	}
+
+	/**
+	* \brief Call fn(eid) once for every entity whose component changed or was removed since the cursor.
+	*
+	* The cursor is moved to the current version whatever the outcome.
+	* \param[in] Cursor& cursor The reader's cursor.
+	* \param[in] F&& fn The function to call for each changed entity.
+	* \return bool False if the changes since the cursor are unknown and the caller must visit everything.
+	*/
+	template <typename F> bool ForEachChanged(Cursor& cursor, F&& fn) const {
+		const bool known = IsValid(cursor);
+		if (known) {
+			for (std::size_t i = cursor.version - this->log_base; i < this->log.size(); ++i) {
+				const LogEntry& entry = this->log[i];
+				const std::uint64_t entry_version = this->log_base + i + 1;
+				const std::uint64_t* latest =
+						entry.removed ? this->removals.Find(entry.entity_id) : this->stamps.Find(entry.entity_id);
+				// later writes to the same entity have their own entry, only report the newest one
+				if (latest && *latest == entry_version) {
+					fn(entry.entity_id);
+				}
+			}
+		}
+		cursor = GetCursor();
+		return known;
+	}
+
+	/// Checks if ForEachChanged() can report the changes since the cursor.
+	bool IsValid(const Cursor& cursor) const {
+		return cursor.tracker == this->id && cursor.version >= this->log_base && cursor.version <= this->version;
+	}
+
+	/// Get a cursor at the current version, reading from it reports only later changes.
+	Cursor GetCursor() const { return Cursor{this->id, this->version}; }
+
+	std::uint64_t GetVersion() const { return this->version; }
+
+	/// Forgets all changes. Existing cursors become invalid, so their readers do a full pass.
+	void Clear() {
+		this->stamps.Clear();
+		this->removals.Clear();
+		this->log.clear();
+		this->log_base = this->version;
+		this->id = NextTrackerId();
+	}
+
+private:
+	static constexpr std::size_t MIN_LOG_SIZE = 4096;
+
+	struct LogEntry {
+		eid entity_id;
+		bool removed;
+	};
+
+	static std::uint64_t NextTrackerId() {
+		static std::atomic<std::uint64_t> next_id{1};
+		return next_id++;
+	}
+
+	// log[i] holds the change that produced version log_base + i + 1.
+	void Append(const eid entity_id, const bool removed) {
+		this->log.push_back(LogEntry{entity_id, removed});
+		if (this->log.size() >= std::max(MIN_LOG_SIZE, 4 * (this->stamps.Size() + this->removals.Size()))) {
+			Trim();
+		}
+	}
+
+	// Drops the older half of the log, along with the removals only it referred to.
+	void Trim() {
+		const std::size_t dropped = this->log.size() / 2;
+		this->log.erase(this->log.begin(), this->log.begin() + dropped);
+		this->log_base += dropped;
+		std::vector<eid> expired;
+		for (const auto& [entity_id, removed_version] : this->removals) {
+			if (removed_version <= this->log_base) {
+				expired.push_back(entity_id);
+			}
+		}
+		for (const eid entity_id : expired) {
+			this->removals.Remove(entity_id);
+		}
+	}
+
+	std::uint64_t id;
+	std::uint64_t version{0};
+	std::uint64_t log_base{0};
+	ComponentStore<std::uint64_t> stamps; // Version of the last write of each entity that has the component.
+	ComponentStore<std::uint64_t> removals; // Version of each removal still in the log.
+	std::vector<LogEntry> log;
+};
+} // namespace tec
@@ -0,0 +1,113 @@
+#include "collision-shape-cache.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+
+#include <btBulletCollisionCommon.h>
+
+namespace tec {
+// Shared with the deleters of the shapes, so a shape may outlive the cache.
+struct CollisionShapeCache::Counters {
+	std::atomic<std::size_t> live_shapes{0};
+	std::atomic<std::size_t> live_bytes{0};
+	std::atomic<std::uint64_t> hits{0};
+	std::atomic<std::uint64_t> misses{0};
+	std::atomic<std::uint64_t> releases{0};
+};
+
+CollisionShapeCache::CollisionShapeCache() : counters(std::make_shared<Counters>()) {}
+
+CollisionShapeCache& CollisionShapeCache::Get() {
+	static CollisionShapeCache instance;
+	return instance;
+}
+
+std::size_t CollisionShapeCache::KeyHash::operator()(const Key& key) const {
+	std::size_t hash = std::hash<std::int32_t>()(static_cast<std::int32_t>(key.type));
+	for (const std::int32_t dimension : key.dimensions) {
+		hash ^= std::hash<std::int32_t>()(dimension) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+	}
+	return hash;
+}
+
+std::int32_t CollisionShapeCache::Quantize(const float dimension) {
+	return static_cast<std::int32_t>(std::lround(dimension / DIMENSION_QUANTUM));
+}
+
+float CollisionShapeCache::Dequantize(const std::int32_t dimension) {
+	return static_cast<float>(dimension) * DIMENSION_QUANTUM;
+}
+
+template <typename F>
+std::shared_ptr<btCollisionShape> CollisionShapeCache::Intern(const Key& key, const std::size_t size, F&& create) {
+	std::lock_guard lock(this->mutex);
+	std::weak_ptr<btCollisionShape>& entry = this->shapes[key];
+	if (std::shared_ptr<btCollisionShape> shape = entry.lock()) {
+		this->counters->hits.fetch_add(1, std::memory_order_relaxed);
+		return shape;
+	}
+
+	this->counters->misses.fetch_add(1, std::memory_order_relaxed);
+	this->counters->live_shapes.fetch_add(1, std::memory_order_relaxed);
+	this->counters->live_bytes.fetch_add(size, std::memory_order_relaxed);
+	std::shared_ptr<btCollisionShape> shape(create(), [counters = this->counters, size](btCollisionShape* released) {
+		delete released;
+		counters->live_shapes.fetch_sub(1, std::memory_order_relaxed);
+		counters->live_bytes.fetch_sub(size, std::memory_order_relaxed);
+		counters->releases.fetch_add(1, std::memory_order_relaxed);
+	});
+	entry = shape;
+
+	// released shapes leave their entries behind, drop them once they could make up half the map
+	if (this->shapes.size() >= this->next_eviction) {
+		EvictLocked();
+		this->next_eviction = std::max<std::size_t>(64, this->shapes.size() * 2);
+	}
+	return shape;
+}
+
+std::shared_ptr<btCollisionShape> CollisionShapeCache::GetBox(const float half_x, const float half_y, const float half_z) {
+	const Key key{ShapeType::Box, {Quantize(half_x), Quantize(half_y), Quantize(half_z)}};
+	return Intern(key, sizeof(btBoxShape), [&key]() {
+		return new btBoxShape(btVector3(
+				Dequantize(key.dimensions[0]), Dequantize(key.dimensions[1]), Dequantize(key.dimensions[2])));
+	});
+}
+
+std::shared_ptr<btCollisionShape> CollisionShapeCache::GetSphere(const float radius) {
+	const Key key{ShapeType::Sphere, {Quantize(radius), 0, 0}};
+	return Intern(key, sizeof(btSphereShape), [&key]() { return new btSphereShape(Dequantize(key.dimensions[0])); });
+}
+
+std::shared_ptr<btCollisionShape> CollisionShapeCache::GetCapsule(const float radius, const float height) {
+	const Key key{ShapeType::Capsule, {Quantize(radius), Quantize(height), 0}};
+	return Intern(key, sizeof(btCapsuleShape), [&key]() {
+		return new btCapsuleShape(Dequantize(key.dimensions[0]), Dequantize(key.dimensions[1]));
+	});
+}
+
+std::size_t CollisionShapeCache::Evict() {
+	std::lock_guard lock(this->mutex);
+	return EvictLocked();
+}
+
+std::size_t CollisionShapeCache::EvictLocked() {
+	return std::erase_if(this->shapes, [](const auto& entry) { return entry.second.expired(); });
+}
+
+CollisionShapeCacheStats CollisionShapeCache::GetStats() const {
+	CollisionShapeCacheStats stats;
+	{
+		std::lock_guard lock(this->mutex);
+		stats.entries = this->shapes.size();
+	}
+	stats.live_shapes = this->counters->live_shapes.load(std::memory_order_relaxed);
+	stats.live_bytes = this->counters->live_bytes.load(std::memory_order_relaxed);
+	stats.hits = this->counters->hits.load(std::memory_order_relaxed);
+	stats.misses = this->counters->misses.load(std::memory_order_relaxed);
+	stats.releases = this->counters->releases.load(std::memory_order_relaxed);
+	return stats;
+}
+} // namespace tec
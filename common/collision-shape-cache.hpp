@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+class btCollisionShape;
+
+namespace tec {
+/// Usage of the CollisionShapeCache.
+struct CollisionShapeCacheStats {
+	std::size_t entries{0}; // Shapes the cache knows, some may have been released already.
+	std::size_t live_shapes{0}; // Shapes held by at least one body.
+	std::size_t live_bytes{0}; // Size of the live shape objects.
+	std::uint64_t hits{0}; // Requests answered with an existing shape.
+	std::uint64_t misses{0}; // Requests that created a shape.
+	std::uint64_t releases{0}; // Shapes destroyed once their last holder let go.
+};
+
+/**
+* \brief Interns collision shapes, so bodies with the same dimensions share one shape.
+*
+* Shapes are keyed by type and dimensions rounded to DIMENSION_QUANTUM, so dimensions that
+* only differ by float noise share a shape as well. The cache only holds weak references: a
+* shape is destroyed once the last body using it lets go, and its entry is dropped by the next
+* Evict(), which also runs on its own as the number of entries grows.
+*
+* Shapes handed out are shared and must not be modified, e.g. by setLocalScaling(). Safe to use
+* from several threads.
+*/
+class CollisionShapeCache {
+public:
+	static constexpr float DIMENSION_QUANTUM = 1.0f / 1024.0f;
+
+	/// The engine-wide cache.
+	static CollisionShapeCache& Get();
+
+	std::shared_ptr<btCollisionShape> GetBox(float half_x, float half_y, float half_z);
+	std::shared_ptr<btCollisionShape> GetSphere(float radius);
+	std::shared_ptr<btCollisionShape> GetCapsule(float radius, float height);
+
+	/// Drop the entries of released shapes, returns how many were dropped.
+	std::size_t Evict();
+
+	CollisionShapeCacheStats GetStats() const;
+
+private:
+	enum class ShapeType : std::int32_t { Box, Sphere, Capsule };
+
+	struct Key {
+		ShapeType type;
+		std::array<std::int32_t, 3> dimensions;
+
+		bool operator==(const Key&) const = default;
+	};
+
+	struct KeyHash {
+		std::size_t operator()(const Key& key) const;
+	};
+
+	struct Counters;
+
+	CollisionShapeCache();
+
+	static std::int32_t Quantize(float dimension);
+	static float Dequantize(std::int32_t dimension);
+
+	/// Get the live shape for key, or create one with create() if there's none.
+	template <typename F> std::shared_ptr<btCollisionShape> Intern(const Key& key, std::size_t size, F&& create);
+	std::size_t EvictLocked();
+
+	mutable std::mutex mutex;
+	std::unordered_map<Key, std::weak_ptr<btCollisionShape>, KeyHash> shapes; // Guarded by mutex.
+	std::size_t next_eviction{64}; // Entry count that triggers an Evict(), guarded by mutex.
+	std::shared_ptr<Counters> counters; // Also updated by the deleters of the shapes.
+};
+} // namespace tec
@@ -1,47 +1,134 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
-#include <functional>
-#include <memory>
-#include <queue>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "mpsc-ring.hpp"
+#include "queue-instrumentation.hpp"
+#include "small-function.hpp"
 
 namespace tec {
 template <class T> struct Command {
-	Command(std::function<void(T*)>&& command) : command(std::move(command)) {}
-	Command(Command&& c) noexcept : command(std::move(c.command)) {}
-	std::function<void(T*)> command;
+	Command() = default;
+	template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Command>>>
+	Command(F&& command) : command(std::forward<F>(command)) {}
+	Command(Command&& c) noexcept = default;
+	Command& operator=(Command&& c) noexcept = default;
+	// Lambdas with a few captures are stored inline, so queueing them doesn't allocate.
+	SmallFunction<void(T*)> command;
+	[[no_unique_address]] QueueTimestamp queued_at;
+};
+
+/// Counters of the command queue of one system type.
+struct CommandQueueStats {
+	std::size_t depth{0}; // Commands waiting right now.
+	std::size_t capacity{0}; // Commands the ring holds before the overflow policy applies.
+	std::size_t high_water{0}; // Most commands waiting at once, sampled when one is queued.
+	std::uint64_t processed{0}; // Total commands run since startup.
+	std::uint64_t dropped{0}; // Total commands discarded by OverflowPolicy::DROP.
+	std::uint64_t last_drain_ns{0}; // Duration of the last ProcessCommandQueue() call.
+	std::uint64_t max_drain_ns{0}; // Longest ProcessCommandQueue() call so far.
 };
 
-// Thread friendly double queue for incoming commands. Call ProcessCommandQueue() to
-// iterate over all queued commands when it is safe to modify state.
+// Thread friendly queue for incoming commands. Commands may be queued from any thread without
+// locking into a bounded ring shared by every instance of T; call ProcessCommandQueue() to
+// run all queued commands when it is safe to modify state. What happens when the ring is
+// full is up to SetOverflowPolicy(), by default the queue grows like it always did.
 template <class T> class CommandQueue {
 public:
-	CommandQueue() : local_queue(new std::queue<Command<T>>()) {
-		if (!global_command_queue.load()) {
-			global_command_queue.store(new std::queue<Command<T>>());
-		}
-	}
+	static constexpr std::size_t DEFAULT_CAPACITY = 1024;
+
+	CommandQueue() { GetShared(); }
 	~CommandQueue() {}
 
 	void ProcessCommandQueue() {
-		this->local_queue = global_command_queue.exchange(this->local_queue);
+		Shared& shared = GetShared();
+		const auto start = std::chrono::steady_clock::now();
+		const std::size_t count = shared.queue.ConsumeAll([this](Command<T>&& command) {
+			if constexpr (QUEUE_INSTRUMENTATION) {
+				QueueInstrument::ForCommand<T>().CountHandled(command.queued_at);
+			}
+			command.command(static_cast<T*>(this));
+		});
+		if constexpr (QUEUE_INSTRUMENTATION) {
+			QueueInstrument::ForCommand<T>().CountDrained(count);
+		}
+		const auto drain_ns = static_cast<std::uint64_t>(
+				std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+						.count());
 
-		while (!this->local_queue->empty()) {
-			Command<T> command = std::move(this->local_queue->front());
-			this->local_queue->pop();
+		// only the processing thread writes these, the atomics are for readers of GetStats()
+		shared.processed.store(shared.processed.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+		shared.last_drain_ns.store(drain_ns, std::memory_order_relaxed);
+		shared.max_drain_ns.store(
+				std::max(shared.max_drain_ns.load(std::memory_order_relaxed), drain_ns), std::memory_order_relaxed);
+	}
 
-			command.command(static_cast<T*>(this));
+	/**
+	* \brief Queue a command to run on the next ProcessCommandQueue(), this may be called from any thread.
+	*
+	* \param[in] Command<T>&& command The command to queue.
+	* \return bool False if the queue was full and the command was dropped.
+	*/
+	static bool QueueCommand(Command<T>&& command) {
+		if constexpr (QUEUE_INSTRUMENTATION) {
+			QueueInstrument::ForCommand<T>().CountEmitted();
 		}
+		Shared& shared = GetShared();
+		if (!shared.queue.Push(std::move(command))) {
+			return false;
+		}
+		// any thread may queue, so the peak is raised with a compare-and-swap
+		const std::size_t depth = shared.queue.Size();
+		std::size_t high_water = shared.high_water.load(std::memory_order_relaxed);
+		while (depth > high_water
+			   && !shared.high_water.compare_exchange_weak(high_water, depth, std::memory_order_relaxed)) {
+		}
+		if constexpr (QUEUE_INSTRUMENTATION) {
+			QueueInstrument::ForCommand<T>().CountQueued();
+		}
+		return true;
 	}
 
-	static void QueueCommand(Command<T>&& command) { (*global_command_queue).push(std::move(command)); }
+	template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Command<T>>>>
+	static bool QueueCommand(F&& command) {
+		return QueueCommand(Command<T>(std::forward<F>(command)));
+	}
 
-	static void QueueCommand(std::function<void(T*)>&& command) { (*global_command_queue).push(std::move(command)); }
+	/// Set what QueueCommand() does when the queue is full, meant to be called before producers start.
+	static void SetOverflowPolicy(const OverflowPolicy policy) { GetShared().queue.SetOverflowPolicy(policy); }
 
-protected:
-	static std::atomic<std::queue<Command<T>>*> global_command_queue;
-	std::queue<Command<T>>* local_queue;
-};
+	static CommandQueueStats GetStats() {
+		const Shared& shared = GetShared();
+		CommandQueueStats stats;
+		stats.depth = shared.queue.Size();
+		stats.capacity = shared.queue.Capacity();
+		stats.high_water = shared.high_water.load(std::memory_order_relaxed);
+		stats.processed = shared.processed.load(std::memory_order_relaxed);
+		stats.dropped = shared.queue.GetDroppedCount();
+		stats.last_drain_ns = shared.last_drain_ns.load(std::memory_order_relaxed);
+		stats.max_drain_ns = shared.max_drain_ns.load(std::memory_order_relaxed);
+		return stats;
+	}
+
+private:
+	struct Shared {
+		BoundedMPSCQueue<Command<T>> queue{DEFAULT_CAPACITY};
+		std::atomic<std::size_t> high_water{0};
+		std::atomic<std::uint64_t> processed{0};
+		std::atomic<std::uint64_t> last_drain_ns{0};
+		std::atomic<std::uint64_t> max_drain_ns{0};
+	};
 
-template <class T> std::atomic<std::queue<Command<T>>*> CommandQueue<T>::global_command_queue;
+	static Shared& GetShared() {
+		// Intentionally never destroyed, commands may still be queued during static teardown.
+		static Shared* shared = new Shared();
+		return *shared;
+	}
+};
 } // namespace tec
@@ -0,0 +1,41 @@
+#include "component-pool.hpp"
+
+namespace tec {
+namespace {
+std::mutex& RegistryMutex() {
+	static std::mutex registry_mutex;
+	return registry_mutex;
+}
+
+std::vector<ComponentPoolBase*>& Registry() {
+	static std::vector<ComponentPoolBase*> pools;
+	return pools;
+}
+} // namespace
+
+void ComponentPoolBase::Register(ComponentPoolBase* pool) {
+	std::lock_guard lock(RegistryMutex());
+	Registry().push_back(pool);
+}
+
+std::vector<ComponentPoolStats> ComponentPoolBase::GetAllStats() {
+	std::lock_guard lock(RegistryMutex());
+	std::vector<ComponentPoolStats> stats;
+	stats.reserve(Registry().size());
+	for (const auto* pool : Registry()) {
+		stats.push_back(pool->GetStats());
+	}
+	return stats;
+}
+
+void ComponentPoolBase::ReleaseAllPools() {
+	std::vector<ComponentPoolBase*> pools;
+	{
+		std::lock_guard lock(RegistryMutex());
+		pools = Registry();
+	}
+	for (auto* pool : pools) {
+		pool->ReleaseAll();
+	}
+}
+} // namespace tec
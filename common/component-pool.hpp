@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "multiton.hpp"
+#include "tec-types.hpp"
+
+namespace tec {
+/// Allocation counters of a single component pool.
+struct ComponentPoolStats {
+	const char* name{nullptr};
+	std::size_t live{0}; // Objects currently handed out.
+	std::size_t capacity{0}; // Slots in all chunks, used or free.
+	std::size_t chunks{0};
+	std::uint64_t allocations{0}; // Total objects created since startup.
+	std::uint64_t releases{0}; // Total objects destroyed since startup.
+};
+
+/// Type erased access to every ComponentPool so they can be listed and released together.
+class ComponentPoolBase {
+public:
+	virtual ~ComponentPoolBase() = default;
+
+	virtual ComponentPoolStats GetStats() const = 0;
+
+	/// Destroys every live object of this pool, see ComponentPool<T>::ReleaseAll().
+	virtual void ReleaseAll() = 0;
+
+	/// Get the stats of every pool that has been used so far.
+	static std::vector<ComponentPoolStats> GetAllStats();
+
+	/// Releases every pool that has been used so far.
+	static void ReleaseAllPools();
+
+protected:
+	static void Register(ComponentPoolBase* pool);
+};
+
+/**
+* \brief Chunked pool allocator for one component type.
+*
+* Components are carved out of fixed size chunks that are never moved or freed while the
+* pool lives, so a component keeps its address for its whole lifetime (Bullet and the
+* renderer hold on to component pointers). Destroyed slots go on a free list and are
+* reused before a new chunk is allocated.
+*
+* Every component placed in a Multiton<eid, T*> must come from here, Entity::Remove() and
+* Entity::Update() hand the old component back with Destroy().
+*
+* Pools are per type singletons and safe to use from several threads.
+*/
+template <typename T, std::size_t CHUNK_SIZE = 256> class ComponentPool final : public ComponentPoolBase {
+public:
+	static ComponentPool& Get() {
+		static ComponentPool* pool = [] {
+			// Intentionally never destroyed, components may still be referenced during static teardown.
+			auto* p = new ComponentPool();
+			Register(p);
+			return p;
+		}();
+		return *pool;
+	}
+
+	/**
+	* \brief Construct a component in the pool.
+	*
+	* \param[in] Args&&... args Arguments forwarded to T's constructor.
+	* \return T* The new component.
+	*/
+	template <typename... Args> static T* Create(Args&&... args) { return Get().Allocate(std::forward<Args>(args)...); }
+
+	/**
+	* \brief Destroy a component created by Create() and return its slot to the pool.
+	*
+	* Destroying a component that was already destroyed does nothing.
+	* \param[in] T* component The component to destroy, nullptr is ignored.
+	* \return void
+	*/
+	static void Destroy(T* component) { Get().Release(component); }
+
+	/**
+	* \brief Destroys every live component and drops the Multiton<eid, T*> entries that point at them.
+	*
+	* Used when a world is torn down. The chunks are kept for the next world.
+	* \return void
+	*/
+	void ReleaseAll() override {
+		Multiton<eid, T*>::Clear();
+		std::lock_guard lock(this->mutex);
+		this->free_list = nullptr;
+		for (auto& chunk : this->chunks) {
+			for (std::size_t i = CHUNK_SIZE; i-- > 0;) {
+				Slot& slot = chunk[i];
+				if (slot.live) {
+					std::launder(reinterpret_cast<T*>(slot.storage))->~T();
+					slot.live = false;
+					++this->releases;
+				}
+				slot.next = this->free_list;
+				this->free_list = &slot;
+			}
+		}
+		this->live = 0;
+	}
+
+	ComponentPoolStats GetStats() const override {
+		std::lock_guard lock(this->mutex);
+		ComponentPoolStats stats;
+		stats.name = GetTypeName<T>();
+		stats.live = this->live;
+		stats.capacity = this->chunks.size() * CHUNK_SIZE;
+		stats.chunks = this->chunks.size();
+		stats.allocations = this->allocations;
+		stats.releases = this->releases;
+		return stats;
+	}
+
+private:
+	// The component storage comes first so a T* converts straight back to its Slot.
+	struct Slot {
+		union {
+			alignas(T) unsigned char storage[sizeof(T)];
+			Slot* next;
+		};
+		bool live{false};
+	};
+
+	ComponentPool() = default;
+
+	template <typename... Args> T* Allocate(Args&&... args) {
+		Slot* slot = nullptr;
+		{
+			std::lock_guard lock(this->mutex);
+			if (!this->free_list) {
+				AddChunk();
+			}
+			slot = this->free_list;
+			this->free_list = slot->next;
+			slot->live = true;
+			++this->live;
+			++this->allocations;
+		}
+		try {
+			return new (slot->storage) T(std::forward<Args>(args)...);
+		}
+		catch (...) {
+			std::lock_guard lock(this->mutex);
+			PushFree(slot);
+			--this->allocations;
+			throw;
+		}
+	}
+
+	void Release(T* component) {
+		if (!component) {
+			return;
+		}
+		Slot* slot = reinterpret_cast<Slot*>(component);
+		std::lock_guard lock(this->mutex);
+		// destroying a component twice would link its slot into the free list twice
+		if (!slot->live) {
+			return;
+		}
+		component->~T();
+		PushFree(slot);
+		++this->releases;
+	}
+
+	void PushFree(Slot* slot) {
+		slot->live = false;
+		slot->next = this->free_list;
+		this->free_list = slot;
+		--this->live;
+	}
+
+	void AddChunk() {
+		auto& chunk = this->chunks.emplace_back(new Slot[CHUNK_SIZE]);
+		// Link back to front so the first slots of a chunk are handed out first.
+		for (std::size_t i = CHUNK_SIZE; i-- > 0;) {
+			chunk[i].next = this->free_list;
+			this->free_list = &chunk[i];
+		}
+	}
+
+	mutable std::mutex mutex;
+	std::vector<std::unique_ptr<Slot[]>> chunks;
+	Slot* free_list{nullptr};
+	std::size_t live{0};
+	std::uint64_t allocations{0};
+	std::uint64_t releases{0};
+};
+} // namespace tec
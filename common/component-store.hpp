@@ -0,0 +1,214 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "entity-id-allocator.hpp"
+#include "tec-types.hpp"
+
+namespace tec {
+/**
+* \brief Sparse set storage for per-entity components.
+*
+* Components are stored by value in a densely packed array next to the ID of the entity
+* that owns them, so iterating a store is a linear walk over contiguous memory. A paged
+* sparse index maps an entity ID to its slot in the dense array, which makes Has, Find,
+* Set and Remove constant time without any hashing or tree walks.
+*
+* The sparse index is keyed by the index part of the entity ID (see EntityIdAllocator).
+* The full ID is kept in the dense array and compared on lookup, so a stale ID from an
+* older generation of the same index is reported as absent. Setting a component while an
+* older generation of the index still holds its slot means that entity was never removed, so
+* Set/Emplace assert instead of taking the slot over. Stores whose entries may outlive their
+* entity on purpose use Overwrite().
+*
+* Removal swaps the last element into the freed slot, so iteration order is not stable.
+* Set/Emplace may reallocate the dense array and Remove moves an element; both invalidate
+* pointers, references and iterators into the store. Use a pointer store
+* (ComponentStore<T*>) for components whose address must not change.
+*/
+template <typename T> class ComponentStore {
+public:
+	using value_type = std::pair<eid, T>;
+	using iterator = typename std::vector<value_type>::iterator;
+	using const_iterator = typename std::vector<value_type>::const_iterator;
+
+	static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+	ComponentStore() = default;
+	ComponentStore(const ComponentStore&) = delete;
+	ComponentStore& operator=(const ComponentStore&) = delete;
+	ComponentStore(ComponentStore&&) noexcept = default;
+	ComponentStore& operator=(ComponentStore&&) noexcept = default;
+
+	/**
+	* \brief Get the position of an entity's component in the dense array.
+	*
+	* \param[in] const eid id The entity ID to look up.
+	* \return std::size_t The dense index or npos if the entity has no component.
+	*/
+	std::size_t IndexOf(const eid id) const {
+		const std::uint32_t key = SparseKey(id);
+		const std::size_t page = key / PAGE_SIZE;
+		if (page >= this->sparse.size() || !this->sparse[page]) {
+			return npos;
+		}
+		const std::uint32_t slot = (*this->sparse[page])[key % PAGE_SIZE];
+		if (slot == 0 || this->dense[slot - 1].first != id) {
+			return npos;
+		}
+		return slot - 1;
+	}
+
+	bool Has(const eid id) const { return IndexOf(id) != npos; }
+
+	/**
+	* \brief Get a pointer to an entity's component.
+	*
+	* \param[in] const eid id The entity ID to look up.
+	* \return T* The component or nullptr if the entity has no component.
+	*/
+	T* Find(const eid id) {
+		const std::size_t index = IndexOf(id);
+		return index == npos ? nullptr : &this->dense[index].second;
+	}
+
+	const T* Find(const eid id) const {
+		const std::size_t index = IndexOf(id);
+		return index == npos ? nullptr : &this->dense[index].second;
+	}
+
+	/**
+	* \brief Construct (or replace) the component for the given entity in place.
+	*
+	* \param[in] const eid id The entity ID that owns the component.
+	* \param[in] Args&&... args Arguments forwarded to T's constructor.
+	* \return T& The stored component.
+	*/
+	template <typename... Args> T& Emplace(const eid id, Args&&... args) {
+		std::uint32_t& slot = SparseSlot(SparseKey(id));
+		assert((slot == 0 || this->dense[slot - 1].first == id) && "the index is still held by another generation");
+		return EmplaceAt(slot, id, std::forward<Args>(args)...);
+	}
+
+	/**
+	* \brief Set (or add) the component for the given entity, taking over the slot of another ID sharing its index.
+	*
+	* For bookkeeping about IDs rather than live components, e.g. the stamps of a ChangeTracker.
+	* \param[in] const eid id The entity ID that owns the component.
+	* \param[in] T value The component value.
+	* \return T& The stored component.
+	*/
+	T& Overwrite(const eid id, T value) { return EmplaceAt(SparseSlot(SparseKey(id)), id, std::move(value)); }
+
+	/**
+	* \brief Set (or add) the component for the given entity.
+	*
+	* \param[in] const eid id The entity ID that owns the component.
+	* \param[in] T value The component value.
+	* \return T& The stored component.
+	*/
+	T& Set(const eid id, T value) { return Emplace(id, std::move(value)); }
+
+	/**
+	* \brief Remove the component for the given entity.
+	*
+	* The last component in the dense array is moved into the freed slot.
+	* \param[in] const eid id The entity ID whose component to remove.
+	* \return bool True if a component was removed.
+	*/
+	bool Remove(const eid id) {
+		const std::size_t index = IndexOf(id);
+		if (index == npos) {
+			return false;
+		}
+		const std::size_t last = this->dense.size() - 1;
+		if (index != last) {
+			this->dense[index] = std::move(this->dense[last]);
+			SparseSlot(SparseKey(this->dense[index].first)) = static_cast<std::uint32_t>(index + 1);
+		}
+		SparseSlot(SparseKey(id)) = 0;
+		this->dense.pop_back();
+		++this->version;
+		return true;
+	}
+
+	/// Removes all components, the sparse pages are kept for reuse.
+	void Clear() {
+		for (const auto& entry : this->dense) {
+			SparseSlot(SparseKey(entry.first)) = 0;
+		}
+		this->dense.clear();
+		++this->version;
+	}
+
+	void Reserve(const std::size_t count) { this->dense.reserve(count); }
+
+	std::size_t Size() const { return this->dense.size(); }
+
+	bool Empty() const { return this->dense.empty(); }
+
+	/**
+	* \brief Get the structural version of this store.
+	*
+	* The version changes every time an entity gains or loses a component, but not when a
+	* component value is overwritten. Cached queries compare it to know when to rebuild.
+	* \return std::uint64_t The current version.
+	*/
+	std::uint64_t GetVersion() const { return this->version; }
+
+	value_type& At(const std::size_t index) { return this->dense[index]; }
+	const value_type& At(const std::size_t index) const { return this->dense[index]; }
+
+	iterator begin() { return this->dense.begin(); }
+	iterator end() { return this->dense.end(); }
+	const_iterator begin() const { return this->dense.begin(); }
+	const_iterator end() const { return this->dense.end(); }
+
+private:
+	static constexpr std::size_t PAGE_SIZE = 4096;
+	using Page = std::array<std::uint32_t, PAGE_SIZE>;
+
+	static std::uint32_t SparseKey(const eid id) { return GetEntityIndex(id); }
+
+	// Get the sparse slot for a key, allocating its page if needed.
+	// A slot holds the dense index + 1 so a freshly zeroed page reads as empty.
+	std::uint32_t& SparseSlot(const std::uint32_t key) {
+		const std::size_t page = key / PAGE_SIZE;
+		if (page >= this->sparse.size()) {
+			this->sparse.resize(page + 1);
+		}
+		if (!this->sparse[page]) {
+			this->sparse[page] = std::make_unique<Page>();
+		}
+		return (*this->sparse[page])[key % PAGE_SIZE];
+	}
+
+	// Construct the component in a sparse slot, taking it over from a different ID that shares the key.
+	template <typename... Args> T& EmplaceAt(std::uint32_t& slot, const eid id, Args&&... args) {
+		if (slot != 0) {
+			value_type& entry = this->dense[slot - 1];
+			if (entry.first != id) {
+				entry.first = id;
+				++this->version;
+			}
+			entry.second = T(std::forward<Args>(args)...);
+			return entry.second;
+		}
+		this->dense.emplace_back(
+				std::piecewise_construct, std::forward_as_tuple(id), std::forward_as_tuple(std::forward<Args>(args)...));
+		slot = static_cast<std::uint32_t>(this->dense.size());
+		++this->version;
+		return this->dense.back().second;
+	}
+
+	std::vector<value_type> dense;
+	std::vector<std::unique_ptr<Page>> sparse;
+	std::uint64_t version{0};
+};
+} // namespace tec
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "component-store.hpp"
+#include "multiton.hpp"
+#include "tec-types.hpp"
+
+namespace tec {
+/// Marks a component of a ComponentView as optional. Entities lacking it still match and get a nullptr.
+template <typename T> struct Optional {};
+
+namespace detail {
+template <typename T> struct ViewArg {
+	using component_type = T;
+	static constexpr bool required = true;
+};
+template <typename T> struct ViewArg<Optional<T>> {
+	using component_type = T;
+	static constexpr bool required = false;
+};
+template <typename T> using ViewComponent = typename ViewArg<T>::component_type;
+template <typename T> using ViewStore = ComponentStore<ViewComponent<T>*>;
+} // namespace detail
+
+/**
+* \brief Joins several component stores and visits the entities that have all required components.
+*
+* The view walks the smallest store of the required components once and looks the others
+* up through their sparse index, rather than doing one map lookup per component per
+* entity. By default the view reads the Multiton<eid, T*> stores, but a system can pass
+* its own stores instead.
+*
+* ComponentView<Renderable, Optional<Position>> visits every entity with a Renderable
+* and hands over its Position or nullptr.
+*
+* Components of the viewed types must not be added or removed from inside Each().
+*/
+template <typename... Ts> class ComponentView {
+	static_assert((detail::ViewArg<Ts>::required || ...), "A ComponentView needs at least one required component");
+
+public:
+	ComponentView() : stores(&Multiton<eid, detail::ViewComponent<Ts>*>::Store()...) {}
+	explicit ComponentView(detail::ViewStore<Ts>&... _stores) : stores(&_stores...) {}
+
+	/**
+	* \brief Call fn(eid, T*...) for every entity that matches the view.
+	*
+	* \param[in] F&& fn The function to call for each match.
+	* \return void
+	*/
+	template <typename F> void Each(F&& fn) const { Each(fn, std::index_sequence_for<Ts...>{}); }
+
+	/// Get the index of the required store with the fewest components, this is the one walked by Each().
+	std::size_t GetDriverIndex() const { return GetDriverIndex(std::index_sequence_for<Ts...>{}); }
+
+private:
+	template <std::size_t... I> std::size_t GetDriverIndex(std::index_sequence<I...>) const {
+		std::size_t driver = sizeof...(Ts);
+		std::size_t smallest = std::numeric_limits<std::size_t>::max();
+		(
+				[&] {
+					if (detail::ViewArg<Ts>::required && std::get<I>(this->stores)->Size() < smallest) {
+						smallest = std::get<I>(this->stores)->Size();
+						driver = I;
+					}
+				}(),
+				...);
+		return driver;
+	}
+
+	template <typename F, std::size_t... I> void Each(F& fn, std::index_sequence<I...> seq) const {
+		const std::size_t driver = GetDriverIndex(seq);
+		((I == driver ? Walk(*std::get<I>(this->stores), fn, seq) : void()), ...);
+	}
+
+	template <typename Store, typename F, std::size_t... I>
+	void Walk(const Store& driver, F& fn, std::index_sequence<I...>) const {
+		for (const auto& entry : driver) {
+			const eid entity_id = entry.first;
+			const std::tuple<detail::ViewComponent<Ts>*...> row{Lookup<I>(entity_id)...};
+			if (((!detail::ViewArg<Ts>::required || std::get<I>(row) != nullptr) && ...)) {
+				fn(entity_id, std::get<I>(row)...);
+			}
+		}
+	}
+
+	template <std::size_t I> auto Lookup(const eid entity_id) const {
+		using Component = detail::ViewComponent<std::tuple_element_t<I, std::tuple<Ts...>>>;
+		Component* const* component = std::get<I>(this->stores)->Find(entity_id);
+		return component ? *component : static_cast<Component*>(nullptr);
+	}
+
+	std::tuple<detail::ViewStore<Ts>*...> stores;
+};
+
+/**
+* \brief A ComponentView that keeps the matching rows between calls.
+*
+* The result of the join is cached as dense indices into each store. The cache is rebuilt
+* when any of the stores gains or loses a component (see ComponentStore::GetVersion()),
+* otherwise Each() is a walk over the cached rows without any sparse lookups. Replacing
+* a component pointer without a structural change is picked up since the pointer itself
+* is read from the store on every call.
+*/
+template <typename... Ts> class CachedComponentView {
+public:
+	CachedComponentView() : view(), stores(&Multiton<eid, detail::ViewComponent<Ts>*>::Store()...) {}
+	explicit CachedComponentView(detail::ViewStore<Ts>&... _stores) : view(_stores...), stores(&_stores...) {}
+
+	/**
+	* \brief Call fn(eid, T*...) for every entity that matches the view, rebuilding the cache if stale.
+	*
+	* \param[in] F&& fn The function to call for each match.
+	* \return void
+	*/
+	template <typename F> void Each(F&& fn) {
+		if (IsStale()) {
+			Rebuild();
+		}
+		Each(fn, std::index_sequence_for<Ts...>{});
+	}
+
+	/// Drops the cached rows, the next Each() rebuilds them.
+	void Invalidate() { this->valid = false; }
+
+	bool IsStale() const { return !this->valid || this->versions != CurrentVersions(); }
+
+	std::size_t Size() const { return this->rows.size(); }
+
+private:
+	static constexpr std::uint32_t MISSING = std::numeric_limits<std::uint32_t>::max();
+	using Row = std::array<std::uint32_t, sizeof...(Ts)>; // dense index into each store
+
+	std::array<std::uint64_t, sizeof...(Ts)> CurrentVersions() const {
+		return std::apply(
+				[](auto*... store) { return std::array<std::uint64_t, sizeof...(Ts)>{store->GetVersion()...}; },
+				this->stores);
+	}
+
+	void Rebuild() { Rebuild(std::index_sequence_for<Ts...>{}); }
+
+	template <std::size_t... I> void Rebuild(std::index_sequence<I...>) {
+		this->rows.clear();
+		this->ids.clear();
+		this->view.Each([this](const eid entity_id, auto*...) {
+			Row row{};
+			((row[I] = IndexOrMissing(*std::get<I>(this->stores), entity_id)), ...);
+			this->rows.push_back(row);
+			this->ids.push_back(entity_id);
+		});
+		this->versions = CurrentVersions();
+		this->valid = true;
+	}
+
+	template <typename Store> static std::uint32_t IndexOrMissing(const Store& store, const eid entity_id) {
+		const std::size_t index = store.IndexOf(entity_id);
+		return index == Store::npos ? MISSING : static_cast<std::uint32_t>(index);
+	}
+
+	template <typename F, std::size_t... I> void Each(F& fn, std::index_sequence<I...>) {
+		for (std::size_t r = 0; r < this->rows.size(); ++r) {
+			const Row& row = this->rows[r];
+			fn(this->ids[r], (row[I] == MISSING ? nullptr : std::get<I>(this->stores)->At(row[I]).second)...);
+		}
+	}
+
+	ComponentView<Ts...> view;
+	std::tuple<detail::ViewStore<Ts>*...> stores;
+	std::vector<Row> rows;
+	std::vector<eid> ids;
+	std::array<std::uint64_t, sizeof...(Ts)> versions{};
+	bool valid{false};
+};
+} // namespace tec
@@ -1,5 +1,7 @@
 #include "collision-body.hpp"
 
+#include "collision-shape-cache.hpp"
+
 namespace tec {
 CollisionBody::CollisionBody(CollisionBody&& other) noexcept :
 		mass(other.mass), disable_deactivation(other.disable_deactivation), disable_rotation(other.disable_rotation),
@@ -45,11 +47,11 @@ void CollisionBody::Out(proto::Component* target) {
 		}
 	}
 }
-void CollisionBody::SetSphereShape(float radius) { this->shape.reset(new btSphereShape(radius)); }
+void CollisionBody::SetSphereShape(float radius) { this->shape = CollisionShapeCache::Get().GetSphere(radius); }
 void CollisionBody::SetCapsuleShape(float radius, float height) {
-	this->shape.reset(new btCapsuleShape(radius, height));
+	this->shape = CollisionShapeCache::Get().GetCapsule(radius, height);
 }
-void CollisionBody::SetBoxShape(float x, float y, float z) { this->shape.reset(new btBoxShape(btVector3(x, y, z))); }
+void CollisionBody::SetBoxShape(float x, float y, float z) { this->shape = CollisionShapeCache::Get().GetBox(x, y, z); }
 
 void CollisionBody::In(const proto::Component& source) {
 	const proto::CollisionBody& comp = source.collision_body();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include <btBulletCollisionCommon.h>
 #include <btBulletDynamicsCommon.h>
@@ -31,6 +32,10 @@ ATTRIBUTE_ALIGNED16(struct) CollisionBody {
 		void getWorldTransform(btTransform& worldTrans) const override { worldTrans = this->transform; }
 
 		void setWorldTransform(const btTransform& worldTrans) override {
+			// Bullet calls this once per substep, only report the first move since the flag was cleared
+			if (!this->transform_updated && this->moved_list) {
+				this->moved_list->push_back(entity_id);
+			}
 			this->transform_updated = true;
 			this->transform = worldTrans;
 			if (entity_id != 0) {
@@ -40,6 +45,7 @@ ATTRIBUTE_ALIGNED16(struct) CollisionBody {
 					position->value.x = origin.x();
 					position->value.y = origin.y();
 					position->value.z = origin.z();
+					PositionMap::MarkChanged(entity_id);
 				}
 				if (OrientationMap::Has(entity_id)) {
 					auto orientation = OrientationMap::Get(entity_id);
@@ -49,12 +55,14 @@ ATTRIBUTE_ALIGNED16(struct) CollisionBody {
 					orientation->value.z = rotation.z();
 					orientation->value.w = rotation.w();
 					rotation.getEulerZYX(orientation->rotation.z, orientation->rotation.y, orientation->rotation.x);
+					OrientationMap::MarkChanged(entity_id);
 				}
 			}
 		}
 
 		btTransform transform;
 		bool transform_updated = true;
+		std::vector<eid>* moved_list = nullptr; // Where the owning PhysicsSystem collects the bodies Bullet moved.
 
 	private:
 		eid& entity_id; // Stored to use when updated transform
@@ -66,6 +74,7 @@ ATTRIBUTE_ALIGNED16(struct) CollisionBody {
 
 	CollisionBody& operator=(CollisionBody&& other) noexcept;
 
+	// The shapes come from the CollisionShapeCache and are shared with other bodies of the same dimensions.
 	void SetSphereShape(float);
 	void SetCapsuleShape(float radius, float height);
 	void SetBoxShape(float, float, float);
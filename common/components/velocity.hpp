@@ -16,7 +16,7 @@ struct Velocity {
 	btVector3 GetLinear() const { return btVector3(linear.x, linear.y, linear.z); }
 	btVector3 GetAngular() const { return btVector3(angular.x, angular.y, angular.z); }
 
-	void Out(proto::Component* target) {
+	void Out(proto::Component* target) const {
 		proto::Velocity* comp = target->mutable_velocity();
 		comp->set_linear_x(this->linear.x);
 		comp->set_linear_y(this->linear.y);
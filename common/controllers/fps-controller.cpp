@@ -23,7 +23,7 @@ void FPSController::Update(const double delta, GameState& state, EventList& comm
 			Handle(mouse_move_event, state);
 		}
 		if (state.orientations.find(entity_id) != state.orientations.end()) {
-			state.orientations[entity_id] = this->orientation;
+			state.SetOrientation(entity_id, this->orientation);
 		}
 	}
 
@@ -47,8 +47,10 @@ void FPSController::Update(const double delta, GameState& state, EventList& comm
 		this->right_strafe = true;
 	}
 	
-	state.velocities[entity_id].linear =
+	Velocity velocity = state.velocities[entity_id];
+	velocity.linear =
 			glm::vec4(this->orientation.value * glm::vec3(5.0 * strafe_direction, 0.0, 7.5 * forward_direction), 1.0);
+	state.SetVelocity(entity_id, velocity);
 }
 
 proto::ClientCommands FPSController::GetClientCommands() {
@@ -107,6 +109,16 @@ void FPSController::ApplyClientCommands(proto::ClientCommands proto_client_comma
 	}
 }
 
+void FPSController::ReplayClientCommands(
+		const proto::ClientCommands& proto_client_commands, const double delta, GameState& state) {
+	// a fresh controller without focus only moves the way the command says
+	FPSController replay(this->entity_id);
+	replay.ClearFocus(true, true);
+	replay.ApplyClientCommands(proto_client_commands);
+	EventList no_events;
+	replay.Update(delta, state, no_events);
+}
+
 void FPSController::Handle(const KeyboardEvent& data, const GameState&) {
 	switch (data.action) {
 	case KeyboardEvent::KEY_DOWN:
@@ -45,6 +45,9 @@ struct Controller {
 
 	virtual void ApplyClientCommands(proto::ClientCommands) = 0;
 
+	/// \brief Run a command like the server would, leaving this controller and its live input untouched.
+	virtual void ReplayClientCommands(const proto::ClientCommands&, double, GameState&) {}
+
 	/// \brief called to indicate focus has been restored to controller
 	virtual void SetFocus(bool keyboard, bool mouse) {
 		this->keyboard_focus = keyboard || this->keyboard_focus;
@@ -135,6 +138,8 @@ struct FPSController : public Controller {
 
 	proto::ClientCommands GetClientCommands() override;
 
+	void ReplayClientCommands(const proto::ClientCommands& proto_client_commands, double delta, GameState& state) override;
+
 	bool forward{false};
 	bool backward{false};
 	bool right_strafe{false};
@@ -0,0 +1,70 @@
+#include "entity-id-allocator.hpp"
+
+#include <limits>
+
+namespace tec {
+eid EntityIdAllocator::Allocate() {
+	std::lock_guard lock(this->mutex);
+	std::uint32_t index = 0;
+	if (!this->free_indices.empty()) {
+		index = this->free_indices.front();
+		this->free_indices.pop_front();
+	}
+	else {
+		if (this->slots.size() >= std::numeric_limits<std::uint32_t>::max() - this->first_index) {
+			return 0;
+		}
+		index = this->first_index + static_cast<std::uint32_t>(this->slots.size());
+		this->slots.emplace_back();
+	}
+	Slot& slot = this->slots[index - this->first_index];
+	slot.alive = true;
+	++this->live;
+	return MakeEntityId(index, slot.generation);
+}
+
+bool EntityIdAllocator::Release(const eid entity_id) {
+	std::lock_guard lock(this->mutex);
+	const std::size_t position = FindSlot(entity_id);
+	if (position == npos) {
+		return false;
+	}
+	Slot& slot = this->slots[position];
+	slot.alive = false;
+	--this->live;
+	// A slot whose generation would wrap is retired, otherwise a very old handle could match again.
+	if (slot.generation < std::numeric_limits<std::uint32_t>::max()) {
+		++slot.generation;
+		this->free_indices.push_back(GetEntityIndex(entity_id));
+	}
+	return true;
+}
+
+bool EntityIdAllocator::IsAlive(const eid entity_id) const {
+	std::lock_guard lock(this->mutex);
+	return FindSlot(entity_id) != npos;
+}
+
+std::size_t EntityIdAllocator::GetLiveCount() const {
+	std::lock_guard lock(this->mutex);
+	return this->live;
+}
+
+std::size_t EntityIdAllocator::GetIndexCount() const {
+	std::lock_guard lock(this->mutex);
+	return this->slots.size();
+}
+
+std::size_t EntityIdAllocator::FindSlot(const eid entity_id) const {
+	const std::uint32_t index = GetEntityIndex(entity_id);
+	if (index < this->first_index || index - this->first_index >= this->slots.size()) {
+		return npos;
+	}
+	const std::size_t position = index - this->first_index;
+	const Slot& slot = this->slots[position];
+	if (!slot.alive || slot.generation != GetEntityGeneration(entity_id)) {
+		return npos;
+	}
+	return position;
+}
+} // namespace tec
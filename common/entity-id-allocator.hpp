@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "tec-types.hpp"
+
+namespace tec {
+/// Get the index part of an entity ID, this is what dense per-entity arrays are indexed by.
+constexpr std::uint32_t GetEntityIndex(const eid entity_id) { return static_cast<std::uint32_t>(entity_id); }
+
+/// Get the generation part of an entity ID, it changes every time an index is reused.
+constexpr std::uint32_t GetEntityGeneration(const eid entity_id) { return static_cast<std::uint32_t>(entity_id >> 32); }
+
+/// Pack an index and a generation into an entity ID.
+constexpr eid MakeEntityId(const std::uint32_t index, const std::uint32_t generation) {
+	return (static_cast<eid>(generation) << 32) | index;
+}
+
+/**
+* \brief Hands out entity IDs made of a 32-bit index and a 32-bit generation.
+*
+* Released indices are reused, oldest first, with their generation bumped. An ID kept
+* around after its entity was released no longer matches the slot's generation, so
+* IsAlive() reports it as stale and ComponentStore treats it as absent.
+*
+* The first generation of an index is 0, so fresh IDs are just the index and look the
+* same as the IDs handed out before recycling existed.
+*
+* All methods are thread-safe.
+*/
+class EntityIdAllocator {
+public:
+	/**
+	* \param[in] const std::uint32_t first_index The lowest index to hand out, lower ones are left
+	* for entities with fixed IDs (e.g. those loaded from a save game). Index 0 is never handed out.
+	*/
+	explicit EntityIdAllocator(const std::uint32_t first_index = 1) : first_index(first_index ? first_index : 1) {}
+
+	/**
+	* \brief Allocate a new entity ID, reusing a released index if there is one.
+	*
+	* \return eid The new entity ID or 0 if the index space is exhausted.
+	*/
+	eid Allocate();
+
+	/**
+	* \brief Release an entity ID so its index can be reused.
+	*
+	* \param[in] const eid entity_id The entity ID to release.
+	* \return bool False if the ID was stale or never allocated.
+	*/
+	bool Release(const eid entity_id);
+
+	/// Checks if the ID was allocated and not released since.
+	bool IsAlive(const eid entity_id) const;
+
+	/// Get the number of IDs currently allocated.
+	std::size_t GetLiveCount() const;
+
+	/// Get the number of indices ever handed out, an index-based array needs at most this many slots.
+	std::size_t GetIndexCount() const;
+
+private:
+	struct Slot {
+		std::uint32_t generation{0};
+		bool alive{false};
+	};
+
+	static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+	// Get the position of the slot an ID refers to, or npos if the ID isn't alive.
+	std::size_t FindSlot(const eid entity_id) const;
+
+	const std::uint32_t first_index;
+	mutable std::mutex mutex;
+	std::vector<Slot> slots; // Indexed by index - first_index.
+	std::deque<std::uint32_t> free_indices; // FIFO so a released index rests as long as possible.
+	std::size_t live{0};
+};
+} // namespace tec
@@ -2,6 +2,7 @@
 
 #include <tuple>
 
+#include "component-pool.hpp"
 #include "multiton.hpp"
 
 namespace tec {
@@ -12,7 +13,7 @@ public:
 	// Add a component with constructor arguments.
 	template <typename T, typename... U> T* Add(U&&... args) {
 		if (!Multiton<eid, T*>::Has(this->id)) {
-			T* comp = new T(std::forward<U>(args)...);
+			T* comp = ComponentPool<T>::Create(std::forward<U>(args)...);
 
 			Update(comp);
 			return comp;
@@ -23,7 +24,7 @@ public:
 	// Add multiple components at one.
 	// Returns a tuple of each added component in the order they were specified in the template.
 	template <typename... T> std::tuple<T*...> Add() {
-		int _[] = {0, (Update(new T()), 0)...};
+		int _[] = {0, (Update(ComponentPool<T>::Create()), 0)...};
 		(void)_;
 		return std::make_tuple(Multiton<eid, T*>::Get(this->id)...);
 	}
@@ -31,7 +32,7 @@ public:
 	// Add multiple components at one with constructor arguments (1 per component).
 	// Returns a tuple of each added component in the order they were specified in the template.
 	template <typename... T> std::tuple<T*...> Add(T... args) {
-		int _[] = {0, (Update(new T(args)), 0)...};
+		int _[] = {0, (Update(ComponentPool<T>::Create(args)), 0)...};
 		(void)_;
 		return std::make_tuple(Multiton<eid, T*>::Get(this->id)...);
 	}
@@ -42,11 +43,15 @@ public:
 		(void)_;
 	}
 
-	// Add a pre-made component to this entity.
+	// Add a pre-made component to this entity, it must have been created by ComponentPool<T>.
 	template <typename T> void Add(T* comp) { Update(comp); }
 
-	// Remove a specific component from this entity.
-	template <typename T> void Remove() { Multiton<eid, T*>::Remove(this->id); }
+	// Remove a specific component from this entity and return it to its pool.
+	template <typename T> void Remove() {
+		T* comp = Multiton<eid, T*>::Get(this->id);
+		Multiton<eid, T*>::Remove(this->id);
+		ComponentPool<T>::Destroy(comp);
+	}
 
 	// Checks if this entity has a specific component.
 	template <typename T> bool Has() const { return Multiton<eid, T*>::Has(this->id); }
@@ -59,10 +64,13 @@ public:
 		return std::make_tuple(Multiton<eid, T*>::Get(this->id)...);
 	}
 
-	// Sets a component to the provided component.
+	// Sets a component to the provided component, the previous one is returned to its pool.
 	template <typename T> void Update(T* val) {
-		delete Multiton<eid, T*>::Get(this->id);
+		T* old = Multiton<eid, T*>::Get(this->id);
 		Multiton<eid, T*>::Set(this->id, val);
+		if (old != val) {
+			ComponentPool<T>::Destroy(old);
+		}
 	}
 
 	// Get the entity id.
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+#include "mpsc-ring.hpp"
+#include "queue-instrumentation.hpp"
+#include "tec-types.hpp"
+
+namespace tec {
+template <class T> class BufferedEventQueue;
+
+/**
+* \brief Allocation-free counterpart of EventSystem for small, frequent events.
+*
+* Payloads are copied by value into a ring owned by each subscriber instead of being
+* shared through a std::shared_ptr, and subscribers live in one flat table, so emitting
+* in steady state takes no heap allocation and no map lookup. EmitMany() hands a whole
+* burst over in one pass over the table.
+*
+* Subscribe by deriving from BufferedEventQueue<T>; its On() is called from
+* ProcessEventQueue() in emit order, the same way EventQueue<T> dispatches. Emitting
+* is thread-safe.
+*/
+template <class T> class EventBus final {
+public:
+	// Never destroyed, so subscribers going away during static destruction don't outlive it.
+	static EventBus& Get() {
+		static EventBus* instance = new EventBus();
+		return *instance;
+	}
+
+	/// Emits an event to the subscribers of the given entity_id and those of every entity.
+	void Emit(const eid entity_id, const T& data) {
+		if constexpr (QUEUE_INSTRUMENTATION) {
+			QueueInstrument::ForEvent<T>().CountEmitted();
+		}
+		std::shared_lock lock(this->subscribers_mutex);
+		for (const Subscription& subscription : this->subscribers) {
+			if (subscription.entity_id == 0 || subscription.entity_id == entity_id) {
+				subscription.subscriber->QueueEvent(entity_id, data);
+			}
+		}
+	}
+
+	/// Emits an event to the subscribers of every entity.
+	void Emit(const T& data) { Emit(0, data); }
+
+	/**
+	* \brief Emits a batch of events to the subscribers of every entity.
+	*
+	* \param[in] const T* data The first event of the batch.
+	* \param[in] const std::size_t count The number of events in the batch.
+	*/
+	void EmitMany(const T* data, const std::size_t count) {
+		if constexpr (QUEUE_INSTRUMENTATION) {
+			QueueInstrument::ForEvent<T>().CountEmitted(count);
+		}
+		std::shared_lock lock(this->subscribers_mutex);
+		for (const Subscription& subscription : this->subscribers) {
+			if (subscription.entity_id == 0) {
+				for (std::size_t i = 0; i < count; ++i) {
+					subscription.subscriber->QueueEvent(0, data[i]);
+				}
+			}
+		}
+	}
+
+	void EmitMany(const std::vector<T>& data) { EmitMany(data.data(), data.size()); }
+
+private:
+	friend class BufferedEventQueue<T>;
+
+	struct Subscription {
+		eid entity_id; // 0 for every entity.
+		BufferedEventQueue<T>* subscriber;
+	};
+
+	EventBus() = default;
+
+	void Subscribe(const eid entity_id, BufferedEventQueue<T>* subscriber) {
+		std::unique_lock lock(this->subscribers_mutex);
+		this->subscribers.push_back(Subscription{entity_id, subscriber});
+	}
+
+	void Unsubscribe(BufferedEventQueue<T>* subscriber) {
+		std::unique_lock lock(this->subscribers_mutex);
+		this->subscribers.erase(
+				std::remove_if(
+						this->subscribers.begin(),
+						this->subscribers.end(),
+						[subscriber](const Subscription& subscription) { return subscription.subscriber == subscriber; }),
+				this->subscribers.end());
+	}
+
+	std::shared_mutex subscribers_mutex;
+	std::vector<Subscription> subscribers;
+};
+
+/**
+* \brief Subscriber side of EventBus<T>, the by-value counterpart of EventQueue<T>.
+*
+* Events wait in a fixed size ring until ProcessEventQueue() hands them to On(). A burst
+* bigger than the ring spills into an overflow buffer (OverflowPolicy::GROW), so nothing
+* is lost and events from one thread are always handled in the order they were emitted.
+*
+* As with EventQueue, qualify ProcessEventQueue() with the base class and template type.
+*/
+template <class T> class BufferedEventQueue {
+public:
+	static constexpr std::size_t DEFAULT_CAPACITY = 1024;
+
+	explicit BufferedEventQueue(const std::size_t capacity = DEFAULT_CAPACITY) : queue(capacity) {
+		EventBus<T>::Get().Subscribe(0, this);
+	}
+	// Causes subscribing to events for only a specific entity_id.
+	BufferedEventQueue(const eid entity_id, const std::size_t capacity) : queue(capacity) {
+		EventBus<T>::Get().Subscribe(entity_id, this);
+	}
+	BufferedEventQueue(const BufferedEventQueue&) = delete;
+	BufferedEventQueue& operator=(const BufferedEventQueue&) = delete;
+	virtual ~BufferedEventQueue() { EventBus<T>::Get().Unsubscribe(this); }
+
+	void ProcessEventQueue() {
+		const std::size_t count = this->queue.ConsumeAll([this](BusEvent&& e) {
+			if constexpr (QUEUE_INSTRUMENTATION) {
+				QueueInstrument::ForEvent<T>().CountHandled(e.queued_at);
+			}
+			this->On(e.entity_id, e.data);
+		});
+		if constexpr (QUEUE_INSTRUMENTATION) {
+			QueueInstrument::ForEvent<T>().CountDrained(count);
+		}
+	}
+
+	void QueueEvent(const eid entity_id, const T& data) {
+		if constexpr (QUEUE_INSTRUMENTATION) {
+			QueueInstrument::ForEvent<T>().CountQueued();
+		}
+		this->queue.Push(BusEvent{entity_id, data, QueueTimestamp{}});
+	}
+
+	virtual void On(const eid, const T&) {}
+
+private:
+	struct BusEvent {
+		eid entity_id{0};
+		T data{};
+		[[no_unique_address]] QueueTimestamp queued_at;
+	};
+
+	BoundedMPSCQueue<BusEvent> queue;
+};
+} // namespace tec
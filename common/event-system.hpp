@@ -1,11 +1,13 @@
 #pragma once
 
-#include <list>
-#include <map>
+#include <algorithm>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <vector>
 
 #include "event-queue.hpp"
+#include "queue-instrumentation.hpp"
 #include "tec-types.hpp"
 
 namespace tec {
@@ -39,21 +41,13 @@ public:
 	* \return void
 	*/
 	void Subscribe(const eid entity_id, EventQueue<T>* subscriber) {
-		auto subs = this->subscribers.find(entity_id);
-		if (subs == this->subscribers.end()) {
-			// no subscriptions for entity, add the entity and subscriber
-			this->subscribers[entity_id].push_back(subscriber);
-			return;
-		}
-		else {
-			// check if subscriber already exists
-			for (auto sub : subs->second) {
-				if (sub == subscriber) {
-					return; // already subscribed
-				}
+		std::unique_lock lock(this->subscribers_mutex);
+		for (const Subscription& subscription : this->subscribers) {
+			if (subscription.entity_id == entity_id && subscription.subscriber == subscriber) {
+				return; // already subscribed
 			}
-			subs->second.push_back(subscriber);
 		}
+		this->subscribers.push_back(Subscription{entity_id, subscriber});
 	}
 
 	/**
@@ -62,7 +56,10 @@ public:
 	* \param const Receiver<T>* subscriber The subscriber to add.
 	* \return void
 	*/
-	void Subscribe(EventQueue<T>* subscriber) { this->subscribers[0].push_back(subscriber); }
+	void Subscribe(EventQueue<T>* subscriber) {
+		std::unique_lock lock(this->subscribers_mutex);
+		this->subscribers.push_back(Subscription{0, subscriber});
+	}
 
 	/**
 	* \brief Unsubscribes to notification of events.
@@ -72,9 +69,15 @@ public:
 	* \return void
 	*/
 	void Unsubscribe(const eid entity_id, EventQueue<T>* subscriber) {
-		if (this->subscribers.find(entity_id) != this->subscribers.end()) {
-			this->subscribers[entity_id].remove(subscriber);
-		}
+		std::unique_lock lock(this->subscribers_mutex);
+		this->subscribers.erase(
+				std::remove_if(
+						this->subscribers.begin(),
+						this->subscribers.end(),
+						[entity_id, subscriber](const Subscription& subscription) {
+							return subscription.entity_id == entity_id && subscription.subscriber == subscriber;
+						}),
+				this->subscribers.end());
 	}
 
 	/**
@@ -83,11 +86,7 @@ public:
 	* \param const Receiver<T>* subscriber The subscriber to remove.
 	* \return void
 	*/
-	void Unsubscribe(EventQueue<T>* subscriber) {
-		if (this->subscribers.find(0) != this->subscribers.end()) {
-			this->subscribers[0].remove(subscriber);
-		}
-	}
+	void Unsubscribe(EventQueue<T>* subscriber) { Unsubscribe(0, subscriber); }
 
 	/**
 	* \brief Emits an event to subscribers for a given entity_id and to all
@@ -98,22 +97,14 @@ public:
 	* \return void
 	*/
 	void Emit(const eid entity_id, std::shared_ptr<T> data) {
-		if (0 != entity_id) { // don't trigger events twice if someone specified zero
-			auto sub_iter = this->subscribers.find(entity_id);
-			if (sub_iter != this->subscribers.end()) {
-				auto subscriber_list = sub_iter->second;
-				for (EventQueue<T>* subscriber : subscriber_list) {
-					Event<T> e(entity_id, data);
-					subscriber->QueueEvent(std::move(e));
-				}
-			}
+		if constexpr (QUEUE_INSTRUMENTATION) {
+			QueueInstrument::ForEvent<T>().CountEmitted();
 		}
-		auto sub_iter = this->subscribers.find(0);
-		if (sub_iter != this->subscribers.end()) {
-			auto subscriber_list = sub_iter->second;
-			for (EventQueue<T>* subscriber : subscriber_list) {
-				Event<T> e(entity_id, data);
-				subscriber->QueueEvent(std::move(e));
+		std::shared_lock lock(this->subscribers_mutex);
+		// a subscriber of entity 0 hears about every entity, so zero never triggers an event twice
+		for (const Subscription& subscription : this->subscribers) {
+			if (subscription.entity_id == 0 || subscription.entity_id == entity_id) {
+				subscription.subscriber->QueueEvent(Event<T>(entity_id, data));
 			}
 		}
 	}
@@ -126,8 +117,36 @@ public:
 	*/
 	void Emit(std::shared_ptr<T> data) { Emit(0, data); }
 
+	/**
+	* \brief Emits a batch of events to all subscribers listening for events for any entity_id.
+	*
+	* Cheaper than emitting them one by one when loading many entities at once.
+	* \param const std::vector<std::shared_ptr<T>>& batch The events to emit, in order.
+	* \return void
+	*/
+	void EmitMany(const std::vector<std::shared_ptr<T>>& batch) {
+		if constexpr (QUEUE_INSTRUMENTATION) {
+			QueueInstrument::ForEvent<T>().CountEmitted(batch.size());
+		}
+		std::shared_lock lock(this->subscribers_mutex);
+		for (const Subscription& subscription : this->subscribers) {
+			if (subscription.entity_id == 0) {
+				for (const auto& data : batch) {
+					subscription.subscriber->QueueEvent(Event<T>(0, data));
+				}
+			}
+		}
+	}
+
 private:
-	std::map<eid, std::list<EventQueue<T>*>> subscribers;
+	struct Subscription {
+		eid entity_id; // 0 for every entity.
+		EventQueue<T>* subscriber;
+	};
+
+	std::shared_mutex subscribers_mutex;
+	// A flat table, there are only ever a handful of subscribers per event type.
+	std::vector<Subscription> subscribers;
 };
 
 template <typename T> std::once_flag EventSystem<T>::only_one;
@@ -128,10 +128,10 @@ struct UserLoginEvent {
 
 struct PlayerInteractionEvent {
 	std::string identifier;
-	int entity_id;
+	eid entity_id;
 	std::string interaction_type;
 	PlayerInteractionEvent() = default;
-	PlayerInteractionEvent(const std::string& identifier, int entity_id, const std::string& interaction_type)
+	PlayerInteractionEvent(const std::string& identifier, eid entity_id, const std::string& interaction_type)
 		: identifier(identifier), entity_id(entity_id), interaction_type(interaction_type) {}
 };
 
@@ -0,0 +1,289 @@
+#include "flat-game-state.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace tec {
+void FlatGameState::Clear() {
+	this->entity_ids.clear();
+	this->present.clear();
+	this->positions.clear();
+	this->orientations.clear();
+	this->velocities.clear();
+}
+
+void FlatGameState::Reserve(const std::size_t count) {
+	this->entity_ids.reserve(count);
+	this->present.reserve(count);
+	this->positions.reserve(count);
+	this->orientations.reserve(count);
+	this->velocities.reserve(count);
+}
+
+std::size_t FlatGameState::Find(const eid entity_id) const {
+	const auto itr = std::lower_bound(this->entity_ids.begin(), this->entity_ids.end(), entity_id);
+	if (itr == this->entity_ids.end() || *itr != entity_id) {
+		return npos;
+	}
+	return static_cast<std::size_t>(itr - this->entity_ids.begin());
+}
+
+void FlatGameState::Append(const eid entity_id) {
+	this->entity_ids.push_back(entity_id);
+	this->present.push_back(0);
+	this->positions.emplace_back();
+	this->orientations.emplace_back();
+	this->velocities.emplace_back();
+}
+
+std::size_t FlatGameState::FindOrInsert(const eid entity_id) {
+	if (this->entity_ids.empty() || this->entity_ids.back() < entity_id) {
+		Append(entity_id);
+		return this->entity_ids.size() - 1;
+	}
+	const auto itr = std::lower_bound(this->entity_ids.begin(), this->entity_ids.end(), entity_id);
+	const auto index = itr - this->entity_ids.begin();
+	if (*itr != entity_id) {
+		this->entity_ids.insert(itr, entity_id);
+		this->present.insert(this->present.begin() + index, 0);
+		this->positions.emplace(this->positions.begin() + index);
+		this->orientations.emplace(this->orientations.begin() + index);
+		this->velocities.emplace(this->velocities.begin() + index);
+	}
+	return static_cast<std::size_t>(index);
+}
+
+void FlatGameState::SetPosition(const eid entity_id, const Position& position) {
+	const std::size_t index = FindOrInsert(entity_id);
+	this->positions[index] = position;
+	this->present[index] |= HAS_POSITION;
+}
+
+void FlatGameState::SetOrientation(const eid entity_id, const Orientation& orientation) {
+	const std::size_t index = FindOrInsert(entity_id);
+	this->orientations[index] = orientation;
+	this->present[index] |= HAS_ORIENTATION;
+}
+
+void FlatGameState::SetVelocity(const eid entity_id, const Velocity& velocity) {
+	const std::size_t index = FindOrInsert(entity_id);
+	this->velocities[index] = velocity;
+	this->present[index] |= HAS_VELOCITY;
+}
+
+void FlatGameState::RemoveEntity(const eid entity_id) {
+	const std::size_t index = Find(entity_id);
+	if (index == npos) {
+		return;
+	}
+	this->entity_ids.erase(this->entity_ids.begin() + index);
+	this->present.erase(this->present.begin() + index);
+	this->positions.erase(this->positions.begin() + index);
+	this->orientations.erase(this->orientations.begin() + index);
+	this->velocities.erase(this->velocities.begin() + index);
+}
+
+namespace {
+// Copies the components of newer[from] that it holds over state[to].
+void OverlayComponents(FlatGameState& state, const std::size_t to, const FlatGameState& newer, const std::size_t from) {
+	const std::uint8_t mask = newer.present[from];
+	if (mask & FlatGameState::HAS_POSITION) {
+		state.positions[to] = newer.positions[from];
+	}
+	if (mask & FlatGameState::HAS_ORIENTATION) {
+		state.orientations[to] = newer.orientations[from];
+	}
+	if (mask & FlatGameState::HAS_VELOCITY) {
+		state.velocities[to] = newer.velocities[from];
+	}
+	state.present[to] |= mask;
+}
+} // namespace
+
+void FlatGameState::Merge(const FlatGameState& newer) {
+	this->state_id = newer.state_id;
+	this->command_id = newer.command_id;
+	this->timestamp = newer.timestamp;
+	if (this->entity_ids.empty()) {
+		this->entity_ids = newer.entity_ids;
+		this->present = newer.present;
+		this->positions = newer.positions;
+		this->orientations = newer.orientations;
+		this->velocities = newer.velocities;
+		return;
+	}
+
+	std::size_t added = 0;
+	MergeJoin(*this, newer, [&added](eid, const std::size_t i, std::size_t) { added += i == npos; });
+	if (added == 0) {
+		// the common case of an update for entities we already have, overwrite in place
+		MergeJoin(*this, newer, [this, &newer](eid, const std::size_t i, const std::size_t j) {
+			if (j != npos) {
+				OverlayComponents(*this, i, newer, j);
+			}
+		});
+		return;
+	}
+
+	FlatGameState merged;
+	merged.Reserve(this->Size() + added);
+	MergeJoin(*this, newer, [this, &newer, &merged](const eid entity_id, const std::size_t i, const std::size_t j) {
+		const std::size_t index = merged.Size();
+		if (i != npos) {
+			merged.entity_ids.push_back(entity_id);
+			merged.present.push_back(this->present[i]);
+			merged.positions.push_back(this->positions[i]);
+			merged.orientations.push_back(this->orientations[i]);
+			merged.velocities.push_back(this->velocities[i]);
+		}
+		else {
+			merged.Append(entity_id);
+		}
+		if (j != npos) {
+			OverlayComponents(merged, index, newer, j);
+		}
+	});
+	this->entity_ids = std::move(merged.entity_ids);
+	this->present = std::move(merged.present);
+	this->positions = std::move(merged.positions);
+	this->orientations = std::move(merged.orientations);
+	this->velocities = std::move(merged.velocities);
+}
+
+FlatGameState FlatGameState::From(const GameState& state) {
+	FlatGameState flat;
+	std::vector<eid> ids;
+	ids.reserve(state.positions.size() + state.orientations.size() + state.velocities.size());
+	for (const auto& [entity_id, _] : state.positions) {
+		ids.push_back(entity_id);
+	}
+	for (const auto& [entity_id, _] : state.orientations) {
+		ids.push_back(entity_id);
+	}
+	for (const auto& [entity_id, _] : state.velocities) {
+		ids.push_back(entity_id);
+	}
+	std::sort(ids.begin(), ids.end());
+	ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+	flat.Reserve(ids.size());
+	for (const eid entity_id : ids) {
+		const std::size_t index = flat.Size();
+		flat.Append(entity_id);
+		if (const auto itr = state.positions.find(entity_id); itr != state.positions.end()) {
+			flat.positions[index] = itr->second;
+			flat.present[index] |= HAS_POSITION;
+		}
+		if (const auto itr = state.orientations.find(entity_id); itr != state.orientations.end()) {
+			flat.orientations[index] = itr->second;
+			flat.present[index] |= HAS_ORIENTATION;
+		}
+		if (const auto itr = state.velocities.find(entity_id); itr != state.velocities.end()) {
+			flat.velocities[index] = itr->second;
+			flat.present[index] |= HAS_VELOCITY;
+		}
+	}
+	flat.state_id = state.state_id;
+	flat.command_id = state.command_id;
+	flat.timestamp = state.timestamp;
+	return flat;
+}
+
+GameState FlatGameState::ToGameState() const {
+	GameState state;
+	state.positions.reserve(Size());
+	state.orientations.reserve(Size());
+	state.velocities.reserve(Size());
+	for (std::size_t i = 0; i < Size(); ++i) {
+		const eid entity_id = this->entity_ids[i];
+		if (this->present[i] & HAS_POSITION) {
+			state.positions.emplace(entity_id, this->positions[i]);
+		}
+		if (this->present[i] & HAS_ORIENTATION) {
+			state.orientations.emplace(entity_id, this->orientations[i]);
+		}
+		if (this->present[i] & HAS_VELOCITY) {
+			state.velocities.emplace(entity_id, this->velocities[i]);
+		}
+	}
+	state.state_id = this->state_id;
+	state.command_id = this->command_id;
+	state.timestamp = this->timestamp;
+	return state;
+}
+
+void FlatGameState::In(const proto::GameStateUpdate& gsu) {
+	// sort the update by id so it joins with this state in a single pass
+	std::vector<std::pair<eid, int>> order;
+	order.reserve(gsu.entity_size());
+	for (int e = 0; e < gsu.entity_size(); ++e) {
+		order.emplace_back(gsu.entity(e).id(), e);
+	}
+	std::stable_sort(order.begin(), order.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+	FlatGameState update;
+	update.Reserve(order.size());
+	for (const auto& [entity_id, e] : order) {
+		if (update.entity_ids.empty() || update.entity_ids.back() != entity_id) {
+			update.Append(entity_id);
+		}
+		const std::size_t index = update.Size() - 1;
+		const proto::Entity& entity = gsu.entity(e);
+		for (int i = 0; i < entity.components_size(); ++i) {
+			const proto::Component& comp = entity.components(i);
+			switch (comp.component_case()) {
+			case proto::Component::kPosition:
+			{
+				Position pos;
+				pos.In(comp);
+				update.positions[index] = pos;
+				update.present[index] |= HAS_POSITION;
+			} break;
+			case proto::Component::kOrientation:
+			{
+				Orientation orientation;
+				orientation.In(comp);
+				update.orientations[index] = orientation;
+				update.present[index] |= HAS_ORIENTATION;
+			} break;
+			case proto::Component::kVelocity:
+			{
+				Velocity vel;
+				vel.In(comp);
+				update.velocities[index] = vel;
+				update.present[index] |= HAS_VELOCITY;
+			} break;
+			default:
+				// intentionally not handling other cases.
+				break;
+			}
+		}
+	}
+	update.state_id = gsu.state_id();
+	update.command_id = gsu.command_id();
+	update.timestamp = gsu.timestamp();
+	Merge(update);
+}
+
+void FlatGameState::Out(proto::GameStateUpdate* gsu) const {
+	gsu->set_state_id(this->state_id);
+	gsu->set_timestamp(this->timestamp);
+	gsu->mutable_entity()->Reserve(static_cast<int>(Size()));
+	for (std::size_t i = 0; i < Size(); ++i) {
+		// like GameState::Out(), entities are only sent along with a position
+		if (!(this->present[i] & HAS_POSITION)) {
+			continue;
+		}
+		proto::Entity* entity = gsu->add_entity();
+		entity->set_id(this->entity_ids[i]);
+		this->positions[i].Out(entity->add_components());
+		if (this->present[i] & HAS_ORIENTATION) {
+			this->orientations[i].Out(entity->add_components());
+		}
+		if (this->present[i] & HAS_VELOCITY) {
+			Velocity vel = this->velocities[i];
+			vel.Out(entity->add_components());
+		}
+	}
+}
+} // namespace tec
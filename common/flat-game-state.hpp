@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <game_state.pb.h>
+
+#include "components/transforms.hpp"
+#include "components/velocity.hpp"
+#include "game-state.hpp"
+#include "tec-types.hpp"
+
+namespace tec {
+/**
+* \brief A GameState laid out as parallel arrays sorted by entity id.
+*
+* Entity i has the id entity_ids[i] and its components at index i of positions, orientations
+* and velocities, present[i] says which of those hold a value. The arrays only hold trivially
+* copyable types, so copying a state is a handful of memcpys, and two states are combined
+* with a single merge-join pass rather than a hash lookup per entity.
+*
+* Keep ids sorted by going through the Set* methods, or build a whole state at once with
+* From() or In(). Set* inserting in the middle is O(n), appending a larger id is O(1).
+*/
+struct FlatGameState {
+	enum ComponentMask : std::uint8_t {
+		HAS_POSITION = 1 << 0,
+		HAS_ORIENTATION = 1 << 1,
+		HAS_VELOCITY = 1 << 2,
+	};
+
+	static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+	std::vector<eid> entity_ids;
+	std::vector<std::uint8_t> present; // ComponentMask bits of each entity.
+	std::vector<Position> positions;
+	std::vector<Orientation> orientations;
+	std::vector<Velocity> velocities;
+
+	state_id_t state_id = 0;
+	state_id_t command_id = 0;
+	uint64_t timestamp = 0;
+
+	std::size_t Size() const { return this->entity_ids.size(); }
+
+	void Clear();
+
+	void Reserve(std::size_t count);
+
+	/// Index of entity_id in the arrays, or npos if the state doesn't hold it.
+	std::size_t Find(eid entity_id) const;
+
+	const Position* GetPosition(eid entity_id) const { return Get(entity_id, HAS_POSITION, this->positions); }
+	const Orientation* GetOrientation(eid entity_id) const {
+		return Get(entity_id, HAS_ORIENTATION, this->orientations);
+	}
+	const Velocity* GetVelocity(eid entity_id) const { return Get(entity_id, HAS_VELOCITY, this->velocities); }
+
+	void SetPosition(eid entity_id, const Position& position);
+	void SetOrientation(eid entity_id, const Orientation& orientation);
+	void SetVelocity(eid entity_id, const Velocity& velocity);
+
+	/// Removes all of the entity's components from this state.
+	void RemoveEntity(eid entity_id);
+
+	/**
+	* \brief Overlay newer on this state.
+	*
+	* Entities only in newer are added, and every component newer holds replaces the one
+	* in this state. Components newer lacks are kept, the way GameState::In() applies an update.
+	*/
+	void Merge(const FlatGameState& newer);
+
+	/**
+	* \brief Walks the union of the entities of a and b in id order.
+	*
+	* \param[in] fn Called as fn(eid, std::size_t index_in_a, std::size_t index_in_b), an
+	* index is npos when that state doesn't hold the entity.
+	*/
+	template <typename F> static void MergeJoin(const FlatGameState& a, const FlatGameState& b, F&& fn) {
+		std::size_t i = 0, j = 0;
+		const std::size_t a_size = a.Size(), b_size = b.Size();
+		while (i < a_size && j < b_size) {
+			const eid a_id = a.entity_ids[i], b_id = b.entity_ids[j];
+			if (a_id < b_id) {
+				fn(a_id, i++, npos);
+			}
+			else if (b_id < a_id) {
+				fn(b_id, npos, j++);
+			}
+			else {
+				fn(a_id, i++, j++);
+			}
+		}
+		for (; i < a_size; ++i) {
+			fn(a.entity_ids[i], i, npos);
+		}
+		for (; j < b_size; ++j) {
+			fn(b.entity_ids[j], npos, j);
+		}
+	}
+
+	static FlatGameState From(const GameState& state);
+	GameState ToGameState() const;
+
+	void In(const proto::GameStateUpdate& gsu);
+	void Out(proto::GameStateUpdate* gsu) const;
+
+private:
+	template <typename T>
+	const T* Get(const eid entity_id, const std::uint8_t mask, const std::vector<T>& components) const {
+		const std::size_t index = Find(entity_id);
+		return index != npos && (this->present[index] & mask) ? &components[index] : nullptr;
+	}
+
+	// Index of entity_id, inserting an entity without components in id order if missing.
+	std::size_t FindOrInsert(eid entity_id);
+	// Appends an entity with a larger id than any held, without components.
+	void Append(eid entity_id);
+};
+
+static_assert(std::is_trivially_copyable_v<Position>);
+static_assert(std::is_trivially_copyable_v<Orientation>);
+static_assert(std::is_trivially_copyable_v<Velocity>);
+} // namespace tec
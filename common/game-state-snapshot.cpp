@@ -0,0 +1,237 @@
+#include "game-state-snapshot.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace tec {
+namespace {
+constexpr std::uint32_t PageOf(const eid entity_id) {
+	return GetEntityIndex(entity_id) >> GameStateSnapshot::PAGE_BITS;
+}
+constexpr std::uint32_t DirectoryOf(const eid entity_id) {
+	return PageOf(entity_id) >> GameStateSnapshot::DIRECTORY_BITS;
+}
+constexpr std::uint32_t PageInDirectory(const eid entity_id) {
+	return PageOf(entity_id) & (GameStateSnapshot::DIRECTORY_SIZE - 1);
+}
+constexpr std::uint32_t SlotInPage(const eid entity_id) {
+	return GetEntityIndex(entity_id) & (GameStateSnapshot::PAGE_SIZE - 1);
+}
+} // namespace
+
+const GameStateSnapshot::Entry* GameStateSnapshot::Find(const eid entity_id) const {
+	const std::uint32_t directory = DirectoryOf(entity_id);
+	if (directory >= this->directories.size() || !this->directories[directory]) {
+		return nullptr;
+	}
+	const auto& page = this->directories[directory]->pages[PageInDirectory(entity_id)];
+	if (!page) {
+		return nullptr;
+	}
+	const Entry& entry = page->entries[SlotInPage(entity_id)];
+	return entry.present && entry.entity_id == entity_id ? &entry : nullptr;
+}
+
+GameState GameStateSnapshot::ToGameState() const {
+	GameState state;
+	state.positions.reserve(this->count);
+	state.orientations.reserve(this->count);
+	state.velocities.reserve(this->count);
+	ForEach([&state](const Entry& entry) {
+		if (entry.present & FlatGameState::HAS_POSITION) {
+			state.positions.emplace(entry.entity_id, entry.position);
+		}
+		if (entry.present & FlatGameState::HAS_ORIENTATION) {
+			state.orientations.emplace(entry.entity_id, entry.orientation);
+		}
+		if (entry.present & FlatGameState::HAS_VELOCITY) {
+			state.velocities.emplace(entry.entity_id, entry.velocity);
+		}
+	});
+	state.state_id = this->state_id;
+	state.command_id = this->command_id;
+	state.timestamp = this->timestamp;
+	return state;
+}
+
+std::size_t GameStateSnapshot::CountSharedPages(const GameStateSnapshot& other) const {
+	std::size_t shared = 0;
+	const std::size_t directories = std::min(this->directories.size(), other.directories.size());
+	for (std::size_t d = 0; d < directories; ++d) {
+		const auto& mine = this->directories[d];
+		const auto& theirs = other.directories[d];
+		if (!mine || !theirs) {
+			continue;
+		}
+		for (std::size_t p = 0; p < DIRECTORY_SIZE; ++p) {
+			shared += mine->pages[p] && mine->pages[p] == theirs->pages[p];
+		}
+	}
+	return shared;
+}
+
+GameStateSnapshot::Builder::Builder(const GameStateSnapshot& base) : snapshot(base) {
+	this->snapshot.version = base.version + 1;
+}
+
+GameStateSnapshot::Entry& GameStateSnapshot::Builder::Write(const eid entity_id) {
+	auto& directories = this->snapshot.directories;
+	const std::uint32_t d = DirectoryOf(entity_id);
+	if (d >= directories.size()) {
+		directories.resize(d + 1);
+	}
+	// Pages and directories are const once shared, the ones in owned were made by this
+	// builder and aren't visible to any snapshot yet, so writing to them is fine.
+	if (!this->owned.count(directories[d].get())) {
+		auto copy = directories[d] ? std::make_shared<Directory>(*directories[d]) : std::make_shared<Directory>();
+		this->owned.insert(copy.get());
+		directories[d] = std::move(copy);
+	}
+	auto& directory = const_cast<Directory&>(*directories[d]);
+	auto& page = directory.pages[PageInDirectory(entity_id)];
+	if (!this->owned.count(page.get())) {
+		auto copy = page ? std::make_shared<Page>(*page) : std::make_shared<Page>();
+		this->owned.insert(copy.get());
+		page = std::move(copy);
+	}
+	auto& writable_page = const_cast<Page&>(*page);
+	Entry& entry = writable_page.entries[SlotInPage(entity_id)];
+	if (!entry.present || entry.entity_id != entity_id) {
+		// an empty slot, or one still holding a released entity with the same index
+		if (!entry.present) {
+			++writable_page.count;
+			++this->snapshot.count;
+		}
+		entry = Entry{};
+		entry.entity_id = entity_id;
+	}
+	return entry;
+}
+
+void GameStateSnapshot::Builder::SetPosition(const eid entity_id, const Position& position) {
+	Entry& entry = Write(entity_id);
+	entry.position = position;
+	entry.present |= FlatGameState::HAS_POSITION;
+}
+
+void GameStateSnapshot::Builder::SetOrientation(const eid entity_id, const Orientation& orientation) {
+	Entry& entry = Write(entity_id);
+	entry.orientation = orientation;
+	entry.present |= FlatGameState::HAS_ORIENTATION;
+}
+
+void GameStateSnapshot::Builder::SetVelocity(const eid entity_id, const Velocity& velocity) {
+	Entry& entry = Write(entity_id);
+	entry.velocity = velocity;
+	entry.present |= FlatGameState::HAS_VELOCITY;
+}
+
+void GameStateSnapshot::Builder::Remove(const eid entity_id, const std::uint8_t mask) {
+	const Entry* existing = this->snapshot.Find(entity_id);
+	if (!existing || !(existing->present & mask)) {
+		return; // nothing to remove, don't copy the page
+	}
+	Entry& entry = Write(entity_id);
+	entry.present &= static_cast<std::uint8_t>(~mask);
+	if (!entry.present) {
+		entry = Entry{};
+		// Write() made both of these ours
+		auto& directory = const_cast<Directory&>(*this->snapshot.directories[DirectoryOf(entity_id)]);
+		auto& page = directory.pages[PageInDirectory(entity_id)];
+		auto& writable_page = const_cast<Page&>(*page);
+		--this->snapshot.count;
+		if (--writable_page.count == 0) {
+			this->owned.erase(page.get());
+			page.reset();
+		}
+	}
+}
+
+void GameStateSnapshot::Builder::Clear() {
+	this->snapshot.directories.clear();
+	this->snapshot.count = 0;
+	this->owned.clear();
+}
+
+GameStateSnapshot GameStateSnapshot::Builder::Build() {
+	this->owned.clear();
+	GameStateSnapshot built = std::move(this->snapshot);
+	this->snapshot = GameStateSnapshot();
+	return built;
+}
+
+const GameStateSnapshot& GameStateHistory::Capture(const GameState& state) {
+	const GameStateSnapshot* latest = Latest();
+	GameStateSnapshot::Builder builder = latest ? GameStateSnapshot::Builder(*latest) : GameStateSnapshot::Builder();
+
+	const GameStateChanges* changes = state.changes.get();
+	const bool incremental = latest && changes && changes->positions.IsValid(this->position_cursor)
+							 && changes->orientations.IsValid(this->orientation_cursor)
+							 && changes->velocities.IsValid(this->velocity_cursor);
+	if (incremental) {
+		changes->positions.ForEachChanged(this->position_cursor, [&state, &builder](const eid entity_id) {
+			const auto itr = state.positions.find(entity_id);
+			if (itr != state.positions.end()) {
+				builder.SetPosition(entity_id, itr->second);
+			}
+			else {
+				builder.RemovePosition(entity_id);
+			}
+		});
+		changes->orientations.ForEachChanged(this->orientation_cursor, [&state, &builder](const eid entity_id) {
+			const auto itr = state.orientations.find(entity_id);
+			if (itr != state.orientations.end()) {
+				builder.SetOrientation(entity_id, itr->second);
+			}
+			else {
+				builder.RemoveOrientation(entity_id);
+			}
+		});
+		changes->velocities.ForEachChanged(this->velocity_cursor, [&state, &builder](const eid entity_id) {
+			const auto itr = state.velocities.find(entity_id);
+			if (itr != state.velocities.end()) {
+				builder.SetVelocity(entity_id, itr->second);
+			}
+			else {
+				builder.RemoveVelocity(entity_id);
+			}
+		});
+	}
+	else {
+		builder.Clear();
+		for (const auto& [entity_id, position] : state.positions) {
+			builder.SetPosition(entity_id, position);
+		}
+		for (const auto& [entity_id, orientation] : state.orientations) {
+			builder.SetOrientation(entity_id, orientation);
+		}
+		for (const auto& [entity_id, velocity] : state.velocities) {
+			builder.SetVelocity(entity_id, velocity);
+		}
+		if (changes) {
+			this->position_cursor = changes->positions.GetCursor();
+			this->orientation_cursor = changes->orientations.GetCursor();
+			this->velocity_cursor = changes->velocities.GetCursor();
+		}
+	}
+
+	GameStateSnapshot snapshot = builder.Build();
+	snapshot.state_id = state.state_id;
+	snapshot.command_id = state.command_id;
+	snapshot.timestamp = state.timestamp;
+	if (this->snapshots.size() == this->capacity) {
+		this->snapshots.pop_front();
+	}
+	this->snapshots.push_back(std::move(snapshot));
+	return this->snapshots.back();
+}
+
+const GameStateSnapshot* GameStateHistory::Find(const state_id_t state_id) const {
+	for (auto itr = this->snapshots.rbegin(); itr != this->snapshots.rend(); ++itr) {
+		if (itr->state_id == state_id) {
+			return &*itr;
+		}
+	}
+	return nullptr;
+}
+} // namespace tec
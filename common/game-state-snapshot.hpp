@@ -0,0 +1,181 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "change-tracker.hpp"
+#include "components/transforms.hpp"
+#include "components/velocity.hpp"
+#include "entity-id-allocator.hpp"
+#include "flat-game-state.hpp"
+#include "game-state.hpp"
+#include "tec-types.hpp"
+
+namespace tec {
+/**
+* \brief An immutable, versioned copy of a GameState that shares unchanged parts with older snapshots.
+*
+* Entities live in fixed size pages indexed by GetEntityIndex(), grouped in directories. A
+* Builder started from a snapshot copies only the pages it writes to (and their directory),
+* everything else is shared with the snapshot it started from. Taking the next snapshot
+* therefore costs O(changed entities), and keeping many of them around only costs the pages
+* that differ between them.
+*
+* Snapshots are cheap to copy and safe to read from any thread once built.
+*/
+class GameStateSnapshot {
+public:
+	static constexpr std::uint32_t PAGE_BITS = 6;
+	static constexpr std::uint32_t DIRECTORY_BITS = 6;
+	static constexpr std::uint32_t PAGE_SIZE = 1 << PAGE_BITS; // Entities per page.
+	static constexpr std::uint32_t DIRECTORY_SIZE = 1 << DIRECTORY_BITS; // Pages per directory.
+
+	/// One entity slot, present holds FlatGameState::ComponentMask bits and is 0 for an empty slot.
+	struct Entry {
+		eid entity_id{0};
+		std::uint8_t present{0};
+		Position position;
+		Orientation orientation;
+		Velocity velocity;
+	};
+
+	class Builder;
+
+	/// Version of the snapshot, one more than the snapshot it was built from.
+	std::uint64_t GetVersion() const { return this->version; }
+
+	/// Number of entities holding at least one component.
+	std::size_t Size() const { return this->count; }
+
+	/// Get the entity's entry, or nullptr if the snapshot doesn't hold it.
+	const Entry* Find(eid entity_id) const;
+
+	const Position* GetPosition(eid entity_id) const {
+		const Entry* entry = Find(entity_id);
+		return entry && (entry->present & FlatGameState::HAS_POSITION) ? &entry->position : nullptr;
+	}
+	const Orientation* GetOrientation(eid entity_id) const {
+		const Entry* entry = Find(entity_id);
+		return entry && (entry->present & FlatGameState::HAS_ORIENTATION) ? &entry->orientation : nullptr;
+	}
+	const Velocity* GetVelocity(eid entity_id) const {
+		const Entry* entry = Find(entity_id);
+		return entry && (entry->present & FlatGameState::HAS_VELOCITY) ? &entry->velocity : nullptr;
+	}
+
+	/// Call fn(const Entry&) for every entity, in entity index order.
+	template <typename F> void ForEach(F&& fn) const {
+		for (const auto& directory : this->directories) {
+			if (!directory) {
+				continue;
+			}
+			for (const auto& page : directory->pages) {
+				if (!page) {
+					continue;
+				}
+				for (const Entry& entry : page->entries) {
+					if (entry.present) {
+						fn(entry);
+					}
+				}
+			}
+		}
+	}
+
+	GameState ToGameState() const;
+
+	/// Number of pages this snapshot shares with other, for checking how much history costs.
+	std::size_t CountSharedPages(const GameStateSnapshot& other) const;
+
+	state_id_t state_id = 0;
+	state_id_t command_id = 0;
+	uint64_t timestamp = 0;
+
+private:
+	struct Page {
+		std::array<Entry, PAGE_SIZE> entries{};
+		std::uint32_t count{0};
+	};
+
+	struct Directory {
+		std::array<std::shared_ptr<const Page>, DIRECTORY_SIZE> pages;
+	};
+
+	std::vector<std::shared_ptr<const Directory>> directories;
+	std::size_t count{0};
+	std::uint64_t version{0};
+};
+
+/// Records writes on top of a snapshot and turns them into a new snapshot.
+class GameStateSnapshot::Builder {
+public:
+	/// Start an empty snapshot.
+	Builder() = default;
+	/// Start from base, which is left untouched.
+	explicit Builder(const GameStateSnapshot& base);
+
+	void SetPosition(eid entity_id, const Position& position);
+	void SetOrientation(eid entity_id, const Orientation& orientation);
+	void SetVelocity(eid entity_id, const Velocity& velocity);
+
+	void RemovePosition(eid entity_id) { Remove(entity_id, FlatGameState::HAS_POSITION); }
+	void RemoveOrientation(eid entity_id) { Remove(entity_id, FlatGameState::HAS_ORIENTATION); }
+	void RemoveVelocity(eid entity_id) { Remove(entity_id, FlatGameState::HAS_VELOCITY); }
+
+	/// Removes all of the entity's components.
+	void RemoveEntity(eid entity_id) { Remove(entity_id, 0xFF); }
+
+	/// Removes every entity, the built snapshot still follows the base's version.
+	void Clear();
+
+	/// Finish the snapshot, the builder is empty afterwards.
+	GameStateSnapshot Build();
+
+private:
+	// Get the entity's slot in a page only this builder references, resetting it if it
+	// held another entity.
+	Entry& Write(eid entity_id);
+	void Remove(eid entity_id, std::uint8_t mask);
+
+	GameStateSnapshot snapshot; // The snapshot being built, its pages are shared until written.
+	// Directories and pages created by this builder, writable without copying again.
+	std::unordered_set<const void*> owned;
+};
+
+/**
+* \brief Keeps the most recent snapshots of a GameState.
+*
+* Capture() reads the state's change history (see GameStateChanges), so only entities
+* written since the previous capture are copied. If the history can't tell (the state
+* doesn't track changes, or the capture fell too far behind) the snapshot is rebuilt.
+*/
+class GameStateHistory {
+public:
+	explicit GameStateHistory(std::size_t capacity = 64) : capacity(capacity ? capacity : 1) {}
+
+	/// Take a snapshot of state, dropping the oldest one when full.
+	const GameStateSnapshot& Capture(const GameState& state);
+
+	/// Get the most recent snapshot, or nullptr if nothing was captured yet.
+	const GameStateSnapshot* Latest() const { return this->snapshots.empty() ? nullptr : &this->snapshots.back(); }
+
+	/// Get the most recent snapshot of the given state ID, or nullptr if it isn't kept anymore.
+	const GameStateSnapshot* Find(state_id_t state_id) const;
+
+	std::size_t Size() const { return this->snapshots.size(); }
+
+	std::size_t Capacity() const { return this->capacity; }
+
+private:
+	std::size_t capacity;
+	std::deque<GameStateSnapshot> snapshots;
+	ChangeTracker::Cursor position_cursor;
+	ChangeTracker::Cursor orientation_cursor;
+	ChangeTracker::Cursor velocity_cursor;
+};
+} // namespace tec
@@ -3,20 +3,33 @@
 #include <functional>
 #include <list>
 #include <map>
+#include <memory>
 
 #include <game_state.pb.h>
 
+#include "change-tracker.hpp"
 #include "components/transforms.hpp"
 #include "components/velocity.hpp"
 #include "events.hpp"
 #include "tec-types.hpp"
 
 namespace tec {
+/// Change history of the components held by a GameState, see ChangeTracker.
+struct GameStateChanges {
+	ChangeTracker positions;
+	ChangeTracker orientations;
+	ChangeTracker velocities;
+};
+
 struct GameState {
 	std::unordered_map<eid, Position> positions;
 	std::unordered_map<eid, Orientation> orientations;
 	std::unordered_map<eid, Velocity> velocities;
 
+	// Only writes made through the Set*/RemoveEntity methods are recorded. A copy of a tracking
+	// state gets a history of its own, see ShareChanges() for continuing the same one.
+	std::shared_ptr<GameStateChanges> changes;
+
 	GameState() = default;
 
 	GameState(const GameState& other) {
@@ -26,6 +39,7 @@ struct GameState {
 		this->positions = other.positions;
 		this->orientations = other.orientations;
 		this->velocities = other.velocities;
+		this->changes = other.changes ? std::make_shared<GameStateChanges>() : nullptr;
 		this->state_id = other.state_id;
 		this->command_id = other.command_id;
 		this->timestamp = other.timestamp;
@@ -34,6 +48,7 @@ struct GameState {
 		this->positions = std::move(other.positions);
 		this->orientations = std::move(other.orientations);
 		this->velocities = std::move(other.velocities);
+		this->changes = std::move(other.changes);
 		this->state_id = other.state_id;
 		this->command_id = other.command_id;
 		this->timestamp = other.timestamp;
@@ -46,6 +61,7 @@ struct GameState {
 		this->positions = other.positions;
 		this->orientations = other.orientations;
 		this->velocities = other.velocities;
+		this->changes = other.changes ? std::make_shared<GameStateChanges>() : nullptr;
 		this->state_id = other.state_id;
 		this->command_id = other.command_id;
 		this->timestamp = other.timestamp;
@@ -56,6 +72,7 @@ struct GameState {
 			this->positions = std::move(other.positions);
 			this->orientations = std::move(other.orientations);
 			this->velocities = std::move(other.velocities);
+			this->changes = std::move(other.changes);
 			this->state_id = other.state_id;
 			this->command_id = other.command_id;
 			this->timestamp = other.timestamp;
@@ -63,6 +80,61 @@ struct GameState {
 		return *this;
 	}
 
+	/// Start recording writes to this state in `changes`.
+	void TrackChanges() {
+		if (!this->changes) {
+			this->changes = std::make_shared<GameStateChanges>();
+		}
+	}
+
+	/**
+	* \brief Record writes to this state in another state's history.
+	*
+	* For a copy that replaces the state it was made from, so the readers of the original see
+	* the copy's writes as changes. Writes to either state are recorded in the same history.
+	* \param[in] const GameState& other The state whose history to continue.
+	*/
+	void ShareChanges(const GameState& other) { this->changes = other.changes; }
+
+	void SetPosition(const eid entity_id, const Position& position) {
+		this->positions[entity_id] = position;
+		if (this->changes) {
+			this->changes->positions.MarkChanged(entity_id);
+		}
+	}
+
+	void SetOrientation(const eid entity_id, const Orientation& orientation) {
+		this->orientations[entity_id] = orientation;
+		if (this->changes) {
+			this->changes->orientations.MarkChanged(entity_id);
+		}
+	}
+
+	void SetVelocity(const eid entity_id, const Velocity& velocity) {
+		this->velocities[entity_id] = velocity;
+		if (this->changes) {
+			this->changes->velocities.MarkChanged(entity_id);
+		}
+	}
+
+	/// Removes all of the entity's components from this state.
+	void RemoveEntity(const eid entity_id) {
+		const bool had_position = this->positions.erase(entity_id) > 0;
+		const bool had_orientation = this->orientations.erase(entity_id) > 0;
+		const bool had_velocity = this->velocities.erase(entity_id) > 0;
+		if (this->changes) {
+			if (had_position) {
+				this->changes->positions.MarkRemoved(entity_id);
+			}
+			if (had_orientation) {
+				this->changes->orientations.MarkRemoved(entity_id);
+			}
+			if (had_velocity) {
+				this->changes->velocities.MarkRemoved(entity_id);
+			}
+		}
+	}
+
 	void In(const proto::GameStateUpdate& gsu) {
 		this->state_id = gsu.state_id();
 		this->command_id = gsu.command_id();
@@ -102,17 +174,16 @@ struct GameState {
 	void Out(proto::GameStateUpdate* gsu) const {
 		gsu->set_state_id(this->state_id);
 		gsu->set_timestamp(this->timestamp);
-		for (auto pos : this->positions) {
+		gsu->mutable_entity()->Reserve(gsu->entity_size() + static_cast<int>(this->positions.size()));
+		for (const auto& [entity_id, position] : this->positions) {
 			tec::proto::Entity* entity = gsu->add_entity();
-			entity->set_id(pos.first);
-			pos.second.Out(entity->add_components());
-			if (this->orientations.find(pos.first) != this->orientations.end()) {
-				tec::Orientation ori = this->orientations.at(pos.first);
-				ori.Out(entity->add_components());
+			entity->set_id(entity_id);
+			position.Out(entity->add_components());
+			if (const auto ori = this->orientations.find(entity_id); ori != this->orientations.end()) {
+				ori->second.Out(entity->add_components());
 			}
-			if (this->velocities.find(pos.first) != this->velocities.end()) {
-				tec::Velocity vel = this->velocities.at(pos.first);
-				vel.Out(entity->add_components());
+			if (const auto vel = this->velocities.find(entity_id); vel != this->velocities.end()) {
+				vel->second.Out(entity->add_components());
 			}
 		}
 	}
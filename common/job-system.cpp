@@ -0,0 +1,244 @@
+#include "job-system.hpp"
+
+#include <random>
+
+#include "work-stealing-deque.hpp"
+
+namespace tec {
+struct Job {
+	JobSystem::JobFunction function;
+	JobGroup* group{nullptr};
+};
+
+struct JobSystem::Worker {
+	Worker() : jobs(DEQUE_CAPACITY) {}
+
+	WorkStealingDeque<Job> jobs;
+};
+
+namespace {
+// The system and worker index of the current thread, if it is a worker.
+thread_local JobSystem* current_system = nullptr;
+thread_local std::size_t current_worker = 0;
+
+// Finished jobs are kept per thread for reuse, so a steady stream of jobs doesn't allocate.
+struct JobCache {
+	static constexpr std::size_t MAX_SIZE = 1024;
+
+	~JobCache() {
+		for (Job* job : this->jobs) {
+			delete job;
+		}
+	}
+
+	Job* Take() {
+		if (this->jobs.empty()) {
+			return new Job();
+		}
+		Job* job = this->jobs.back();
+		this->jobs.pop_back();
+		return job;
+	}
+
+	void Give(Job* job) {
+		job->function = {};
+		job->group = nullptr;
+		if (this->jobs.size() < MAX_SIZE) {
+			this->jobs.push_back(job);
+		}
+		else {
+			delete job;
+		}
+	}
+
+	std::vector<Job*> jobs;
+};
+
+thread_local JobCache job_cache;
+
+std::size_t NextRandom() {
+	thread_local std::minstd_rand random(
+			static_cast<std::minstd_rand::result_type>(std::hash<std::thread::id>{}(std::this_thread::get_id())));
+	return random();
+}
+} // namespace
+
+JobSystem::JobSystem(std::size_t thread_count) {
+	if (thread_count == 0) {
+		thread_count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+	}
+	for (std::size_t i = 0; i < thread_count; ++i) {
+		this->workers.push_back(std::make_unique<Worker>());
+	}
+	for (std::size_t i = 0; i < thread_count; ++i) {
+		this->threads.emplace_back([this, i]() { WorkerLoop(i); });
+	}
+}
+
+JobSystem::~JobSystem() {
+	{
+		std::lock_guard lock(this->sleep_mutex);
+		this->stopping = true;
+	}
+	this->wake.notify_all();
+	for (std::thread& thread : this->threads) {
+		thread.join();
+	}
+	for (auto& worker : this->workers) {
+		while (Job* job = worker->jobs.Pop()) {
+			delete job;
+		}
+	}
+	for (Job* job : this->shared_jobs) {
+		delete job;
+	}
+}
+
+JobSystem& JobSystem::Get() {
+	static JobSystem instance;
+	return instance;
+}
+
+void JobSystem::Run(JobGroup& group, JobFunction job) {
+	Job* new_job = job_cache.Take();
+	new_job->function = std::move(job);
+	new_job->group = &group;
+	group.pending.fetch_add(1, std::memory_order_relaxed);
+	Schedule(new_job);
+}
+
+void JobSystem::RunAfter(JobGroup& after, JobGroup& group, JobFunction job) {
+	Job* new_job = job_cache.Take();
+	new_job->function = std::move(job);
+	new_job->group = &group;
+	group.pending.fetch_add(1, std::memory_order_relaxed);
+	{
+		// Finish() takes the continuations under the same lock after pending drops to 0
+		std::lock_guard lock(after.mutex);
+		if (after.pending.load(std::memory_order_acquire) > 0) {
+			after.continuations.push_back(new_job);
+			return;
+		}
+	}
+	Schedule(new_job);
+}
+
+void JobSystem::Wait(JobGroup& group) {
+	while (!group.Done()) {
+		if (Job* job = FindJob()) {
+			Execute(job);
+		}
+		else {
+			std::this_thread::yield();
+		}
+	}
+	std::lock_guard lock(group.mutex);
+	if (group.error) {
+		std::exception_ptr error = std::move(group.error);
+		group.error = nullptr;
+		std::rethrow_exception(error);
+	}
+}
+
+void JobSystem::Schedule(Job* job) {
+	if (current_system != this || !this->workers[current_worker]->jobs.Push(job)) {
+		std::lock_guard lock(this->shared_mutex);
+		this->shared_jobs.push_back(job);
+		this->shared_count.fetch_add(1, std::memory_order_relaxed);
+	}
+	this->epoch.fetch_add(1, std::memory_order_seq_cst);
+	if (this->sleepers.load(std::memory_order_seq_cst) > 0) {
+		std::lock_guard lock(this->sleep_mutex);
+		this->wake.notify_one();
+	}
+}
+
+Job* JobSystem::FindJob() {
+	if (current_system == this) {
+		if (Job* job = this->workers[current_worker]->jobs.Pop()) {
+			return job;
+		}
+	}
+	if (this->shared_count.load(std::memory_order_relaxed) > 0) {
+		std::lock_guard lock(this->shared_mutex);
+		if (!this->shared_jobs.empty()) {
+			Job* job = this->shared_jobs.front();
+			this->shared_jobs.pop_front();
+			this->shared_count.fetch_sub(1, std::memory_order_relaxed);
+			return job;
+		}
+	}
+	const std::size_t count = this->workers.size();
+	const std::size_t first = NextRandom();
+	for (std::size_t i = 0; i < count; ++i) {
+		const std::size_t victim = (first + i) % count;
+		if (current_system == this && victim == current_worker) {
+			continue;
+		}
+		if (Job* job = this->workers[victim]->jobs.Steal()) {
+			return job;
+		}
+	}
+	return nullptr;
+}
+
+void JobSystem::Execute(Job* job) {
+	JobGroup& group = *job->group;
+	try {
+		job->function();
+	}
+	catch (...) {
+		std::lock_guard lock(group.mutex);
+		if (!group.error) {
+			group.error = std::current_exception();
+		}
+	}
+	job_cache.Give(job);
+	Finish(group);
+}
+
+void JobSystem::Finish(JobGroup& group) {
+	// finishing keeps Wait() from returning, and the group from being destroyed, until the
+	// continuations are released
+	group.finishing.fetch_add(1, std::memory_order_seq_cst);
+	if (group.pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		std::vector<Job*> ready;
+		{
+			std::lock_guard lock(group.mutex);
+			ready.swap(group.continuations);
+		}
+		for (Job* job : ready) {
+			Schedule(job);
+		}
+	}
+	group.finishing.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::WorkerLoop(const std::size_t index) {
+	current_system = this;
+	current_worker = index;
+	constexpr int SPINS_BEFORE_SLEEP = 64;
+	int idle_spins = 0;
+	while (!this->stopping.load(std::memory_order_relaxed)) {
+		const std::uint64_t seen_epoch = this->epoch.load(std::memory_order_seq_cst);
+		if (Job* job = FindJob()) {
+			Execute(job);
+			idle_spins = 0;
+			continue;
+		}
+		if (++idle_spins < SPINS_BEFORE_SLEEP) {
+			std::this_thread::yield();
+			continue;
+		}
+		std::unique_lock lock(this->sleep_mutex);
+		this->sleepers.fetch_add(1, std::memory_order_seq_cst);
+		this->wake.wait(lock, [this, seen_epoch]() {
+			return this->stopping.load(std::memory_order_relaxed)
+				   || this->epoch.load(std::memory_order_seq_cst) != seen_epoch;
+		});
+		this->sleepers.fetch_sub(1, std::memory_order_relaxed);
+		idle_spins = 0;
+	}
+	current_system = nullptr;
+}
+} // namespace tec
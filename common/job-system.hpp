@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "small-function.hpp"
+
+namespace tec {
+class JobSystem;
+struct Job;
+
+/**
+* \brief The unfinished jobs of a batch, to wait on them or to run continuations after them.
+*
+* A group may be reused for another batch once Wait() on it has returned.
+*/
+class JobGroup {
+public:
+	JobGroup() = default;
+	JobGroup(const JobGroup&) = delete;
+	JobGroup& operator=(const JobGroup&) = delete;
+
+	/// True once every job of the group has finished.
+	bool Done() const {
+		return this->pending.load(std::memory_order_acquire) == 0
+			   && this->finishing.load(std::memory_order_acquire) == 0;
+	}
+
+private:
+	friend class JobSystem;
+
+	std::atomic<std::size_t> pending{0}; // Jobs added but not finished.
+	std::atomic<std::size_t> finishing{0}; // Threads still releasing continuations, see JobSystem::Finish().
+	std::mutex mutex;
+	std::vector<Job*> continuations; // Run once pending drops to 0, guarded by mutex.
+	std::exception_ptr error; // The first exception thrown by a job, guarded by mutex.
+};
+
+/**
+* \brief Work-stealing job system for splitting work across cores without creating threads.
+*
+* Each worker has its own deque: jobs a worker spawns go to the bottom of its deque and it
+* runs them newest first, idle workers steal the oldest jobs of the others. Jobs spawned by
+* other threads go to a shared queue. Waiting on a group runs other jobs until the group is
+* done, so nested parallelism never blocks a worker.
+*
+* Jobs may be added and waited on from any thread. Get() is the engine-wide instance.
+*/
+class JobSystem {
+public:
+	using JobFunction = SmallFunction<void()>;
+
+	static constexpr std::size_t DEQUE_CAPACITY = 4096;
+
+	/// Start thread_count workers, 0 for one per core but the caller's.
+	explicit JobSystem(std::size_t thread_count = 0);
+	/// Stops the workers, jobs that haven't started by then never run.
+	~JobSystem();
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	/// The shared instance, with one worker per core but the main thread's.
+	static JobSystem& Get();
+
+	std::size_t GetWorkerCount() const { return this->workers.size(); }
+
+	/// Add a job to group.
+	void Run(JobGroup& group, JobFunction job);
+
+	/// Add a job to group that runs once every job currently in after has finished.
+	void RunAfter(JobGroup& after, JobGroup& group, JobFunction job);
+
+	/// Run jobs until every job of group has finished, then rethrow the first exception one threw.
+	void Wait(JobGroup& group);
+
+	/**
+	* \brief Call body(chunk_begin, chunk_end) over [begin, end) in chunks of at most grain indices.
+	*
+	* The range is split in halves, so a thief takes the largest remaining piece. The calling
+	* thread works on the range too, and returns once all of it is done.
+	*/
+	template <typename F> void ParallelFor(std::size_t begin, std::size_t end, std::size_t grain, F&& body) {
+		grain = std::max<std::size_t>(grain, 1);
+		if (end <= begin) {
+			return;
+		}
+		JobGroup group;
+		try {
+			Split(group, begin, end, grain, body);
+		}
+		catch (...) {
+			// the chunks already handed out still have to finish before group goes away
+			std::lock_guard lock(group.mutex);
+			if (!group.error) {
+				group.error = std::current_exception();
+			}
+		}
+		Wait(group);
+	}
+
+private:
+	struct Worker;
+
+	template <typename F> void Split(JobGroup& group, std::size_t begin, std::size_t end, std::size_t grain, F& body) {
+		while (end - begin > grain) {
+			const std::size_t middle = begin + (end - begin) / 2;
+			Run(group, [this, &group, &body, middle, end, grain]() { Split(group, middle, end, grain, body); });
+			end = middle;
+		}
+		body(begin, end);
+	}
+
+	void Schedule(Job* job);
+	Job* FindJob();
+	void Execute(Job* job);
+	void Finish(JobGroup& group);
+	void WorkerLoop(std::size_t index);
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::vector<std::thread> threads;
+
+	std::mutex shared_mutex;
+	std::deque<Job*> shared_jobs; // Jobs from threads that aren't workers, guarded by shared_mutex.
+	std::atomic<std::size_t> shared_count{0};
+
+	// Sleeping workers wait for the epoch to change, which every new job does.
+	std::mutex sleep_mutex;
+	std::condition_variable wake;
+	std::atomic<std::uint64_t> epoch{0};
+	std::atomic<std::size_t> sleepers{0};
+	std::atomic<bool> stopping{false};
+};
+} // namespace tec
@@ -3,8 +3,115 @@
 #include "entity.hpp"
 #include "events.hpp"
 #include "multiton.hpp"
+#include "physics-system.hpp"
 #include "proto-load.hpp"
+#include "queue-instrumentation.hpp"
 #include "resources/script-file.hpp"
+#include "tick-arena.hpp"
+#include "tick-profiler.hpp"
+
+TEC_RegisterLuaType(tec, QueueStats) {
+	// clang-format off
+	state.new_usertype<QueueStats>(
+		"QueueStats", sol::no_constructor,
+		"kind", sol::readonly(&QueueStats::kind),
+		"name", sol::readonly(&QueueStats::name),
+		"emitted", sol::readonly(&QueueStats::emitted),
+		"queued", sol::readonly(&QueueStats::queued),
+		"handled", sol::readonly(&QueueStats::handled),
+		"depth", sol::readonly(&QueueStats::depth),
+		"last_depth", sol::readonly(&QueueStats::last_depth),
+		"max_depth", sol::readonly(&QueueStats::max_depth),
+		"latency_histogram", sol::readonly(&QueueStats::latency_histogram),
+		"latency_p50_ns", sol::readonly(&QueueStats::latency_p50_ns),
+		"latency_p99_ns", sol::readonly(&QueueStats::latency_p99_ns),
+		"latency_max_ns", sol::readonly(&QueueStats::latency_max_ns)
+	);
+	// clang-format on
+	// empty unless built with TEC_EVENT_INSTRUMENTATION
+	state["GetQueueStats"] = &QueueInstrument::GetAll;
+}
+
+TEC_RegisterLuaType(tec, PhaseStats) {
+	// clang-format off
+	state.new_usertype<PhaseStats>(
+		"PhaseStats", sol::no_constructor,
+		"name", sol::readonly(&PhaseStats::name),
+		"samples", sol::readonly(&PhaseStats::samples),
+		"last_ms", sol::readonly(&PhaseStats::last_ms),
+		"p50_ms", sol::readonly(&PhaseStats::p50_ms),
+		"p95_ms", sol::readonly(&PhaseStats::p95_ms),
+		"p99_ms", sol::readonly(&PhaseStats::p99_ms),
+		"max_ms", sol::readonly(&PhaseStats::max_ms)
+	);
+	// clang-format on
+	state["GetTickProfile"] = []() { return TickProfiler::Get().GetStats(); };
+}
+
+namespace {
+glm::vec3 ReadVector(const sol::optional<sol::table>& vector) {
+	if (!vector) {
+		return glm::vec3(0.f);
+	}
+	return glm::vec3(vector->get_or(1, 0.f), vector->get_or(2, 0.f), vector->get_or(3, 0.f));
+}
+
+sol::table WriteVector(sol::state_view& lua, const glm::vec3& vector) {
+	return lua.create_table_with(1, vector.x, 2, vector.y, 3, vector.z);
+}
+} // namespace
+
+TEC_RegisterLuaType(tec, PhysicsSystem) {
+	// physics:Query({{from = {x, y, z}, to = {x, y, z}, shape = "ray"|"sphere"|"box", radius = r,
+	//	half_extents = {x, y, z}, rotation = {x, y, z}, ignore = entity_id}, ...}, parallel) returns the closest hit of
+	// each query in order, as {hit = bool, entity = entity_id, fraction = f, point = {x, y, z}, normal = {x, y, z}}
+	// a box's rotation is in Euler angles (radians) like Orientation::rotation, unrotated if left out
+	// clang-format off
+	state.new_usertype<PhysicsSystem>(
+		"PhysicsSystem", sol::no_constructor,
+		"Query", [](const PhysicsSystem& physics, const sol::table& lua_queries, const sol::optional<bool> parallel,
+				sol::this_state lua_state) {
+			std::vector<PhysicsQuery> queries(lua_queries.size());
+			for (std::size_t i = 0; i < queries.size(); ++i) {
+				const sol::table lua_query = lua_queries.get<sol::table>(i + 1);
+				PhysicsQuery& query = queries[i];
+				const std::string shape = lua_query.get_or<std::string>("shape", "ray");
+				if (shape == "sphere") {
+					query.shape = PhysicsQuery::Shape::Sphere;
+				}
+				else if (shape == "box") {
+					query.shape = PhysicsQuery::Shape::Box;
+				}
+				query.from = ReadVector(lua_query.get<sol::optional<sol::table>>("from"));
+				query.to = ReadVector(lua_query.get<sol::optional<sol::table>>("to"));
+				query.radius = lua_query.get_or("radius", query.radius);
+				if (const auto half_extents = lua_query.get<sol::optional<sol::table>>("half_extents")) {
+					query.half_extents = ReadVector(half_extents);
+				}
+				if (const auto rotation = lua_query.get<sol::optional<sol::table>>("rotation")) {
+					query.orientation = glm::quat(ReadVector(rotation));
+				}
+				query.ignore_entity = lua_query.get_or<eid>("ignore", 0);
+			}
+			std::vector<PhysicsQueryHit> results(queries.size());
+			physics.Query(queries, results, parallel.value_or(false));
+
+			sol::state_view lua(lua_state);
+			sol::table lua_results = lua.create_table(static_cast<int>(results.size()), 0);
+			for (std::size_t i = 0; i < results.size(); ++i) {
+				const PhysicsQueryHit& result = results[i];
+				lua_results[i + 1] = lua.create_table_with(
+						"hit", result.hit,
+						"entity", result.entity_id,
+						"fraction", result.fraction,
+						"point", WriteVector(lua, result.point),
+						"normal", WriteVector(lua, result.normal));
+			}
+			return lua_results;
+		}
+	);
+	// clang-format on
+}
 
 namespace tec {
 using LuaScriptMap = Multiton<eid, LuaScript*>;
@@ -125,10 +232,10 @@ void LuaSystem::On(eid, const std::shared_ptr<EntityCreated> data) {
 		switch (const auto& comp = data->entity.components(i); comp.component_case()) {
 		case proto::Component::kLuaScript:
 		{
-			auto* script = new LuaScript();
+			auto* script = ComponentPool<LuaScript>::Create();
 			script->SetupEnvironment(&this->lua);
 			script->In(comp);
-			LuaScriptMap::Set(entity_id, script);
+			Entity(entity_id).Update(script);
 			break;
 		}
 		default: break;
@@ -136,8 +243,8 @@ void LuaSystem::On(eid, const std::shared_ptr<EntityCreated> data) {
 	}
 }
 
-std::list<sol::protected_function> LuaSystem::GetAllFunctions(const std::string& function_name) {
-	std::list<sol::protected_function> functions;
+std::pmr::list<sol::protected_function> LuaSystem::GetAllFunctions(const std::string& function_name) {
+	std::pmr::list<sol::protected_function> functions(&TickArena::Get());
 	// global state functions
 	if (this->lua[function_name].valid()) {
 		functions.push_back(this->lua[function_name]);
@@ -167,7 +274,7 @@ std::shared_ptr<LuaScript> LuaSystem::LoadFile(const Path& filepath) {
 	return script;
 }
 
-void LuaSystem::On(const eid entity_id, std::shared_ptr<EntityDestroyed> data) { LuaScriptMap::Remove(entity_id); }
+void LuaSystem::On(const eid entity_id, std::shared_ptr<EntityDestroyed> data) { Entity(entity_id).Remove<LuaScript>(); }
 
 void LuaSystem::On(eid, const std::shared_ptr<ChatCommandEvent> data) {
 	this->CallFunctions("onChatCommand", data->command, data->args);
@@ -183,11 +290,11 @@ void LuaSystem::HandlePlayerJoin(const std::string& ip, const std::string& ident
 
 void LuaSystem::HandlePlayerLeave(const std::string& identifier) { this->CallFunctions("onPlayerLeave", identifier); }
 
-void LuaSystem::HandlePlayerInteraction(const std::string& identifier, int entity_id, const std::string& interaction_type) {
+void LuaSystem::HandlePlayerInteraction(const std::string& identifier, eid entity_id, const std::string& interaction_type) {
 	this->CallFunctions("onPlayerInteraction", identifier, entity_id, interaction_type);
 }
 
-void LuaSystem::HandleEntitySpawning(int entity_id) {
+void LuaSystem::HandleEntitySpawning(eid entity_id) {
 	this->CallFunctions("onEntitySpawning", entity_id);
 }
 
@@ -3,6 +3,10 @@
  * Lua system
  */
 
+#include <functional>
+#include <list>
+#include <memory_resource>
+
 #include <sol/sol.hpp>
 #include <spdlog/spdlog.h>
 
@@ -50,8 +54,8 @@ public:
 
 	void HandlePlayerJoin(const std::string& ip, const std::string& identifier);
 	void HandlePlayerLeave(const std::string& identifier);
-	void HandlePlayerInteraction(const std::string& identifier, int entity_id, const std::string& interaction_type);
-	void HandleEntitySpawning(int entity_id);
+	void HandlePlayerInteraction(const std::string& identifier, eid entity_id, const std::string& interaction_type);
+	void HandleEntitySpawning(eid entity_id);
 	void Teleport(const std::string& identifier, int x, int y, int z);
 	void Kick(const std::string& identifier);
 
@@ -59,7 +63,8 @@ private:
 	sol::state lua;
 	std::list<LuaScript> scripts;
 
-	std::list<sol::protected_function> GetAllFunctions(const std::string&);
+	/// Allocated from the calling thread's TickArena.
+	std::pmr::list<sol::protected_function> GetAllFunctions(const std::string&);
 
 	friend LuaClassList;
 	static LuaClassList* lua_userclasses;
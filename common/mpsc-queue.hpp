@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace tec {
+/**
+* \brief Lock-free multi-producer/single-consumer queue.
+*
+* Producers push onto an intrusive stack with a single compare-and-swap. The consumer
+* takes the whole stack with one exchange and reverses it, so items come out in the
+* order they were pushed and producers never wait on the consumer or on each other.
+*
+* Nodes are pooled per item type and reused: each thread keeps a private cache of free
+* nodes, refilled by taking all the nodes consumers recycled since its last refill.
+* Nothing ever pops a single node off a shared stack, which keeps the queue free of ABA
+* problems without tagged pointers. Once warmed up, pushing and draining don't allocate.
+*
+* Push() may be called from any thread, ConsumeAll() from one thread at a time.
+*/
+template <class T> class MPSCQueue {
+public:
+	MPSCQueue() = default;
+	MPSCQueue(const MPSCQueue&) = delete;
+	MPSCQueue& operator=(const MPSCQueue&) = delete;
+	~MPSCQueue() {
+		ConsumeAll([](T&&) {});
+	}
+
+	/// Push an item, this may be called from any thread.
+	void Push(T&& item) {
+		Node* node = AcquireNode();
+		new (&node->storage) T(std::move(item));
+		node->next = this->head.load(std::memory_order_relaxed);
+		while (!this->head.compare_exchange_weak(
+				node->next, node, std::memory_order_release, std::memory_order_relaxed)) {}
+	}
+
+	/**
+	* \brief Call fn(T&&) for every item pushed so far, oldest first.
+	*
+	* Items pushed while draining, even by fn itself, are left for the next call.
+	* \param[in] F&& fn The function to call for each item.
+	* \return std::size_t The number of items drained.
+	*/
+	template <typename F> std::size_t ConsumeAll(F&& fn) {
+		Node* newest = this->head.exchange(nullptr, std::memory_order_acquire);
+		// the stack is newest first, reverse it to get the push order back
+		Node* oldest = nullptr;
+		while (newest) {
+			Node* next = newest->next;
+			newest->next = oldest;
+			oldest = newest;
+			newest = next;
+		}
+
+		std::size_t count = 0;
+		Node* last = oldest;
+		for (Node* node = oldest; node; node = node->next) {
+			T* item = node->Get();
+			fn(std::move(*item));
+			item->~T();
+			last = node;
+			++count;
+		}
+		// the drained nodes go back to the pool in one go
+		if (oldest) {
+			ReleaseNodes(oldest, last);
+		}
+		return count;
+	}
+
+	/// Checks if nothing was pushed since the last drain, only a hint while producers are active.
+	bool Empty() const { return this->head.load(std::memory_order_relaxed) == nullptr; }
+
+private:
+	struct Node {
+		T* Get() { return std::launder(reinterpret_cast<T*>(&this->storage)); }
+		Node* next{nullptr};
+		alignas(T) std::byte storage[sizeof(T)];
+	};
+
+	// A thread's private free nodes, handed back to the shared pool when the thread exits.
+	struct NodeCache {
+		~NodeCache() {
+			if (this->nodes) {
+				Node* last = this->nodes;
+				while (last->next) {
+					last = last->next;
+				}
+				ReleaseNodes(this->nodes, last);
+			}
+		}
+		Node* nodes{nullptr};
+	};
+
+	static Node* AcquireNode() {
+		thread_local NodeCache cache;
+		if (!cache.nodes) {
+			cache.nodes = free_nodes.exchange(nullptr, std::memory_order_acquire);
+			if (!cache.nodes) {
+				return new Node();
+			}
+		}
+		Node* node = cache.nodes;
+		cache.nodes = node->next;
+		return node;
+	}
+
+	// Push the chain of nodes from first to last onto the shared pool.
+	static void ReleaseNodes(Node* first, Node* last) {
+		last->next = free_nodes.load(std::memory_order_relaxed);
+		while (!free_nodes.compare_exchange_weak(last->next, first, std::memory_order_release, std::memory_order_relaxed)) {
+		}
+	}
+
+	std::atomic<Node*> head{nullptr};
+
+	// Free nodes of every queue of this item type, never freed like the component pools.
+	static inline std::atomic<Node*> free_nodes{nullptr};
+};
+} // namespace tec
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace tec {
+/**
+* \brief Bounded lock-free multi-producer/single-consumer ring of values.
+*
+* Each cell carries a sequence number telling whether it is free for the push that
+* reserved its position or holds a value for the consumer (Vyukov's bounded queue).
+* A push reserves a position with one compare-and-swap, writes the value in place and
+* publishes it; a full ring makes TryPush() fail rather than wait, so the caller picks
+* the overflow behavior. Values are stored by value and the cells are allocated once,
+* so pushing and draining never allocate.
+*
+* TryPush() may be called from any thread, ConsumeAll() from one thread at a time.
+* T must be default constructible and move assignable.
+*/
+template <class T> class MPSCRing {
+public:
+	/// \param[in] const std::size_t capacity Number of cells, rounded up to a power of two.
+	explicit MPSCRing(const std::size_t capacity) : mask(RoundUp(capacity) - 1), cells(new Cell[mask + 1]) {
+		for (std::size_t i = 0; i <= this->mask; ++i) {
+			this->cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+	MPSCRing(const MPSCRing&) = delete;
+	MPSCRing& operator=(const MPSCRing&) = delete;
+
+	/**
+	* \brief Push a value if there is a free cell.
+	*
+	* \param[in] U&& value The value to store.
+	* \return bool False if the ring is full, value is left untouched then.
+	*/
+	template <typename U> bool TryPush(U&& value) {
+		std::uint64_t position = this->push_position.load(std::memory_order_relaxed);
+		Cell* cell = nullptr;
+		for (;;) {
+			cell = &this->cells[position & this->mask];
+			const std::uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+			const auto difference = static_cast<std::int64_t>(sequence - position);
+			if (difference == 0) {
+				if (this->push_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			}
+			else if (difference < 0) {
+				return false;
+			}
+			else {
+				position = this->push_position.load(std::memory_order_relaxed);
+			}
+		}
+		cell->value = std::forward<U>(value);
+		cell->sequence.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// Get the number of positions reserved by pushes so far, drained or not.
+	std::uint64_t GetPushCount() const { return this->push_position.load(std::memory_order_acquire); }
+
+	/**
+	* \brief Call fn(T&&) for the values at positions up to end, oldest first.
+	*
+	* A push that reserved a position before end is waited for, so nothing older
+	* than end is left behind. Values pushed later, even by fn itself, are left for
+	* the next call.
+	* \param[in] const std::uint64_t end Position to stop at, from GetPushCount().
+	* \param[in] F&& fn The function to call for each value.
+	* \return std::size_t The number of values drained.
+	*/
+	template <typename F> std::size_t ConsumeUntil(const std::uint64_t end, F&& fn) {
+		std::uint64_t position = this->pop_position.load(std::memory_order_relaxed);
+		const std::uint64_t start = position;
+		for (; position < end; ++position) {
+			Cell& cell = this->cells[position & this->mask];
+			while (cell.sequence.load(std::memory_order_acquire) != position + 1) {
+				std::this_thread::yield();
+			}
+			fn(std::move(cell.value));
+			// fn may not have moved from it, don't keep what the value holds alive until the cell is reused
+			cell.value = T{};
+			cell.sequence.store(position + this->mask + 1, std::memory_order_release);
+			this->pop_position.store(position + 1, std::memory_order_relaxed);
+		}
+		return static_cast<std::size_t>(position - start);
+	}
+
+	/// Call fn(T&&) for every value pushed so far, oldest first. See ConsumeUntil().
+	template <typename F> std::size_t ConsumeAll(F&& fn) { return ConsumeUntil(GetPushCount(), std::forward<F>(fn)); }
+
+	/// Get the number of values waiting, only a hint while producers are active.
+	std::size_t Size() const {
+		const std::uint64_t popped = this->pop_position.load(std::memory_order_relaxed);
+		const std::uint64_t pushed = GetPushCount();
+		return pushed > popped ? static_cast<std::size_t>(pushed - popped) : 0;
+	}
+
+	std::size_t Capacity() const { return this->mask + 1; }
+
+private:
+	struct Cell {
+		std::atomic<std::uint64_t> sequence{0};
+		T value{};
+	};
+
+	static std::size_t RoundUp(const std::size_t capacity) {
+		std::size_t size = 1;
+		while (size < capacity) {
+			size <<= 1;
+		}
+		return size;
+	}
+
+	const std::size_t mask;
+	std::unique_ptr<Cell[]> cells;
+	// kept on separate cache lines so producers and the consumer don't false share
+	alignas(64) std::atomic<std::uint64_t> push_position{0};
+	alignas(64) std::atomic<std::uint64_t> pop_position{0};
+};
+
+/// What BoundedMPSCQueue::Push() does when the ring is full.
+enum class OverflowPolicy {
+	BLOCK, // Wait for the consumer to make room. Never use it where the consumer thread pushes too.
+	DROP, // Discard the value and count it.
+	GROW, // Spill into an overflow buffer that keeps its capacity between drains.
+};
+
+/**
+* \brief MPSCRing with a policy for when it is full.
+*
+* With OverflowPolicy::GROW, values pushed once the ring is full go to an overflow buffer
+* (behind a mutex) until the next drain. Everything that was in the ring before the
+* overflow was taken is older, so it is handed out first and values from one thread always
+* come out in the order they were pushed. The overflow only allocates while growing to the
+* largest burst seen.
+*
+* Push() may be called from any thread, ConsumeAll() from one thread at a time.
+*/
+template <class T> class BoundedMPSCQueue {
+public:
+	explicit BoundedMPSCQueue(const std::size_t capacity, const OverflowPolicy policy = OverflowPolicy::GROW) :
+			ring(capacity), policy(policy) {}
+
+	/**
+	* \brief Push a value, applying the overflow policy if the ring is full.
+	*
+	* \param[in] U&& value The value to store.
+	* \return bool False if the value was dropped.
+	*/
+	template <typename U> bool Push(U&& value) {
+		// TryPush() only moves from value when it succeeds, so it can be retried
+		if (!this->overflowed.load(std::memory_order_acquire) && this->ring.TryPush(std::forward<U>(value))) {
+			return true;
+		}
+		switch (this->policy.load(std::memory_order_relaxed)) {
+		case OverflowPolicy::DROP: this->dropped.fetch_add(1, std::memory_order_relaxed); return false;
+		case OverflowPolicy::BLOCK:
+			while (!this->ring.TryPush(std::forward<U>(value))) {
+				std::this_thread::yield();
+			}
+			return true;
+		case OverflowPolicy::GROW: break;
+		}
+		std::scoped_lock lock(this->overflow_mutex);
+		// the consumer may have taken the overflow in the meantime, go back to the ring then
+		if (!this->overflowed.load(std::memory_order_relaxed) && this->ring.TryPush(std::forward<U>(value))) {
+			return true;
+		}
+		this->overflowed.store(true, std::memory_order_release);
+		this->overflow.push_back(std::forward<U>(value));
+		this->overflow_size.store(this->overflow.size(), std::memory_order_relaxed);
+		return true;
+	}
+
+	/**
+	* \brief Call fn(T&&) for every value pushed so far, oldest first.
+	*
+	* Values pushed while draining, even by fn itself, are left for the next call.
+	* \param[in] F&& fn The function to call for each value.
+	* \return std::size_t The number of values drained.
+	*/
+	template <typename F> std::size_t ConsumeAll(F&& fn) {
+		std::uint64_t ring_end = this->ring.GetPushCount();
+		if (this->overflowed.load(std::memory_order_acquire)) {
+			std::scoped_lock lock(this->overflow_mutex);
+			ring_end = this->ring.GetPushCount();
+			std::swap(this->overflow, this->draining);
+			this->overflow_size.store(0, std::memory_order_relaxed);
+			this->overflowed.store(false, std::memory_order_release);
+		}
+		std::size_t count = this->ring.ConsumeUntil(ring_end, fn);
+		for (T& value : this->draining) {
+			fn(std::move(value));
+		}
+		count += this->draining.size();
+		this->draining.clear();
+		return count;
+	}
+
+	/// Changes the overflow policy, it is meant to be set before producers start.
+	void SetOverflowPolicy(const OverflowPolicy policy) { this->policy.store(policy, std::memory_order_relaxed); }
+
+	OverflowPolicy GetOverflowPolicy() const { return this->policy.load(std::memory_order_relaxed); }
+
+	/// Get the number of values waiting, only a hint while producers are active.
+	std::size_t Size() const { return this->ring.Size() + this->overflow_size.load(std::memory_order_relaxed); }
+
+	std::size_t Capacity() const { return this->ring.Capacity(); }
+
+	/// Get the number of values discarded by OverflowPolicy::DROP.
+	std::uint64_t GetDroppedCount() const { return this->dropped.load(std::memory_order_relaxed); }
+
+private:
+	MPSCRing<T> ring;
+	std::atomic<OverflowPolicy> policy;
+	std::atomic<bool> overflowed{false};
+	std::atomic<std::size_t> overflow_size{0};
+	std::atomic<std::uint64_t> dropped{0};
+	std::mutex overflow_mutex;
+	std::vector<T> overflow;
+	std::vector<T> draining; // The overflow being handed out, swapped back to keep its capacity.
+};
+} // namespace tec
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "change-tracker.hpp"
+#include "component-store.hpp"
 #include "tec-types.hpp"
 #include <map>
 #include <vector>
@@ -82,4 +84,109 @@ protected:
 template <typename ID_T, typename T> std::map<ID_T, T> Multiton<ID_T, T>::instances;
 
 template <typename ID_T, typename T> T Multiton<ID_T, T>::default_value;
+
+/* Specialization for per-entity component pointers.
+*
+* Components are looked up on every entity, every frame, so rather than a std::map these
+* are kept in a ComponentStore (sparse set) of pointers. Has/Get are constant time and
+* iteration walks a contiguous array. The pointed-to components are still owned by the
+* caller, and their addresses are unaffected by the store moving its entries around.
+*
+* Begin()/End()/Instances() iterate std::pair<eid, T*> in no particular order.
+*
+* Set() and Remove() are recorded in a ChangeTracker. Code that writes to a component
+* through its pointer calls MarkChanged() so systems reading Changes() pick it up.
+*/
+template <typename T> class Multiton<eid, T*> {
+public:
+	using store_type = ComponentStore<T*>;
+
+	static typename store_type::iterator Begin() { return instances.begin(); }
+
+	static typename store_type::iterator End() { return instances.end(); }
+
+	static std::size_t Size() { return instances.Size(); }
+
+	static std::vector<eid>& Keys() {
+		static std::vector<eid> keys;
+		static std::uint64_t keys_version = 0;
+		if (keys_version != instances.GetVersion() || keys.size() != instances.Size()) {
+			keys.clear();
+			for (const auto& pair : instances) {
+				keys.push_back(pair.first);
+			}
+			keys_version = instances.GetVersion();
+		}
+		return keys;
+	}
+
+	/**
+	* \brief Get the instance for the given ID.
+	*
+	* This doesn't create an instance if the ID doesn't exist.
+	* Instead it just returns the default.
+	* \param[in] const eid id The ID of the instance to get.
+	* \return T* The ID's instance or the default one.
+	*/
+	static T* Get(const eid id) {
+		T* const* instance = instances.Find(id);
+		return instance ? *instance : default_value;
+	}
+
+	static bool Has(const eid id) { return instances.Has(id); }
+
+	/**
+	* \brief Set (or add/create) an instance for the given ID.
+	*
+	* \param[in] const eid id The ID of the instance to set.
+	* \param[in] T* instance The ID's instance.
+	* \return void
+	*/
+	static void Set(const eid id, T* instance) {
+		instances.Set(id, instance);
+		changes.MarkChanged(id);
+	}
+
+	/**
+	* \brief Remove the instance for the given ID.
+	*
+	* \param[in] const eid id The ID of the instance to remove.
+	* \return void
+	*/
+	static void Remove(const eid id) {
+		if (instances.Remove(id)) {
+			changes.MarkRemoved(id);
+		}
+	}
+
+	/// Remove every instance, readers of Changes() have to do a full pass afterwards.
+	static void Clear() {
+		instances.Clear();
+		changes.Clear();
+	}
+
+	/// Record a write made through the instance pointer.
+	static void MarkChanged(const eid id) { changes.MarkChanged(id); }
+
+	/// Get the change history of this component type.
+	static const ChangeTracker& Changes() { return changes; }
+
+	static const store_type& Instances() { return instances; }
+
+	// Direct access to the backing store, e.g. for building component views.
+	static store_type& Store() { return instances; }
+
+protected:
+	static T* default_value; // Default instance.
+
+	static store_type instances; // Sparse set of ID to instance.
+
+	static ChangeTracker changes; // Writes and removals of instances.
+};
+
+template <typename T> ComponentStore<T*> Multiton<eid, T*>::instances;
+
+template <typename T> ChangeTracker Multiton<eid, T*>::changes;
+
+template <typename T> T* Multiton<eid, T*>::default_value = nullptr;
 } // namespace tec
@@ -1,31 +1,68 @@
 #include "physics-system.hpp"
 
+#include <algorithm>
+#include <stdexcept>
+
 // #include "physics/physics-debug-drawer.hpp"
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
 #include <BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h>
 #include <BulletCollision/Gimpact/btGImpactShape.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <BulletDynamics/Dynamics/btSimulationIslandManagerMt.h>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "bullet-task-scheduler.hpp"
 #include "components/collision-body.hpp"
 #include "components/transforms.hpp"
 #include "components/velocity.hpp"
+#include "component-pool.hpp"
 #include "entity.hpp"
 #include "events.hpp"
-#include "multiton.hpp"
+#include "job-system.hpp"
+#include "tick-arena.hpp"
 
 namespace tec {
-using CollisionBodyMap = Multiton<eid, CollisionBody*>;
+namespace {
+template <typename T> void RemoveIfCreated(const eid entity_id, T* created) {
+	if (created && Multiton<eid, T*>::Get(entity_id) == created) {
+		Entity(entity_id).Remove<T>();
+	}
+}
+} // namespace
+
 // #ifdef CLIENT_STANDALONE
 // 	PhysicsDebugDrawer debug_drawer;
 // #endif
 
-PhysicsSystem::PhysicsSystem() {
-	this->last_rayvalid = false;
+PhysicsSystem::PhysicsSystem(const PhysicsThreading& threading) {
 	this->collisionConfiguration = new btDefaultCollisionConfiguration();
-	this->dispatcher = new btCollisionDispatcher(this->collisionConfiguration);
 	this->broadphase = new btDbvtBroadphase();
-	this->solver = new btSequentialImpulseConstraintSolver();
-	this->dynamicsWorld =
-			new btDiscreteDynamicsWorld(this->dispatcher, this->broadphase, this->solver, this->collisionConfiguration);
+	// a worker Bullet can't number would write past its per-thread data, so fall back to one thread then
+	if (threading.thread_count > 0 && BulletTaskScheduler::FitsJobSystem()) {
+		BulletTaskScheduler& scheduler = BulletTaskScheduler::Get();
+		// the dispatcher sizes its per-thread arrays from the current thread count,
+		// and any of the scheduler's threads may end up running a chunk
+		scheduler.setNumThreads(scheduler.getMaxNumThreads());
+		this->dispatcher = new btCollisionDispatcherMt(this->collisionConfiguration, threading.dispatcher_grain_size);
+		scheduler.setNumThreads(static_cast<int>(threading.thread_count));
+
+		this->solver_pool = new btConstraintSolverPoolMt(scheduler.getMaxNumThreads());
+		this->solver = new btSequentialImpulseConstraintSolverMt();
+		auto* world = new btDiscreteDynamicsWorldMt(
+				this->dispatcher, this->broadphase, this->solver_pool, this->solver, this->collisionConfiguration);
+		// solve the islands in parallel, small ones are merged so a task isn't spent on a lone body
+		auto* island_manager = static_cast<btSimulationIslandManagerMt*>(world->getSimulationIslandManager());
+		island_manager->setIslandDispatchFunction(btSimulationIslandManagerMt::parallelIslandDispatch);
+		island_manager->setMinimumSolverBatchSize(threading.island_batch_size);
+		this->dynamicsWorld = world;
+	}
+	else {
+		this->dispatcher = new btCollisionDispatcher(this->collisionConfiguration);
+		this->solver = new btSequentialImpulseConstraintSolver();
+		this->dynamicsWorld = new btDiscreteDynamicsWorld(
+				this->dispatcher, this->broadphase, this->solver, this->collisionConfiguration);
+	}
 	this->dynamicsWorld->setGravity(btVector3(0, -10.0, 0));
 
 	btGImpactCollisionAlgorithm::registerAlgorithm(this->dispatcher);
@@ -36,27 +73,316 @@ PhysicsSystem::PhysicsSystem() {
 }
 
 PhysicsSystem::~PhysicsSystem() {
+	for (auto& [entity_id, body] : this->bodies) {
+		if (body) {
+			this->dynamicsWorld->removeRigidBody(body);
+			delete body;
+		}
+	}
+	this->bodies.Clear();
+	this->dynamic_bodies.Clear();
+	// The world is going away, release the components it made, unless something replaced them since.
+	for (const auto& [entity_id, created] : this->created_components) {
+		RemoveIfCreated(entity_id, created.collision_body);
+		RemoveIfCreated(entity_id, created.position);
+		RemoveIfCreated(entity_id, created.orientation);
+	}
+	this->created_components.Clear();
+
 	delete this->dynamicsWorld;
 	delete this->solver;
+	delete this->solver_pool;
 	delete this->collisionConfiguration;
 	delete this->dispatcher;
 	delete this->broadphase;
 }
 
-std::set<eid> PhysicsSystem::Update(const double delta, const GameState& state) {
+std::pmr::vector<eid> PhysicsSystem::Update(const double delta, const GameState& state) {
+	// the event handlers add and remove bodies, so queries wait for all of it
+	std::unique_lock world_lock(this->world_mutex);
 	ProcessCommandQueue();
-	EventQueue<MouseBtnEvent>::ProcessEventQueue();
 	EventQueue<EntityCreated>::ProcessEventQueue();
 	EventQueue<EntityDestroyed>::ProcessEventQueue();
 
-	for (auto itr = CollisionBodyMap::Begin(); itr != CollisionBodyMap::End(); ++itr) {
-		const eid& entity_id = itr->first;
+	// only the bodies the state changed since the last update, that moved last step or that are waiting
+	// to enter the world are synced, sleeping and static bodies are left alone
+	// an untracked state (or one we haven't read before) falls back to a pass over the dynamic bodies
+	const GameStateChanges* changes = state.changes.get();
+	const ChangeTracker::Cursor position_cursor = this->position_cursor;
+	const ChangeTracker::Cursor orientation_cursor = this->orientation_cursor;
+
+	std::pmr::vector<eid> dirty(&TickArena::Get());
+	bool full_sync = !changes;
+	if (changes) {
+		const auto mark_dirty = [&dirty](const eid entity_id) { dirty.push_back(entity_id); };
+		// every tracker has to be read so its cursor moves on, hence no short-circuit
+		full_sync |= !changes->positions.ForEachChanged(this->position_cursor, mark_dirty);
+		full_sync |= !changes->orientations.ForEachChanged(this->orientation_cursor, mark_dirty);
+		full_sync |= !changes->velocities.ForEachChanged(this->velocity_cursor, mark_dirty);
+	}
+	if (full_sync) {
+		dirty.reserve(dirty.size() + this->dynamic_bodies.Size());
+		for (const auto& [entity_id, body] : this->dynamic_bodies) {
+			dirty.push_back(entity_id);
+		}
+	}
+	dirty.insert(dirty.end(), this->moved_bodies.begin(), this->moved_bodies.end());
+	dirty.insert(dirty.end(), this->pending_bodies.begin(), this->pending_bodies.end());
+	std::sort(dirty.begin(), dirty.end());
+	dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+
+	this->pending_bodies.clear();
+	for (const eid entity_id : dirty) {
+		btRigidBody* const* body = this->bodies.Find(entity_id);
+		if (!body || !*body) {
+			continue;
+		}
+		auto* collidable = static_cast<CollisionBody*>((*body)->getUserPointer());
+		const bool position_changed =
+				!changes || !collidable->in_world || changes->positions.ChangedSince(entity_id, position_cursor);
+		const bool orientation_changed =
+				!changes || !collidable->in_world || changes->orientations.ChangedSince(entity_id, orientation_cursor);
+		if (!SyncBody(entity_id, collidable, *body, state, position_changed, orientation_changed)) {
+			this->pending_bodies.push_back(entity_id);
+		}
+	}
+
+	// using a delta time here makes physics far less deterministic
+	// this can be changed if it becomes a problem
+	Step(delta, this->simulation_substeps);
+	return std::pmr::vector<eid>(this->moved_bodies.begin(), this->moved_bodies.end(), &TickArena::Get());
+}
+
+void PhysicsSystem::Step(const double delta, const int substeps) {
+	this->moved_bodies.clear();
+	this->dynamicsWorld->stepSimulation(static_cast<btScalar>(delta), substeps);
+
+	// the motion states of the bodies Bullet moved this step added themselves to moved_bodies
+	std::sort(this->moved_bodies.begin(), this->moved_bodies.end());
+	for (const eid entity_id : this->moved_bodies) {
+		if (btRigidBody* const* body = this->bodies.Find(entity_id)) {
+			static_cast<CollisionBody*>((*body)->getUserPointer())->motion_state.transform_updated = false;
+		}
+	}
+}
+
+void PhysicsSystem::SaveSnapshot(const state_id_t id) {
+	// only reads the world, the snapshots are only touched by the updating thread
+	std::shared_lock world_lock(this->world_mutex);
+	PhysicsSnapshot* snapshot = FindSnapshot(id);
+	if (!snapshot) {
+		snapshot = &this->snapshots.push_front_overwrite();
+		snapshot->id = id;
+	}
+	snapshot->bodies.clear();
+	snapshot->bodies.reserve(this->dynamic_bodies.Size());
+	for (const auto& [entity_id, body] : this->dynamic_bodies) {
+		if (static_cast<CollisionBody*>(body->getUserPointer())->in_world) {
+			snapshot->bodies.push_back(SaveBody(entity_id, body));
+		}
+	}
+}
+
+bool PhysicsSystem::RestoreSnapshot(const state_id_t id) {
+	std::unique_lock world_lock(this->world_mutex);
+	const PhysicsSnapshot* snapshot = FindSnapshot(id);
+	if (!snapshot) {
+		return false;
+	}
+	for (const PhysicsSnapshot::Body& saved : snapshot->bodies) {
+		RestoreBody(saved);
+	}
+	// the solver randomizes its order from a seed, start it over like it was the first time
+	this->solver->reset();
+	return true;
+}
+
+bool PhysicsSystem::RestoreSnapshot(const state_id_t id, const std::span<const eid> entity_ids) {
+	std::unique_lock world_lock(this->world_mutex);
+	const PhysicsSnapshot* snapshot = FindSnapshot(id);
+	if (!snapshot) {
+		return false;
+	}
+	SetListedBodies(entity_ids);
+	for (const PhysicsSnapshot::Body& saved : snapshot->bodies) {
+		if (IsListed(saved.entity_id)) {
+			RestoreBody(saved);
+		}
+	}
+	this->solver->reset();
+	return true;
+}
 
-		CollisionBody* collidable = itr->second;
-		if (!collidable) {
+void PhysicsSystem::ApplyState(const GameState& state) {
+	std::unique_lock world_lock(this->world_mutex);
+	for (const auto& [entity_id, body] : this->dynamic_bodies) {
+		auto* collidable = static_cast<CollisionBody*>(body->getUserPointer());
+		if (!collidable->in_world) {
 			continue;
 		}
-		// fill in the transform for our collidable from the current state
+		btTransform transform = body->getWorldTransform();
+		bool moved = false;
+		if (auto position_iter = state.positions.find(entity_id); position_iter != state.positions.end()) {
+			const glm::vec3 position = position_iter->second.value;
+			if (std::isfinite(position.x) && std::isfinite(position.y) && std::isfinite(position.z)) {
+				transform.setOrigin(btVector3(position.x, position.y, position.z));
+				moved = true;
+			}
+		}
+		if (auto orientation_iter = state.orientations.find(entity_id); orientation_iter != state.orientations.end()) {
+			const glm::quat orientation = orientation_iter->second.value;
+			if (std::isfinite(orientation.x) && std::isfinite(orientation.y) && std::isfinite(orientation.z)
+				&& std::isfinite(orientation.w)) {
+				transform.setRotation(btQuaternion(orientation.x, orientation.y, orientation.z, orientation.w));
+				moved = true;
+			}
+		}
+		if (moved) {
+			body->setWorldTransform(transform);
+			body->setInterpolationWorldTransform(transform);
+			collidable->motion_state.transform = transform;
+			ResetBody(body);
+		}
+		if (auto velocity_iter = state.velocities.find(entity_id); velocity_iter != state.velocities.end()) {
+			ApplyVelocity(body, velocity_iter->second);
+			body->activate();
+		}
+	}
+}
+
+void PhysicsSystem::SetVelocity(const eid entity_id, const Velocity& velocity) {
+	std::unique_lock world_lock(this->world_mutex);
+	btRigidBody* const* body = this->bodies.Find(entity_id);
+	if (body && *body) {
+		ApplyVelocity(*body, velocity);
+		(*body)->activate();
+	}
+}
+
+std::pmr::vector<eid> PhysicsSystem::Resimulate(const int steps, const double step) {
+	std::unique_lock world_lock(this->world_mutex);
+	std::pmr::vector<eid> moved(&TickArena::Get());
+	for (int i = 0; i < steps; ++i) {
+		Step(step, 0);
+		moved.insert(moved.end(), this->moved_bodies.begin(), this->moved_bodies.end());
+	}
+	std::sort(moved.begin(), moved.end());
+	moved.erase(std::unique(moved.begin(), moved.end()), moved.end());
+	return moved;
+}
+
+std::pmr::vector<eid>
+PhysicsSystem::Resimulate(const int steps, const double step, const std::span<const eid> entity_ids) {
+	std::unique_lock world_lock(this->world_mutex);
+	SetListedBodies(entity_ids);
+	// a step only reports the bodies it moved, by then their previous state is gone, so keep a copy
+	this->held_bodies.Clear();
+	for (const auto& [entity_id, body] : this->dynamic_bodies) {
+		if (!IsListed(entity_id) && static_cast<CollisionBody*>(body->getUserPointer())->in_world) {
+			this->held_bodies.Emplace(entity_id, SaveBody(entity_id, body));
+		}
+	}
+	std::pmr::vector<eid> moved(&TickArena::Get());
+	std::pmr::vector<eid> pushed(&TickArena::Get());
+	for (int i = 0; i < steps; ++i) {
+		Step(step, 0);
+		for (const eid entity_id : this->moved_bodies) {
+			(IsListed(entity_id) ? moved : pushed).push_back(entity_id);
+		}
+	}
+	// the others only moved when the listed bodies pushed them or woke them up, put those back along
+	// with their components and leave the contacts and activation of the rest alone
+	std::sort(pushed.begin(), pushed.end());
+	pushed.erase(std::unique(pushed.begin(), pushed.end()), pushed.end());
+	for (const eid entity_id : pushed) {
+		if (const PhysicsSnapshot::Body* saved = this->held_bodies.Find(entity_id)) {
+			RestoreBody(*saved);
+		}
+	}
+	std::sort(moved.begin(), moved.end());
+	moved.erase(std::unique(moved.begin(), moved.end()), moved.end());
+	return moved;
+}
+
+void PhysicsSystem::SetListedBodies(const std::span<const eid> entity_ids) {
+	this->listed_bodies.assign(entity_ids.begin(), entity_ids.end());
+	std::sort(this->listed_bodies.begin(), this->listed_bodies.end());
+}
+
+bool PhysicsSystem::IsListed(const eid entity_id) const {
+	return std::binary_search(this->listed_bodies.begin(), this->listed_bodies.end(), entity_id);
+}
+
+PhysicsSnapshot* PhysicsSystem::FindSnapshot(const state_id_t id) {
+	for (std::size_t i = 0; i < this->snapshots.size(); ++i) {
+		if (this->snapshots[i].id == id) {
+			return &this->snapshots[i];
+		}
+	}
+	return nullptr;
+}
+
+PhysicsSnapshot::Body PhysicsSystem::SaveBody(const eid entity_id, const btRigidBody* body) {
+	const btTransform& transform = body->getWorldTransform();
+	const btVector3& origin = transform.getOrigin();
+	const btQuaternion rotation = transform.getRotation();
+	const btVector3& linear = body->getLinearVelocity();
+	const btVector3& angular = body->getAngularVelocity();
+	return PhysicsSnapshot::Body{
+			entity_id,
+			glm::vec3(origin.x(), origin.y(), origin.z()),
+			glm::quat(rotation.w(), rotation.x(), rotation.y(), rotation.z()),
+			glm::vec3(linear.x(), linear.y(), linear.z()),
+			glm::vec3(angular.x(), angular.y(), angular.z()),
+			static_cast<float>(body->getDeactivationTime()),
+			body->getActivationState()};
+}
+
+void PhysicsSystem::RestoreBody(const PhysicsSnapshot::Body& saved) {
+	btRigidBody* const* body = this->bodies.Find(saved.entity_id);
+	if (!body || !*body) {
+		return;
+	}
+	auto* collidable = static_cast<CollisionBody*>((*body)->getUserPointer());
+	const btTransform transform(
+			btQuaternion(saved.orientation.x, saved.orientation.y, saved.orientation.z, saved.orientation.w),
+			btVector3(saved.position.x, saved.position.y, saved.position.z));
+	const btVector3 linear(saved.linear_velocity.x, saved.linear_velocity.y, saved.linear_velocity.z);
+	const btVector3 angular(saved.angular_velocity.x, saved.angular_velocity.y, saved.angular_velocity.z);
+	(*body)->setWorldTransform(transform);
+	(*body)->setInterpolationWorldTransform(transform);
+	(*body)->setLinearVelocity(linear);
+	(*body)->setInterpolationLinearVelocity(linear);
+	(*body)->setAngularVelocity(angular);
+	(*body)->setInterpolationAngularVelocity(angular);
+	ResetBody(*body);
+	(*body)->forceActivationState(saved.activation_state);
+	(*body)->setDeactivationTime(saved.deactivation_time);
+	// let the motion state hand the transform to the entity's components, without reporting a
+	// move a later step wouldn't clear
+	collidable->motion_state.setWorldTransform(transform);
+	collidable->motion_state.transform_updated = false;
+}
+
+void PhysicsSystem::ResetBody(btRigidBody* body) {
+	body->clearForces();
+	if (btBroadphaseProxy* proxy = body->getBroadphaseHandle()) {
+		this->dynamicsWorld->getBroadphase()->getOverlappingPairCache()->cleanProxyFromPairs(
+				proxy, this->dispatcher);
+		this->dynamicsWorld->updateSingleAabb(body);
+	}
+	body->activate(true);
+}
+
+bool PhysicsSystem::SyncBody(
+		const eid entity_id,
+		CollisionBody* collidable,
+		btRigidBody* body,
+		const GameState& state,
+		const bool position_changed,
+		const bool orientation_changed) {
+	// fill in the transform for our collidable from the current state
+	if (position_changed) {
 		auto position_iter = state.positions.find(entity_id);
 		if (position_iter != state.positions.end()) {
 			glm::vec3 position = position_iter->second.value;
@@ -67,8 +393,10 @@ std::set<eid> PhysicsSystem::Update(const double delta, const GameState& state)
 		else {
 			// no position! that's not good
 			// wait to add the physics body to the world for now
-			continue;
+			return false;
 		}
+	}
+	if (orientation_changed) {
 		auto orientation_iter = state.orientations.find(entity_id);
 		if (orientation_iter != state.orientations.end()) {
 			glm::quat orientation = orientation_iter->second.value;
@@ -78,91 +406,187 @@ std::set<eid> PhysicsSystem::Update(const double delta, const GameState& state)
 						btQuaternion(orientation.x, orientation.y, orientation.z, orientation.w));
 			}
 		}
+	}
 
-		btRigidBody* body = this->bodies[entity_id];
-		if (!body) {
-			continue;
+	// handle changes to desired deactivation mode
+	if (collidable->disable_deactivation) {
+		body->forceActivationState(DISABLE_DEACTIVATION);
+	}
+	else if (body->getActivationState() == DISABLE_DEACTIVATION) {
+		body->forceActivationState(ACTIVE_TAG);
+	}
+
+	// here we add the body to the world if it's not yet
+	// this can later expand to handling multiple dynamics worlds if need be
+	if (!collidable->in_world) {
+		// TODO if we want to change any of these parameters later, we *might* have to remove the body from the world.
+		// The Bullet documentation is rather unhelpful in this regard.
+		// so for now we'll just update them when we put it in the world.
+
+		// if the mass changed, update mass related parameters.
+		if (collidable->mass != body->getInvMass()) {
+			btVector3 fallInertia(0, 0, 0);
+			collidable->shape->calculateLocalInertia(collidable->mass, fallInertia);
+			body->setMassProps(collidable->mass, fallInertia);
+			body->updateInertiaTensor();
+			body->clearForces();
 		}
 
-		// handle changes to desired deactivation mode
-		if (collidable->disable_deactivation) {
-			body->forceActivationState(DISABLE_DEACTIVATION);
+		// prevent the simulation from rotating the object
+		// this doesn't account for change after creation, once disabled there isn't a re-enable
+		if (collidable->disable_rotation) {
+			body->setAngularFactor(btVector3(0.0, 0, 0.0));
 		}
-		else if (body->getActivationState() == DISABLE_DEACTIVATION) {
-			body->forceActivationState(ACTIVE_TAG);
+
+		// snap the body to its position when we add it
+		body->setWorldTransform(collidable->motion_state.transform);
+		collidable->in_world = true;
+		this->dynamicsWorld->addRigidBody(body);
+	}
+	else if (position_changed || orientation_changed) {
+		btTransform& body_transform = body->getWorldTransform();
+		// simulation motion estimation lite
+		// on the server, this doesn't really do anything
+		// on the client however, this smooths out the motion between the local estimation and server state
+		// this provides a crude but effective error correction until a better one is added ;)
+		if (body_transform.getOrigin().distance(collidable->motion_state.transform.getOrigin()) > 0.01) {
+			// FIXME there is a race condition outside of PhysicsSystem, where the position of the entity
+			// is momentarily at origin (0,0,0) during entity creation (affects server)
+			body->translate(0.5 * (collidable->motion_state.transform.getOrigin() - body_transform.getOrigin()));
+			// use this to snap back to the current state, it's unpleasent without any form of restitution
+			//body_transform.setOrigin(collidable->motion_state.transform.getOrigin());
 		}
+		// for now, just always update the orientation
+		body_transform.setBasis(collidable->motion_state.transform.getBasis());
+	}
 
-		// here we add the body to the world if it's not yet
-		// this can later expand to handling multiple dynamics worlds if need be
-		if (!collidable->in_world) {
-			// TODO if we want to change any of these parameters later, we *might* have to remove the body from the world.
-			// The Bullet documentation is rather unhelpful in this regard.
-			// so for now we'll just update them when we put it in the world.
-
-			// if the mass changed, update mass related parameters.
-			if (collidable->mass != body->getInvMass()) {
-				btVector3 fallInertia(0, 0, 0);
-				collidable->shape->calculateLocalInertia(collidable->mass, fallInertia);
-				body->setMassProps(collidable->mass, fallInertia);
-				body->updateInertiaTensor();
-				body->clearForces();
-			}
+	// copy in the velocities from the state, a moving body would otherwise drift under gravity
+	auto velocity_iter = state.velocities.find(entity_id);
+	if (velocity_iter != state.velocities.end()) {
+		ApplyVelocity(body, velocity_iter->second);
+	}
+	return true;
+}
 
-			// prevent the simulation from rotating the object
-			// this doesn't account for change after creation, once disabled there isn't a re-enable
-			if (collidable->disable_rotation) {
-				body->setAngularFactor(btVector3(0.0, 0, 0.0));
-			}
+void PhysicsSystem::ApplyVelocity(btRigidBody* body, const Velocity& vel) {
+	if (std::isfinite(vel.linear.x) && std::isfinite(vel.linear.y) && std::isfinite(vel.linear.z)) {
+		body->setLinearVelocity(vel.GetLinear() + body->getGravity());
+	}
+	if (std::isfinite(vel.angular.x) && std::isfinite(vel.angular.y) && std::isfinite(vel.angular.z)) {
+		body->setAngularVelocity(vel.GetAngular());
+	}
+}
 
-			// snap the body to its position when we add it
-			body->setWorldTransform(collidable->motion_state.transform);
-			collidable->in_world = true;
-			this->dynamicsWorld->addRigidBody(body);
-		}
-		else {
-			btTransform& body_transform = body->getWorldTransform();
-			// simulation motion estimation lite
-			// on the server, this doesn't really do anything
-			// on the client however, this smooths out the motion between the local estimation and server state
-			// this provides a crude but effective error correction until a better one is added ;)
-			if (body_transform.getOrigin().distance(collidable->motion_state.transform.getOrigin()) > 0.01) {
-				// FIXME there is a race condition outside of PhysicsSystem, where the position of the entity
-				// is momentarily at origin (0,0,0) during entity creation (affects server)
-				body->translate(0.5 * (collidable->motion_state.transform.getOrigin() - body_transform.getOrigin()));
-				// use this to snap back to the current state, it's unpleasent without any form of restitution
-				//body_transform.setOrigin(collidable->motion_state.transform.getOrigin());
-			}
-			// for now, just always update the orientation
-			body_transform.setBasis(collidable->motion_state.transform.getBasis());
-		}
+namespace {
+const std::size_t QUERY_GRAIN = 16;
 
-		// always copy in the velocities from the state
-		auto velocity_iter = state.velocities.find(entity_id);
-		if (velocity_iter != state.velocities.end()) {
-			const Velocity& vel = velocity_iter->second;
-			if (std::isfinite(vel.linear.x) && std::isfinite(vel.linear.y) && std::isfinite(vel.linear.z)) {
-				body->setLinearVelocity(vel.GetLinear() + body->getGravity());
-			}
-			if (std::isfinite(vel.angular.x) && std::isfinite(vel.angular.y) && std::isfinite(vel.angular.z)) {
-				body->setAngularVelocity(vel.GetAngular());
-			}
+btVector3 ToBullet(const glm::vec3& vector) { return btVector3(vector.x, vector.y, vector.z); }
+
+glm::vec3 FromBullet(const btVector3& vector) { return glm::vec3(vector.x(), vector.y(), vector.z()); }
+
+bool IsIgnored(const btBroadphaseProxy* proxy, const PhysicsQuery& query) {
+	if (query.ignore_entity == 0 && query.ignore_other_entity == 0) {
+		return false;
+	}
+	const auto* object = static_cast<const btCollisionObject*>(proxy->m_clientObject);
+	const auto* collidable = static_cast<const CollisionBody*>(object->getUserPointer());
+	return collidable && collidable->entity_id != 0
+		   && (collidable->entity_id == query.ignore_entity || collidable->entity_id == query.ignore_other_entity);
+}
+
+eid GetEntity(const btCollisionObject* object) {
+	const auto* collidable = static_cast<const CollisionBody*>(object->getUserPointer());
+	return collidable ? collidable->entity_id : 0;
+}
+
+struct ClosestRayCallback : public btCollisionWorld::ClosestRayResultCallback {
+	ClosestRayCallback(const btVector3& from, const btVector3& to, const PhysicsQuery& _query) :
+			ClosestRayResultCallback(from, to), query(_query) {}
+
+	bool needsCollision(btBroadphaseProxy* proxy) const override {
+		return ClosestRayResultCallback::needsCollision(proxy) && !IsIgnored(proxy, this->query);
+	}
+
+	const PhysicsQuery& query;
+};
+
+struct ClosestSweepCallback : public btCollisionWorld::ClosestConvexResultCallback {
+	ClosestSweepCallback(const btVector3& from, const btVector3& to, const PhysicsQuery& _query) :
+			ClosestConvexResultCallback(from, to), query(_query) {}
+
+	bool needsCollision(btBroadphaseProxy* proxy) const override {
+		return ClosestConvexResultCallback::needsCollision(proxy) && !IsIgnored(proxy, this->query);
+	}
+
+	const PhysicsQuery& query;
+};
+
+// Everything here only reads the world, the callbacks and sweep shapes live on the stack.
+PhysicsQueryHit RunQuery(const btCollisionWorld& world, const PhysicsQuery& query) {
+	const btVector3 from = ToBullet(query.from);
+	const btVector3 to = ToBullet(query.to);
+	PhysicsQueryHit result;
+	if (query.shape == PhysicsQuery::Shape::Ray) {
+		ClosestRayCallback callback(from, to, query);
+		world.rayTest(from, to, callback);
+		if (callback.hasHit()) {
+			result.hit = true;
+			result.entity_id = GetEntity(callback.m_collisionObject);
+			result.fraction = static_cast<float>(callback.m_closestHitFraction);
+			result.distance = result.fraction * glm::distance(query.from, query.to);
+			result.point = FromBullet(callback.m_hitPointWorld);
+			result.normal = FromBullet(callback.m_hitNormalWorld);
 		}
+		return result;
 	}
 
-	// using a delta time here makes physics far less deterministic
-	// this can be changed if it becomes a problem
-	this->dynamicsWorld->stepSimulation(static_cast<btScalar>(delta), this->simulation_substeps);
-
-	// build a set of entity IDs that changed this step
-	std::set<eid> updated_entities;
-	for (auto itr = CollisionBodyMap::Begin(); itr != CollisionBodyMap::End(); ++itr) {
-		auto entity_id = itr->first;
-		if (itr->second->motion_state.transform_updated) {
-			updated_entities.insert(entity_id);
-			itr->second->motion_state.transform_updated = false;
+	const btQuaternion rotation =
+			query.shape == PhysicsQuery::Shape::Box
+					? btQuaternion(query.orientation.x, query.orientation.y, query.orientation.z, query.orientation.w)
+					: btQuaternion::getIdentity();
+	const btTransform from_transform(rotation, from);
+	const btTransform to_transform(rotation, to);
+	ClosestSweepCallback callback(from, to, query);
+	if (query.shape == PhysicsQuery::Shape::Box) {
+		const btBoxShape box(ToBullet(query.half_extents));
+		world.convexSweepTest(&box, from_transform, to_transform, callback);
+	}
+	else {
+		const btSphereShape sphere(query.radius);
+		world.convexSweepTest(&sphere, from_transform, to_transform, callback);
+	}
+	if (callback.hasHit()) {
+		result.hit = true;
+		result.entity_id = GetEntity(callback.m_hitCollisionObject);
+		result.fraction = static_cast<float>(callback.m_closestHitFraction);
+		result.distance = result.fraction * glm::distance(query.from, query.to);
+		result.point = FromBullet(callback.m_hitPointWorld);
+		result.normal = FromBullet(callback.m_hitNormalWorld);
+	}
+	return result;
+}
+} // namespace
+
+void PhysicsSystem::Query(
+		const std::span<const PhysicsQuery> queries,
+		const std::span<PhysicsQueryHit> results,
+		const bool parallel) const {
+	if (results.size() < queries.size()) {
+		throw std::invalid_argument("PhysicsSystem::Query needs a result for every query");
+	}
+	std::shared_lock world_lock(this->world_mutex);
+	const btCollisionWorld& world = *this->dynamicsWorld;
+	if (!parallel || queries.size() <= QUERY_GRAIN) {
+		for (std::size_t i = 0; i < queries.size(); ++i) {
+			results[i] = RunQuery(world, queries[i]);
 		}
+		return;
 	}
-	return updated_entities;
+	JobSystem::Get().ParallelFor(0, queries.size(), QUERY_GRAIN, [&](const std::size_t begin, const std::size_t end) {
+		for (std::size_t i = begin; i < end; ++i) {
+			results[i] = RunQuery(world, queries[i]);
+		}
+	});
 }
 
 glm::vec3 GetRayDirection(
@@ -181,121 +605,63 @@ glm::vec3 GetRayDirection(
 	return ray_direction_WORLD;
 }
 
-eid PhysicsSystem::RayCastMousePick(
-		eid source_entity, double mouse_x, double mouse_y, float screen_width, float screen_height) {
-	if (source_entity == 0) {
-		return 0;
+PhysicsQueryHit PhysicsSystem::RayCastMousePick(
+		eid source_entity, double mouse_x, double mouse_y, float screen_width, float screen_height) const {
+	if (source_entity == 0 || screen_height == 0.0f) {
+		return {};
 	}
-	auto body_iter = this->bodies.find(source_entity);
-	if (this->bodies.find(source_entity) == this->bodies.end()) {
-		return 0;
+	const std::optional<btTransform> source = GetBodyTransform(source_entity);
+	if (!source) {
+		return {};
 	}
-	this->last_rayvalid = false;
-	this->last_entity_hit = 0;
-
-	auto* body = static_cast<CollisionBody*>(body_iter->second->getUserPointer());
-	auto pos = body->motion_state.transform.getOrigin();
-	glm::vec3 position(pos.x(), pos.y(), pos.z());
-	auto rot = body->motion_state.transform.getRotation();
-	glm::quat orientation(rot.w(), rot.x(), rot.y(), rot.z());
+	const glm::vec3 position = FromBullet(source->getOrigin());
+	const btQuaternion rot = source->getRotation();
+	const glm::quat orientation(rot.w(), rot.x(), rot.y(), rot.z());
 
-	if (screen_height == 0.0f) {
-		return 0;
-	}
 	// TODO: This could be pulled from something but it seems unlikely to change.
 	static glm::mat4 projection = glm::perspective(glm::radians(45.0f), screen_width / screen_height, -1.0f, 300.0f);
 	glm::mat4 view = glm::inverse(glm::translate(glm::mat4(1.0), position) * glm::mat4_cast(orientation));
 
-	glm::vec3 world_direction = position
-								- GetRayDirection(
-										  static_cast<float>(mouse_x),
-										  static_cast<float>(mouse_y),
-										  screen_width,
-										  screen_height,
-										  view,
-										  projection)
-										  * 100.0f;
-
-	btVector3 from(position.x, position.y, position.z), to(world_direction.x, world_direction.y, world_direction.z);
-	this->last_rayfrom = from;
-	btDynamicsWorld::AllHitsRayResultCallback ray_result_callback(from, to);
-	this->dynamicsWorld->rayTest(from, to, ray_result_callback);
-	if (ray_result_callback.hasHit()) {
-		int collision_object_count = ray_result_callback.m_collisionObjects.size();
-		double lastfrac = 1.1;
-		int hit_entity_index = collision_object_count;
-		eid hit_entity = 0;
-		for (int i = 0; i < collision_object_count; i++) {
-			eid entity = 0;
-			double frc = ray_result_callback.m_hitFractions.at(i);
-			const auto* colbody = (const CollisionBody*)ray_result_callback.m_collisionObjects.at(i)->getUserPointer();
-			if (!colbody) {
-				continue;
-			}
-			entity = colbody->entity_id;
-			if (entity && entity != source_entity) {
-				if (frc < lastfrac) {
-					hit_entity = entity;
-					hit_entity_index = i;
-					lastfrac = frc;
-				}
-			}
-		}
-		this->last_entity_hit = hit_entity;
-		if (hit_entity_index < collision_object_count) {
-			this->last_raypos = ray_result_callback.m_hitPointWorld.at(hit_entity_index);
-			this->last_raynorm = ray_result_callback.m_hitNormalWorld.at(hit_entity_index);
-			this->last_raydist = last_rayfrom.distance(this->last_raypos);
-			this->last_rayvalid = true;
-		}
+	PhysicsQuery query;
+	query.from = position;
+	query.to = position
+			   - GetRayDirection(
+						 static_cast<float>(mouse_x),
+						 static_cast<float>(mouse_y),
+						 screen_width,
+						 screen_height,
+						 view,
+						 projection)
+						 * 100.0f;
+	query.ignore_entity = source_entity;
+	PhysicsQueryHit hit;
+	Query(std::span(&query, 1), std::span(&hit, 1));
+	return hit;
+}
+
+PhysicsQueryHit PhysicsSystem::RayCastIgnore(eid source_entity, eid ignore_entity) const {
+	const std::optional<btTransform> source = GetBodyTransform(source_entity);
+	if (!source) {
+		return {};
 	}
-	return this->last_entity_hit;
-}
-
-eid PhysicsSystem::RayCastIgnore(eid source_entity, eid ignore_entity) {
-	last_rayvalid = false;
-	glm::vec3 position;
-	if (Entity(source_entity).Has<Position>()) {
-		position = (Entity(source_entity).Get<Position>())->value;
-	}
-	glm::quat orientation;
-	if (Entity(source_entity).Has<Orientation>()) {
-		orientation = (Entity(source_entity).Get<Orientation>())->value;
-	}
-	auto fv = position + glm::rotate(orientation, FORWARD_VECTOR * 300.f);
-	btVector3 from(position.x, position.y, position.z), to(fv.x, fv.y, fv.z);
-	last_rayfrom = from;
-	btDynamicsWorld::AllHitsRayResultCallback cr(from, to);
-	this->dynamicsWorld->rayTest(from, to, cr);
-	if (cr.hasHit()) {
-		int mx = cr.m_collisionObjects.size();
-		double lastfrac = 1.1;
-		int hc = mx;
-		eid entity_hit = 0;
-		for (int i = 0; i < mx; i++) {
-			eid entity = 0;
-			double frc = cr.m_hitFractions.at(i);
-			const auto* coll = (const CollisionBody*)cr.m_collisionObjects.at(i)->getUserPointer();
-			if (!coll)
-				continue;
-			entity = coll->entity_id;
-			if (entity && entity != source_entity && entity != ignore_entity) {
-				if (frc < lastfrac) {
-					entity_hit = entity;
-					hc = i;
-					lastfrac = frc;
-				}
-			}
-		}
-		if (hc < mx) {
-			last_raypos = cr.m_hitPointWorld.at(hc);
-			last_raynorm = cr.m_hitNormalWorld.at(hc);
-			last_raydist = last_rayfrom.distance(last_raypos);
-			last_rayvalid = true;
-			return entity_hit;
-		}
+	const btQuaternion rot = source->getRotation();
+	PhysicsQuery query;
+	query.from = FromBullet(source->getOrigin());
+	query.to = query.from + glm::rotate(glm::quat(rot.w(), rot.x(), rot.y(), rot.z()), FORWARD_VECTOR * 300.f);
+	query.ignore_entity = source_entity;
+	query.ignore_other_entity = ignore_entity;
+	PhysicsQueryHit hit;
+	Query(std::span(&query, 1), std::span(&hit, 1));
+	return hit;
+}
+
+std::optional<btTransform> PhysicsSystem::GetBodyTransform(const eid entity_id) const {
+	std::shared_lock world_lock(this->world_mutex);
+	const btRigidBody* const* body = this->bodies.Find(entity_id);
+	if (!body || !*body) {
+		return std::nullopt;
 	}
-	return 0;
+	return static_cast<const CollisionBody*>((*body)->getUserPointer())->motion_state.transform;
 }
 
 void PhysicsSystem::DebugDraw() {
@@ -306,15 +672,15 @@ void PhysicsSystem::DebugDraw() {
 	// #endif
 }
 
-void PhysicsSystem::SetGravity(const unsigned int entity_id, const btVector3& f) {
-	if (this->bodies.find(entity_id) != this->bodies.end()) {
-		this->bodies[entity_id]->setGravity(f);
+void PhysicsSystem::SetGravity(const eid entity_id, const btVector3& f) {
+	if (btRigidBody* const* body = this->bodies.Find(entity_id)) {
+		(*body)->setGravity(f);
 	}
 }
 
-void PhysicsSystem::SetNormalGravity(const unsigned int entity_id) {
-	if (this->bodies.find(entity_id) != this->bodies.end()) {
-		this->bodies[entity_id]->setGravity(this->dynamicsWorld->getGravity());
+void PhysicsSystem::SetNormalGravity(const eid entity_id) {
+	if (btRigidBody* const* body = this->bodies.Find(entity_id)) {
+		(*body)->setGravity(this->dynamicsWorld->getGravity());
 	}
 }
 
@@ -338,60 +704,66 @@ bool PhysicsSystem::AddRigidBody(CollisionBody* collision_body) {
 			collision_body->mass, &collision_body->motion_state, collision_body->shape.get(), fallInertia);
 	auto body = new btRigidBody(fallRigidBodyCI);
 
-	this->bodies[entity_id] = body;
+	this->bodies.Set(entity_id, body);
+	if (collision_body->mass > 0.0) {
+		this->dynamic_bodies.Set(entity_id, body);
+	}
+	// it enters the world on the next Update(), once the state has a position for it
+	this->pending_bodies.push_back(entity_id);
+	collision_body->motion_state.transform_updated = false;
+	collision_body->motion_state.moved_list = &this->moved_bodies;
 
 	body->setUserPointer(collision_body);
 	return true;
 }
 
 void PhysicsSystem::RemoveRigidBody(eid entity_id) {
-	if (this->bodies.find(entity_id) != this->bodies.end()) {
-		if (this->bodies.at(entity_id)) {
-			this->dynamicsWorld->removeRigidBody(this->bodies.at(entity_id));
-			delete this->bodies.at(entity_id);
-		}
-	}
-}
-
-void PhysicsSystem::On(eid, std::shared_ptr<MouseBtnEvent> data) {
-	if (data->action == MouseBtnEvent::DOWN) {
-		if (this->last_entity_hit) {
-			std::shared_ptr<MouseClickEvent> mce_event = std::make_shared<MouseClickEvent>();
-			mce_event->button = data->button;
-			mce_event->ray_distance = this->last_raydist;
-			mce_event->ray_hit_point_world =
-					glm::vec3(this->last_raypos.getX(), this->last_raypos.getY(), this->last_raypos.getZ());
-			EventSystem<MouseClickEvent>::Get()->Emit(this->last_entity_hit, mce_event);
+	if (btRigidBody* const* body = this->bodies.Find(entity_id)) {
+		if (*body) {
+			this->dynamicsWorld->removeRigidBody(*body);
+			delete *body;
 		}
+		// don't leave a dangling body behind for the next Update()
+		this->bodies.Remove(entity_id);
+		this->dynamic_bodies.Remove(entity_id);
 	}
 }
 
 void PhysicsSystem::On(eid, std::shared_ptr<EntityCreated> data) {
 	eid entity_id = data->entity.id();
+	CreatedComponents* created = this->created_components.Find(entity_id);
+	if (!created) {
+		created = &this->created_components.Set(entity_id, {});
+	}
 	for (int i = 0; i < data->entity.components_size(); ++i) {
 		const proto::Component& comp = data->entity.components(i);
 		switch (comp.component_case()) {
 		case proto::Component::kCollisionBody:
 		{
-			auto* collision_body = new CollisionBody();
+			auto* collision_body = ComponentPool<CollisionBody>::Create();
 			collision_body->In(comp);
-			CollisionBodyMap::Set(entity_id, collision_body);
 			collision_body->entity_id = entity_id;
+			// The old rigid body points at the motion state of the collision body being replaced.
+			RemoveRigidBody(entity_id);
+			Entity(entity_id).Update(collision_body);
+			created->collision_body = collision_body;
 			AddRigidBody(collision_body);
 			break;
 		}
 		case proto::Component::kPosition:
 		{
-			auto* position = new Position();
+			auto* position = ComponentPool<Position>::Create();
 			position->In(comp);
-			Multiton<eid, Position*>::Set(entity_id, position);
+			Entity(entity_id).Update(position);
+			created->position = position;
 			break;
 		}
 		case proto::Component::kOrientation:
 		{
-			auto* orientation = new Orientation();
+			auto* orientation = ComponentPool<Orientation>::Create();
 			orientation->In(comp);
-			Multiton<eid, Orientation*>::Set(entity_id, orientation);
+			Entity(entity_id).Update(orientation);
+			created->orientation = orientation;
 			break;
 		}
 		default: break;
@@ -400,28 +772,29 @@ void PhysicsSystem::On(eid, std::shared_ptr<EntityCreated> data) {
 }
 
 void PhysicsSystem::On(eid entity_id, std::shared_ptr<EntityDestroyed> data) {
-	CollisionBodyMap::Remove(entity_id);
+	Entity entity(entity_id);
 	RemoveRigidBody(entity_id);
-	this->bodies.erase(entity_id); // There isn't a chance it will be re-added.
-	PositionMap::Remove(entity_id);
-	OrientationMap::Remove(entity_id);
+	entity.Remove<CollisionBody>();
+	entity.Remove<Position>();
+	entity.Remove<Orientation>();
+	this->created_components.Remove(entity_id);
 }
 
 Position PhysicsSystem::GetPosition(eid entity_id) {
-	auto body_iter = this->bodies.find(entity_id);
-	if (body_iter != this->bodies.end() && body_iter->second) {
-		//CollisionBody* body = static_cast<CollisionBody*>(body_iter->second->getUserPointer());
-		auto pos = body_iter->second->getWorldTransform().getOrigin();
+	btRigidBody* const* body = this->bodies.Find(entity_id);
+	if (body && *body) {
+		//CollisionBody* body = static_cast<CollisionBody*>((*body)->getUserPointer());
+		auto pos = (*body)->getWorldTransform().getOrigin();
 		return glm::vec3(pos.x(), pos.y(), pos.z());
 	}
 	return glm::vec3();
 }
 
 Orientation PhysicsSystem::GetOrientation(eid entity_id) {
-	auto body_iter = this->bodies.find(entity_id);
-	if (body_iter != this->bodies.end() && body_iter->second) {
-		//CollisionBody* body = static_cast<CollisionBody*>(body_iter->second->getUserPointer());
-		auto rot = body_iter->second->getWorldTransform().getRotation();
+	btRigidBody* const* body = this->bodies.Find(entity_id);
+	if (body && *body) {
+		//CollisionBody* body = static_cast<CollisionBody*>((*body)->getUserPointer());
+		auto rot = (*body)->getWorldTransform().getRotation();
 		return glm::quat(rot.w(), rot.x(), rot.y(), rot.z());
 	}
 	return glm::quat();
@@ -1,88 +1,287 @@
 #pragma once
 
+#include <cstddef>
 #include <map>
 #include <memory>
+#include <memory_resource>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <vector>
 
 #include <btBulletDynamicsCommon.h>
 #include <glm/glm.hpp>
 
 #include "command-queue.hpp"
+#include "component-store.hpp"
 #include "event-system.hpp"
 #include "game-state.hpp"
+#include "ring-buffer.hpp"
 #include "tec-types.hpp"
 
+class btConstraintSolverPoolMt;
+
 namespace tec {
 struct CollisionBody;
-struct MouseBtnEvent;
 struct EntityCreated;
 struct EntityDestroyed;
 
+/// Opt-in multithreaded stepping, see PhysicsSystem(const PhysicsThreading&).
+struct PhysicsThreading {
+	std::size_t thread_count = 0; // Threads a step is spread over including the caller, 0 stays single threaded.
+	int island_batch_size = 50; // Islands with fewer bodies and constraints than this are solved together.
+	int dispatcher_grain_size = 40; // Overlapping pairs per task when updating contacts.
+};
+
+/// One ray or shape sweep of a batch, see PhysicsSystem::Query().
+struct PhysicsQuery {
+	enum class Shape { Ray, Sphere, Box };
+
+	Shape shape{Shape::Ray};
+	glm::vec3 from{0.f};
+	glm::vec3 to{0.f};
+	float radius{0.5f}; // Of a sphere.
+	glm::vec3 half_extents{0.5f}; // Of a box.
+	glm::quat orientation{1.f, 0.f, 0.f, 0.f}; // Of a box.
+	eid ignore_entity{0}; // Usually the entity asking, 0 to ignore nothing.
+	eid ignore_other_entity{0}; // Another entity to ignore, 0 for none.
+};
+
+/// The closest hit of a PhysicsQuery.
+struct PhysicsQueryHit {
+	bool hit{false};
+	eid entity_id{0}; // 0 if the body hit has no entity.
+	float fraction{1.f}; // Of the way from the query's from to its to.
+	float distance{0.f}; // From the query's from to the point.
+	glm::vec3 point{0.f};
+	glm::vec3 normal{0.f};
+};
+
+/// The dynamic bodies of the world at one point in time, see PhysicsSystem::SaveSnapshot().
+struct PhysicsSnapshot {
+	struct Body {
+		eid entity_id{0};
+		glm::vec3 position{0.f};
+		glm::quat orientation{1.f, 0.f, 0.f, 0.f};
+		glm::vec3 linear_velocity{0.f};
+		glm::vec3 angular_velocity{0.f};
+		float deactivation_time{0.f};
+		int activation_state{0};
+	};
+
+	state_id_t id{0};
+	std::vector<Body> bodies;
+};
+
 class PhysicsSystem :
 		public CommandQueue<PhysicsSystem>,
-		EventQueue<MouseBtnEvent>,
 		EventQueue<EntityCreated>,
 		EventQueue<EntityDestroyed> {
 public:
-	PhysicsSystem();
+	/**
+	* \brief Create the world, single threaded unless threading.thread_count is set.
+	*
+	* A threaded world runs Bullet's parallel loops on the JobSystem through BulletTaskScheduler.
+	* Bullet only has one scheduler per process: the first threaded system has to be created before
+	* other threads use Bullet, threaded systems have to be updated from one thread, and the last
+	* created sets the thread count for all. The world stays single threaded if the JobSystem has
+	* more workers than Bullet can number, see BulletTaskScheduler::FitsJobSystem().
+	* \param[in] const PhysicsThreading& threading The thread count and batching of a threaded world.
+	*/
+	explicit PhysicsSystem(const PhysicsThreading& threading = {});
 	~PhysicsSystem();
 
+	/// Whether the world steps on several threads, see PhysicsThreading.
+	bool IsThreaded() const { return this->solver_pool != nullptr; }
+
 	// sets a different substep limit, if zero, then update delta must be a constant
 	void SetSubstepping(int substep) { simulation_substeps = substep; }
 
-	std::set<eid> Update(double delta, const GameState& state);
+	/**
+	* \brief Sync the bodies the state changed into the world and step it.
+	*
+	* Only bodies whose position, orientation or velocity changed since the last call, that moved
+	* during the last step, or that are still waiting to enter the world are touched.
+	* \param[in] const double delta The time to step.
+	* \param[in] const GameState& state The state to read transforms and velocities from.
+	* \return std::pmr::vector<eid> The sorted IDs of the entities that moved, allocated from the
+	* calling thread's TickArena.
+	*/
+	std::pmr::vector<eid> Update(double delta, const GameState& state);
 
-	eid RayCastMousePick(
+	/**
+	* \brief Find the closest hit of every query in a batch.
+	*
+	* Safe to call from any thread, also while other batches run. A batch sees the world as one
+	* step left it, Update() waits for running batches before it changes the world and batches
+	* wait for an Update() to finish.
+	* \param[in] std::span<const PhysicsQuery> queries The rays and sweeps to test.
+	* \param[out] std::span<PhysicsQueryHit> results The hit of queries[i] goes to results[i].
+	* \param[in] const bool parallel Spread the batch over the JobSystem's workers.
+	* \throws std::invalid_argument if results is shorter than queries.
+	*/
+	void Query(std::span<const PhysicsQuery> queries, std::span<PhysicsQueryHit> results, bool parallel = false) const;
+
+	/// How many snapshots are kept, the oldest is dropped to make room for a new one.
+	static constexpr std::size_t SNAPSHOT_CAPACITY = 64;
+
+	/**
+	* \brief Save the transforms, velocities and activation of the dynamic bodies in the world.
+	*
+	* Saving an ID that's still kept replaces its snapshot. Snapshots reuse the memory of the ones
+	* they replace, so saving every step doesn't allocate once the buffer went around. Call it from
+	* the thread that updates the world.
+	* \param[in] const state_id_t id The ID to restore the snapshot by, e.g. a command ID.
+	*/
+	void SaveSnapshot(state_id_t id);
+
+	/**
+	* \brief Put the bodies back to where a snapshot has them.
+	*
+	* Bodies that were removed since are skipped, bodies added since are left where they are. The
+	* contacts of restored bodies are dropped and the solver reset, so stepping from a snapshot
+	* repeats what stepping from it did the first time.
+	* \param[in] const state_id_t id The ID the snapshot was saved with.
+	* \return bool False if there's no snapshot with that ID (anymore), the world is unchanged then.
+	*/
+	bool RestoreSnapshot(state_id_t id);
+
+	/**
+	* \brief Put only some of the bodies back to where a snapshot has them, see RestoreSnapshot(state_id_t).
+	*
+	* \param[in] const state_id_t id The ID the snapshot was saved with.
+	* \param[in] std::span<const eid> entity_ids The entities whose bodies to restore, the rest stay as they are.
+	* \return bool False if there's no snapshot with that ID (anymore), the world is unchanged then.
+	*/
+	bool RestoreSnapshot(state_id_t id, std::span<const eid> entity_ids);
+
+	/**
+	* \brief Snap bodies to the transforms and velocities in a state.
+	*
+	* Unlike Update() the bodies aren't eased towards the state and the world isn't stepped,
+	* this is for putting the world back to an authoritative state, e.g. after RestoreSnapshot().
+	* \param[in] const GameState& state The state to read transforms and velocities from.
+	*/
+	void ApplyState(const GameState& state);
+
+	/// Set the velocity of a body the way Update() syncs it from a state.
+	void SetVelocity(eid entity_id, const Velocity& velocity);
+
+	/**
+	* \brief Step the world in fixed steps without syncing anything from a state.
+	*
+	* \param[in] const int steps The number of steps.
+	* \param[in] const double step The time of each step.
+	* \return std::pmr::vector<eid> The sorted IDs of the entities that moved, allocated from the
+	* calling thread's TickArena.
+	*/
+	std::pmr::vector<eid> Resimulate(int steps, double step);
+
+	/**
+	* \brief Step the world in fixed steps, advancing only some of the bodies.
+	*
+	* The other bodies take part in the steps, so the listed ones still collide with them. Those the
+	* steps moved are put back to where they were before once done, the rest aren't touched.
+	* \param[in] const int steps The number of steps.
+	* \param[in] const double step The time of each step.
+	* \param[in] std::span<const eid> entity_ids The entities whose bodies advance.
+	* \return std::pmr::vector<eid> The sorted IDs of the listed entities that moved, allocated from
+	* the calling thread's TickArena.
+	*/
+	std::pmr::vector<eid> Resimulate(int steps, double step, std::span<const eid> entity_ids);
+
+	/**
+	* \brief Cast a ray from an entity's body through the mouse position, see Query().
+	*
+	* Safe to call from any thread like Query(), the caller keeps the hit if it needs it later.
+	* \return PhysicsQueryHit The closest hit, other than the source entity.
+	*/
+	PhysicsQueryHit RayCastMousePick(
 			eid source_entity,
 			double mouse_x = 0.0f,
 			double mouse_y = 0.0f,
 			float screen_width = 1.0f,
-			float screen_height = 1.0f);
-	eid RayCastIgnore(eid source_entity, eid ignore_entity);
-	glm::vec3 GetLastRayPos() const { return {last_raypos.getX(), last_raypos.getY(), last_raypos.getZ()}; }
-	double GetLastRayDistance() const { return last_raydist; }
-	void RaySetInvalid() { last_rayvalid = false; }
+			float screen_height = 1.0f) const;
+	/// Cast a ray forward from an entity's body, ignoring it and ignore_entity, see RayCastMousePick().
+	PhysicsQueryHit RayCastIgnore(eid source_entity, eid ignore_entity) const;
 
 	void DebugDraw();
 
-	void On(eid, std::shared_ptr<MouseBtnEvent> data) override;
 	void On(eid, std::shared_ptr<EntityCreated> data) override;
 	void On(eid, std::shared_ptr<EntityDestroyed> data) override;
 
 	Position GetPosition(eid entity_id);
 	Orientation GetOrientation(eid entity_id);
 
+	static void RegisterLuaType(sol::state&);
+
 protected:
 	/** \brief Set a rigid body's gravity.
 	*
-	* \param const unsigned int entity_id The entity ID of the rigid body.
+	* \param const eid entity_id The entity ID of the rigid body.
 	* \param btVector3 f The rigid body's new gravity.
 	*/
-	void SetGravity(unsigned int entity_id, const btVector3& f);
+	void SetGravity(eid entity_id, const btVector3& f);
 
 	/** \brief Set a rigid body's gravity to the world's gravity.
 	*
-	* \param const unsigned int entity_id The entity ID of the rigid body.
+	* \param const eid entity_id The entity ID of the rigid body.
 	*/
-	void SetNormalGravity(unsigned int entity_id);
+	void SetNormalGravity(eid entity_id);
 
 private:
 	bool AddRigidBody(CollisionBody* collision_body);
 	void RemoveRigidBody(eid entity_id);
+	/// Push the state's transform and velocity into a body, returns false if it can't enter the world yet.
+	bool SyncBody(
+			eid entity_id,
+			CollisionBody* collidable,
+			btRigidBody* body,
+			const GameState& state,
+			bool position_changed,
+			bool orientation_changed);
+	/// Set a body's velocity from a state's, on top of its gravity like the controllers expect.
+	void ApplyVelocity(btRigidBody* body, const Velocity& velocity);
+	/// Step the world and collect what moved in moved_bodies, the caller holds world_mutex exclusively.
+	void Step(double delta, int substeps);
+	/// Drop the contacts of a body that was moved by hand and wake it.
+	void ResetBody(btRigidBody* body);
+	/// Keep a sorted copy of the entities a partial restore or resimulation is about.
+	void SetListedBodies(std::span<const eid> entity_ids);
+	bool IsListed(eid entity_id) const;
+	/// The transform of an entity's body as its motion state has it, taken under the shared lock.
+	std::optional<btTransform> GetBodyTransform(eid entity_id) const;
+	/// The kept snapshot saved with the ID, if any.
+	PhysicsSnapshot* FindSnapshot(state_id_t id);
+	/// The transform, velocities and activation of a body.
+	static PhysicsSnapshot::Body SaveBody(eid entity_id, const btRigidBody* body);
+	/// Put a body back to a saved state, the caller holds world_mutex exclusively.
+	void RestoreBody(const PhysicsSnapshot::Body& saved);
 
 	btBroadphaseInterface* broadphase;
 	btCollisionConfiguration* collisionConfiguration;
 	btCollisionDispatcher* dispatcher;
-	btSequentialImpulseConstraintSolver* solver;
+	btConstraintSolver* solver;
+	btConstraintSolverPoolMt* solver_pool{nullptr}; // The solvers islands are spread over, if threaded.
 	btDynamicsWorld* dynamicsWorld;
+	mutable std::shared_mutex world_mutex; // Held shared by queries and exclusively while the world changes.
 	int simulation_substeps = 10;
 
-	std::map<eid, btRigidBody*> bodies;
-
-	btVector3 last_rayfrom;
-	double last_raydist{0.0};
-	btVector3 last_raypos;
-	btVector3 last_raynorm;
-	bool last_rayvalid{false};
-	eid last_entity_hit{0};
+	ComponentStore<btRigidBody*> bodies;
+	ComponentStore<btRigidBody*> dynamic_bodies; // The bodies with mass, static ones are never iterated.
+	struct CreatedComponents {
+		CollisionBody* collision_body{nullptr};
+		Position* position{nullptr};
+		Orientation* orientation{nullptr};
+	};
+	ComponentStore<CreatedComponents> created_components; // Made by the event handlers, released with the system.
+	std::vector<eid> pending_bodies; // Bodies that aren't in the world yet.
+	std::vector<eid> moved_bodies; // Filled by the motion states during a step.
+	ChangeTracker::Cursor position_cursor; // How far into the game state's changes Update() has read.
+	ChangeTracker::Cursor orientation_cursor;
+	ChangeTracker::Cursor velocity_cursor;
+	RingBuffer<PhysicsSnapshot, SNAPSHOT_CAPACITY> snapshots; // Oldest first.
+	std::vector<eid> listed_bodies; // Sorted, see SetListedBodies().
+	ComponentStore<PhysicsSnapshot::Body> held_bodies; // The state of the bodies a partial Resimulate() may put back.
 };
 } // end namespace tec
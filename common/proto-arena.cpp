@@ -0,0 +1,31 @@
+#include "proto-arena.hpp"
+
+namespace tec {
+ProtoArena::ProtoArena(const std::size_t initial_block_size) :
+		block(new char[initial_block_size]), block_size(initial_block_size) {
+	Start();
+}
+
+ProtoArena& ProtoArena::ForThread() {
+	thread_local ProtoArena arena;
+	return arena;
+}
+
+void ProtoArena::Reset() {
+	const auto needed = static_cast<std::size_t>(this->arena->SpaceAllocated());
+	this->arena.reset();
+	if (needed > this->block_size) {
+		// with some slack, so a slowly growing world doesn't regrow the block every tick
+		this->block_size = needed + needed / 4;
+		this->block.reset(new char[this->block_size]);
+	}
+	Start();
+}
+
+void ProtoArena::Start() {
+	google::protobuf::ArenaOptions options;
+	options.initial_block = this->block.get();
+	options.initial_block_size = this->block_size;
+	this->arena.emplace(options);
+}
+} // namespace tec
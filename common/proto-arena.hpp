@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+
+#include <google/protobuf/arena.h>
+
+namespace tec {
+/**
+* \brief A google::protobuf::Arena that is reused for one message after another.
+*
+* Messages are created on Get() and all freed together by Reset(). The arena starts out in a
+* block owned by this object; when a message needed more than that, Reset() grows the block to
+* fit, so building messages of about the same size every tick stops allocating after the first.
+*
+* Not thread-safe, ForThread() gives each thread its own.
+*/
+class ProtoArena {
+public:
+	static constexpr std::size_t INITIAL_BLOCK_SIZE = 64 * 1024;
+
+	explicit ProtoArena(std::size_t initial_block_size = INITIAL_BLOCK_SIZE);
+	ProtoArena(const ProtoArena&) = delete;
+	ProtoArena& operator=(const ProtoArena&) = delete;
+
+	/// The calling thread's arena.
+	static ProtoArena& ForThread();
+
+	google::protobuf::Arena& Get() { return *this->arena; }
+
+	/// Destroy every message created on the arena.
+	void Reset();
+
+	/// Bytes in the owned block, the most the arena handles without the heap.
+	std::size_t GetBlockSize() const { return this->block_size; }
+
+private:
+	void Start();
+
+	std::unique_ptr<char[]> block;
+	std::size_t block_size;
+	std::optional<google::protobuf::Arena> arena;
+};
+} // namespace tec
@@ -73,10 +73,16 @@ void ProtoLoad(std::string filename) {
 		return;
 	}
 	_log->debug("[ProtoLoad] :\n {}", elist.DebugString());
+	std::vector<std::shared_ptr<EntityCreated>> entities;
+	entities.reserve(elist.entity_file_list_size());
 	for (int i = 0; i < elist.entity_file_list_size(); i++) {
 		Path entity_filename = Path::assets / elist.entity_file_list(i);
-		ProtoLoadEntity(entity_filename);
+		std::shared_ptr<EntityCreated> data = std::make_shared<EntityCreated>();
+		if (LoadProtoPack(entity_filename, data->entity)) {
+			entities.push_back(std::move(data));
+		}
 	}
+	EventSystem<EntityCreated>::Get()->EmitMany(entities);
 }
 
 } // namespace tec
@@ -0,0 +1,123 @@
+#include "queue-instrumentation.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+namespace tec {
+namespace {
+std::mutex& RegistryMutex() {
+	static std::mutex registry_mutex;
+	return registry_mutex;
+}
+
+std::vector<QueueInstrument*>& Registry() {
+	static std::vector<QueueInstrument*> instruments;
+	return instruments;
+}
+
+// Turns a typeid name into "MouseMoveEvent" rather than "N3tec14MouseMoveEventE".
+std::string ReadableTypeName(const char* mangled_name) {
+	std::string name = mangled_name;
+#if defined(__GNUG__)
+	int status = 0;
+	std::unique_ptr<char, decltype(&std::free)> demangled(
+			abi::__cxa_demangle(mangled_name, nullptr, nullptr, &status), &std::free);
+	if (status == 0 && demangled) {
+		name = demangled.get();
+	}
+#endif
+	// drop the namespaces and MSVC's "struct "/"class " prefix
+	if (const auto pos = name.find_last_of(": "); pos != std::string::npos) {
+		name.erase(0, pos + 1);
+	}
+	return name;
+}
+
+// Percentile p (0-1) of a histogram as the upper bound of the bucket it falls in.
+std::uint64_t Percentile(const std::vector<std::uint64_t>& histogram, const std::uint64_t total, const double p) {
+	if (total == 0) {
+		return 0;
+	}
+	const auto target = static_cast<std::uint64_t>(static_cast<double>(total - 1) * p);
+	std::uint64_t seen = 0;
+	for (std::size_t i = 0; i < histogram.size(); ++i) {
+		seen += histogram[i];
+		if (seen > target) {
+			return std::uint64_t{1} << (i + 1);
+		}
+	}
+	return std::uint64_t{1} << histogram.size();
+}
+} // namespace
+
+QueueInstrument* QueueInstrument::Create(const char* kind, const char* mangled_name) {
+	// Intentionally never destroyed, queues may still be used during static teardown.
+	auto* instrument = new QueueInstrument(kind, ReadableTypeName(mangled_name));
+	std::lock_guard lock(RegistryMutex());
+	Registry().push_back(instrument);
+	return instrument;
+}
+
+void QueueInstrument::CountHandled([[maybe_unused]] const QueueTimestamp& queued_at) {
+	this->handled.fetch_add(1, std::memory_order_relaxed);
+#ifdef TEC_EVENT_INSTRUMENTATION
+	const auto elapsed = std::chrono::steady_clock::now() - queued_at.time;
+	const auto ns = static_cast<std::uint64_t>(
+			std::max<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), 1));
+	const std::size_t bucket = std::min<std::size_t>(std::bit_width(ns) - 1, LATENCY_BUCKETS - 1);
+	this->latency_histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+	std::uint64_t max = this->latency_max_ns.load(std::memory_order_relaxed);
+	while (ns > max && !this->latency_max_ns.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {}
+#endif
+}
+
+void QueueInstrument::CountDrained(const std::size_t count) {
+	this->last_depth.store(count, std::memory_order_relaxed);
+	std::size_t max = this->max_depth.load(std::memory_order_relaxed);
+	while (count > max && !this->max_depth.compare_exchange_weak(max, count, std::memory_order_relaxed)) {}
+}
+
+QueueStats QueueInstrument::GetStats() const {
+	QueueStats stats;
+	stats.kind = this->kind;
+	stats.name = this->name;
+	stats.emitted = this->emitted.load(std::memory_order_relaxed);
+	stats.handled = this->handled.load(std::memory_order_relaxed);
+	stats.queued = std::max(this->queued.load(std::memory_order_relaxed), stats.handled);
+	stats.depth = static_cast<std::size_t>(stats.queued - stats.handled);
+	stats.last_depth = this->last_depth.load(std::memory_order_relaxed);
+	stats.max_depth = this->max_depth.load(std::memory_order_relaxed);
+	stats.latency_histogram.reserve(LATENCY_BUCKETS);
+	std::uint64_t total = 0;
+	for (const auto& bucket : this->latency_histogram) {
+		stats.latency_histogram.push_back(bucket.load(std::memory_order_relaxed));
+		total += stats.latency_histogram.back();
+	}
+	stats.latency_p50_ns = Percentile(stats.latency_histogram, total, 0.5);
+	stats.latency_p99_ns = Percentile(stats.latency_histogram, total, 0.99);
+	stats.latency_max_ns = this->latency_max_ns.load(std::memory_order_relaxed);
+	return stats;
+}
+
+std::vector<QueueStats> QueueInstrument::GetAll() {
+	std::vector<QueueStats> all;
+	{
+		std::lock_guard lock(RegistryMutex());
+		all.reserve(Registry().size());
+		for (const auto* instrument : Registry()) {
+			all.push_back(instrument->GetStats());
+		}
+	}
+	std::sort(all.begin(), all.end(), [](const QueueStats& a, const QueueStats& b) {
+		return a.kind != b.kind ? a.kind > b.kind : a.name < b.name;
+	});
+	return all;
+}
+} // namespace tec
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "tec-types.hpp"
+
+namespace tec {
+// Configure with -DTEC_EVENT_INSTRUMENTATION=ON to record per type counts, queue depths and
+// emit-to-handle latencies of every EventQueue, BufferedEventQueue and CommandQueue. Without
+// it the hooks compile to nothing and queued items carry no timestamp.
+#ifdef TEC_EVENT_INSTRUMENTATION
+inline constexpr bool QUEUE_INSTRUMENTATION = true;
+#else
+inline constexpr bool QUEUE_INSTRUMENTATION = false;
+#endif
+
+/// When an event or command was queued, an empty struct unless instrumentation is compiled in.
+struct QueueTimestamp {
+#ifdef TEC_EVENT_INSTRUMENTATION
+	std::chrono::steady_clock::time_point time{std::chrono::steady_clock::now()};
+#endif
+};
+
+/// Instrumentation of the queues of one event or command type.
+struct QueueStats {
+	std::string kind; // "event" or "command".
+	std::string name; // The event type, or the system type for commands.
+	std::uint64_t emitted{0}; // Emit() calls for events, QueueCommand() calls for commands.
+	std::uint64_t queued{0}; // Items put in a queue, an event counts once per subscriber.
+	std::uint64_t handled{0}; // Items handed to On() or run.
+	std::size_t depth{0}; // Items waiting right now.
+	std::size_t last_depth{0}; // Items handled by the last ProcessEventQueue()/ProcessCommandQueue().
+	std::size_t max_depth{0}; // Most items handled by a single call.
+	// Emit-to-handle latency, bucket i counts latencies in [2^i, 2^(i+1)) nanoseconds.
+	std::vector<std::uint64_t> latency_histogram;
+	std::uint64_t latency_p50_ns{0}; // Upper bound of the bucket holding the median.
+	std::uint64_t latency_p99_ns{0};
+	std::uint64_t latency_max_ns{0};
+
+	static void RegisterLuaType(sol::state&);
+};
+
+/**
+* \brief Lock-free counters for the queues of one event or command type.
+*
+* There is one instance per type, created on first use and never destroyed, and all of
+* them are listed by GetAll(). Only reach for them behind if constexpr (QUEUE_INSTRUMENTATION)
+* so nothing is instantiated when instrumentation is compiled out.
+*/
+class QueueInstrument {
+public:
+	static constexpr std::size_t LATENCY_BUCKETS = 40;
+
+	template <class T> static QueueInstrument& ForEvent() {
+		static QueueInstrument* instrument = Create("event", typeid(T).name());
+		return *instrument;
+	}
+
+	template <class T> static QueueInstrument& ForCommand() {
+		static QueueInstrument* instrument = Create("command", typeid(T).name());
+		return *instrument;
+	}
+
+	void CountEmitted(const std::uint64_t count = 1) { this->emitted.fetch_add(count, std::memory_order_relaxed); }
+
+	void CountQueued() { this->queued.fetch_add(1, std::memory_order_relaxed); }
+
+	/// Counts an item about to be handled, with the time it was queued at.
+	void CountHandled(const QueueTimestamp& queued_at);
+
+	/// Records how many items a single drain handled.
+	void CountDrained(std::size_t count);
+
+	QueueStats GetStats() const;
+
+	/// Get the stats of every instrumented type used so far, sorted by kind and name.
+	static std::vector<QueueStats> GetAll();
+
+private:
+	QueueInstrument(const char* kind, std::string name) : kind(kind), name(std::move(name)) {}
+
+	static QueueInstrument* Create(const char* kind, const char* mangled_name);
+
+	const char* kind;
+	const std::string name;
+	std::atomic<std::uint64_t> emitted{0};
+	std::atomic<std::uint64_t> queued{0};
+	std::atomic<std::uint64_t> handled{0};
+	std::atomic<std::size_t> last_depth{0};
+	std::atomic<std::size_t> max_depth{0};
+	std::atomic<std::uint64_t> latency_max_ns{0};
+	std::array<std::atomic<std::uint64_t>, LATENCY_BUCKETS> latency_histogram{};
+};
+} // namespace tec
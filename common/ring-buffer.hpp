@@ -16,6 +16,11 @@ public:
 		return buffer[p];
 	}
 
+	/**
+	* Return element pos of the buffer. Not bounds checks
+	*/
+	T& operator[](std::size_t pos) { return buffer[(read + pos) % N]; }
+
 	/** 
 	* Returns the last element on the container (ie, the most older)
 	*/
@@ -46,6 +51,20 @@ public:
 		}
 	}
 
+	/**
+	* Prepends a slot to the beginning of the buffer, dropping the last element if it's full, and
+	* returns it. The slot keeps what the element stored there before left, so its memory is reused
+	*/
+	T& push_front_overwrite() {
+		if (this->full()) {
+			this->pop_back();
+		}
+		T& slot = buffer[write];
+		write = (write + 1) % N;
+		elements++;
+		return slot;
+	}
+
 	/**
 	* Returns true if there is not any element stored
 	*/
@@ -1,22 +1,25 @@
 #include "simulation.hpp"
 
-#include <asio/post.hpp>
-#include <future>
+#include <algorithm>
 #include <iostream>
-#include <set>
+#include <optional>
 #include <thread>
+#include <vector>
 
 #include <commands.pb.h>
 
 #include "components/transforms.hpp"
+#include "components/velocity.hpp"
 #include "controllers/fps-controller.hpp"
+#include "entity.hpp"
 
 namespace tec {
 
 double UPDATE_RATE = 1.0 / 8.0; // 8 per second
 double TICKS_PER_SECOND = 60.0 * UPDATE_RATE;
 
-Simulation::Simulation() : worker_pool(1) {}
+Simulation::Simulation(const std::size_t worker_threads, const PhysicsThreading& physics_threading) :
+		worker_pool(std::max<std::size_t>(worker_threads, 1)), phys_sys(physics_threading) {}
 
 Simulation::~Simulation() {
 	worker_pool.stop();
@@ -27,49 +30,99 @@ GameState Simulation::Simulate(const double delta_time, GameState& interpolated_
 	ProcessCommandQueue();
 	EventQueue<KeyboardEvent>::ProcessEventQueue();
 	EventQueue<MouseBtnEvent>::ProcessEventQueue();
-	EventQueue<MouseMoveEvent>::ProcessEventQueue();
+	BufferedEventQueue<MouseMoveEvent>::ProcessEventQueue();
 	EventQueue<MouseClickEvent>::ProcessEventQueue();
 	EventQueue<ClientCommandsEvent>::ProcessEventQueue();
 	EventQueue<ControllerAddedEvent>::ProcessEventQueue();
 	EventQueue<ControllerRemovedEvent>::ProcessEventQueue();
+	// the systems below got these events before this point, so they handle them during this call
+	this->destroyed_entities.clear();
+	EventQueue<EntityDestroyed>::ProcessEventQueue();
 	EventQueue<FocusCapturedEvent>::ProcessEventQueue();
 	EventQueue<FocusBlurEvent>::ProcessEventQueue();
 
-	std::promise<void> vcomp_promise;
-	auto vcomp_future = vcomp_promise.get_future();
-	asio::post(worker_pool, [&]() {
-		vcomp_sys.Update(delta_time);
-		vcomp_promise.set_value();
+	// controllers -> (state copy | physics) -> physics results, with the vcomputers alongside
+	// physics only reads the state, so taking the copy the results go into can overlap with it
+	GameState client_state;
+	// allocated from the arena of whichever worker runs physics
+	std::optional<std::pmr::vector<eid>> phys_results;
+	this->tasks.Clear();
+	this->tasks.Add("simulate.vcomputer", [&]() { this->vcomp_sys.Update(delta_time); });
+	const TaskGraph::TaskId controllers = this->tasks.Add("simulate.controllers", [&]() {
+		for (Controller* controller : this->controllers) {
+			controller->Update(delta_time, interpolated_state, this->event_list);
+		}
+		this->event_list.mouse_button_events.clear();
+		this->event_list.mouse_move_events.clear();
+		this->event_list.keyboard_events.clear();
+		this->event_list.mouse_click_events.clear();
 	});
+	// the copy shares the change history of the interpolated state, so the physics results show up as changes
+	const TaskGraph::TaskId copy_state = this->tasks.Add(
+			"simulate.copy_state",
+			[&]() {
+				client_state = interpolated_state;
+				client_state.ShareChanges(interpolated_state);
+			},
+			{controllers});
+	const TaskGraph::TaskId physics = this->tasks.Add(
+			"simulate.physics",
+			[&]() { phys_results.emplace(this->phys_sys.Update(delta_time, interpolated_state)); },
+			{controllers},
+			// Bullet's scheduler numbers the threads stepping a threaded world, so keep it to one
+			this->phys_sys.IsThreaded() ? TaskThread::Caller : TaskThread::Pool);
+	this->tasks.Add(
+			"simulate.physics_results",
+			[&]() {
+				for (eid entity_id : *phys_results) {
+					if (interpolated_state.positions.find(entity_id) != interpolated_state.positions.end()) {
+						client_state.SetPosition(entity_id, this->phys_sys.GetPosition(entity_id));
+					}
+					if (interpolated_state.orientations.find(entity_id) != interpolated_state.orientations.end()) {
+						client_state.SetOrientation(entity_id, this->phys_sys.GetOrientation(entity_id));
+					}
+				}
+			},
+			{copy_state, physics});
+	this->tasks.Run(this->worker_pool);
 
+	return client_state;
+}
+
+bool Simulation::Replay(
+		const state_id_t acked_id,
+		const GameState& server_state,
+		const std::span<const proto::ClientCommands> commands,
+		const double step,
+		GameState& client_state) {
+	// only the controlled entities are predicted, everything else stays where the server put it last
+	std::vector<eid> predicted;
 	for (Controller* controller : this->controllers) {
-		controller->Update(delta_time, interpolated_state, this->event_list);
+		predicted.push_back(controller->entity_id);
 	}
-
-	this->event_list.mouse_button_events.clear();
-	this->event_list.mouse_move_events.clear();
-	this->event_list.keyboard_events.clear();
-	this->event_list.mouse_click_events.clear();
-
-	GameState client_state = interpolated_state;
-	std::set<eid> phys_results = phys_sys.Update(delta_time, interpolated_state);
-
-	if (phys_results.size() > 0) {
-		for (eid entity_id : phys_results) {
-			if (interpolated_state.positions.find(entity_id) != interpolated_state.positions.end()) {
-				client_state.positions[entity_id] = this->phys_sys.GetPosition(entity_id);
-			}
-			if (interpolated_state.orientations.find(entity_id) != interpolated_state.orientations.end()) {
-				client_state.orientations[entity_id] = this->phys_sys.GetOrientation(entity_id);
-			}
-			if (interpolated_state.velocities.find(entity_id) != interpolated_state.velocities.end()) {
-				client_state.velocities[entity_id] = interpolated_state.velocities.at(entity_id);
+	if (!this->phys_sys.RestoreSnapshot(acked_id, predicted)) {
+		return false;
+	}
+	this->phys_sys.ApplyState(server_state);
+	for (const proto::ClientCommands& command : commands) {
+		for (Controller* controller : this->controllers) {
+			if (controller->entity_id == command.id()) {
+				controller->ReplayClientCommands(command, step, client_state);
+				if (auto velocity = client_state.velocities.find(controller->entity_id);
+					velocity != client_state.velocities.end()) {
+					this->phys_sys.SetVelocity(controller->entity_id, velocity->second);
+				}
 			}
 		}
+		this->phys_sys.Resimulate(1, step, predicted);
+		this->phys_sys.SaveSnapshot(command.commandid());
 	}
-	vcomp_future.wait();
-
-	return client_state;
+	for (Controller* controller : this->controllers) {
+		if (client_state.positions.find(controller->entity_id) != client_state.positions.end()) {
+			client_state.SetPosition(controller->entity_id, this->phys_sys.GetPosition(controller->entity_id));
+		}
+	}
+	return true;
 }
 
 void Simulation::AddController(Controller* controller) { this->controllers.push_back(controller); }
@@ -84,8 +137,8 @@ void Simulation::On(eid, std::shared_ptr<MouseBtnEvent> data) {
 	this->event_list.mouse_button_events.push_back(*data.get());
 }
 
-void Simulation::On(eid, std::shared_ptr<MouseMoveEvent> data) {
-	this->event_list.mouse_move_events.push_back(*data.get());
+void Simulation::On(eid, const MouseMoveEvent& data) {
+	this->event_list.mouse_move_events.push_back(data);
 }
 
 void Simulation::On(eid, std::shared_ptr<MouseClickEvent> data) {
@@ -96,6 +149,11 @@ void Simulation::On(eid, std::shared_ptr<ControllerAddedEvent> data) { AddContro
 
 void Simulation::On(eid, std::shared_ptr<ControllerRemovedEvent> data) { RemoveController(data->controller.get()); }
 
+void Simulation::On(eid entity_id, std::shared_ptr<EntityDestroyed>) {
+	Entity(entity_id).Remove<Velocity>();
+	this->destroyed_entities.push_back(entity_id);
+}
+
 /// \brief This event is sent to indicate that focus had been captured by an entity
 /// it specifies which was captured: keyboard or mouse, if either of these parameters is true,
 /// then prevent normal processing of those events
@@ -118,7 +176,7 @@ void Simulation::On(eid, std::shared_ptr<FocusBlurEvent> data) {
 
 void Simulation::On(eid, std::shared_ptr<ClientCommandsEvent> data) {
 	for (Controller* controller : this->controllers) {
-		if (static_cast<unsigned int>(controller->entity_id) == data->client_commands.id()) {
+		if (controller->entity_id == data->client_commands.id()) {
 			controller->ApplyClientCommands(data->client_commands);
 		}
 	}
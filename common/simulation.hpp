@@ -4,10 +4,14 @@
 #include <condition_variable>
 #include <memory>
 #include <queue>
+#include <span>
 #include <thread>
+#include <vector>
 
+#include "event-bus.hpp"
 #include "event-queue.hpp"
 #include "physics-system.hpp"
+#include "task-graph.hpp"
 #include "vcomputer-system.hpp"
 
 namespace tec {
@@ -27,38 +31,77 @@ class Simulation final :
 		public CommandQueue<Simulation>,
 		public EventQueue<KeyboardEvent>,
 		public EventQueue<MouseBtnEvent>,
-		public EventQueue<MouseMoveEvent>,
+		public BufferedEventQueue<MouseMoveEvent>,
 		public EventQueue<MouseClickEvent>,
 		public EventQueue<ClientCommandsEvent>,
 		public EventQueue<ControllerAddedEvent>,
 		public EventQueue<ControllerRemovedEvent>,
+		public EventQueue<EntityDestroyed>,
 		public EventQueue<FocusCapturedEvent>,
 		public EventQueue<FocusBlurEvent> {
 public:
-	Simulation();
+	/**
+	* \brief Controllers, physics and the vcomputers run as tasks on worker_threads threads.
+	*
+	* A threaded physics world steps on the thread calling Simulate() instead, as it always has to
+	* be stepped from the same thread, see PhysicsSystem(const PhysicsThreading&).
+	*/
+	explicit Simulation(std::size_t worker_threads = 1, const PhysicsThreading& physics_threading = {});
 	~Simulation();
 
 	GameState Simulate(const double delta_time, GameState& interpolated_state);
 
+	/**
+	* \brief Roll the physics back to an acked command and replay the commands sent after it.
+	*
+	* The controlled entities' bodies are restored from the snapshot saved for acked_id, the bodies
+	* in server_state are snapped to where the server has them, then every command runs for one
+	* step and the snapshot of its ID is saved again with the replayed result. Only the controlled
+	* entities are rolled back and stepped, the other bodies are left where they are. The
+	* controlled entities' positions end up in client_state.
+	* \param[in] const state_id_t acked_id The last command the server has applied.
+	* \param[in] const GameState& server_state The server's state as of acked_id.
+	* \param[in] std::span<const proto::ClientCommands> commands The commands after acked_id, oldest first.
+	* \param[in] const double step The time each command covers.
+	* \param[out] GameState& client_state The state to put the replayed positions and velocities in.
+	* \return bool False if there's no snapshot of acked_id (anymore), nothing is changed then.
+	*/
+	bool Replay(
+			state_id_t acked_id,
+			const GameState& server_state,
+			std::span<const proto::ClientCommands> commands,
+			double step,
+			GameState& client_state);
+
 	PhysicsSystem& GetPhysicsSystem() { return this->phys_sys; }
 
 	VComputerSystem& GetVComputerSystem() { return this->vcomp_sys; }
 
+	/**
+	* \brief The entities whose EntityDestroyed the last Simulate() saw.
+	*
+	* Every system run by Simulate() has handled their destruction by the time it returns, so
+	* nothing in the simulation refers to their IDs anymore and their indices can be reused.
+	*/
+	const std::vector<eid>& GetDestroyedEntities() const { return this->destroyed_entities; }
+
 	void AddController(Controller* controller);
 	void RemoveController(Controller* controller);
 
 	void On(eid, std::shared_ptr<KeyboardEvent> data) override;
 	void On(eid, std::shared_ptr<MouseBtnEvent> data) override;
-	void On(eid, std::shared_ptr<MouseMoveEvent> data) override;
+	void On(eid, const MouseMoveEvent& data) override;
 	void On(eid, std::shared_ptr<MouseClickEvent> data) override;
 	void On(eid, std::shared_ptr<ClientCommandsEvent> data) override;
 	void On(eid, std::shared_ptr<ControllerAddedEvent> data) override;
 	void On(eid, std::shared_ptr<ControllerRemovedEvent> data) override;
+	void On(eid entity_id, std::shared_ptr<EntityDestroyed> data) override;
 	void On(eid, std::shared_ptr<FocusCapturedEvent> data) override;
 	void On(eid, std::shared_ptr<FocusBlurEvent> data) override;
 
 private:
 	asio::thread_pool worker_pool;
+	TaskGraph tasks;
 
 	PhysicsSystem phys_sys;
 	VComputerSystem vcomp_sys;
@@ -66,5 +109,6 @@ private:
 	EventList event_list;
 
 	std::list<Controller*> controllers;
+	std::vector<eid> destroyed_entities;
 };
 } // end namespace tec
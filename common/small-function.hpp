@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace tec {
+template <typename Signature, std::size_t BUFFER_SIZE = 48> class SmallFunction;
+
+/**
+* \brief Move-only std::function alternative that keeps small callables inline.
+*
+* A callable that fits in BUFFER_SIZE bytes (a lambda with a few captures, or a
+* std::function) is stored in the object itself, so creating, moving and destroying
+* it never touches the heap. Bigger callables still work but are heap allocated.
+*/
+template <typename R, typename... Args, std::size_t BUFFER_SIZE> class SmallFunction<R(Args...), BUFFER_SIZE> {
+public:
+	SmallFunction() = default;
+
+	template <
+			typename F,
+			typename = std::enable_if_t<
+					!std::is_same_v<std::decay_t<F>, SmallFunction> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>>>
+	SmallFunction(F&& f) {
+		using Callable = std::decay_t<F>;
+		if constexpr (IsInline<Callable>()) {
+			new (&this->buffer) Callable(std::forward<F>(f));
+		}
+		else {
+			*reinterpret_cast<Callable**>(&this->buffer) = new Callable(std::forward<F>(f));
+		}
+		this->ops = &OpsFor<Callable>::ops;
+	}
+
+	SmallFunction(SmallFunction&& other) noexcept { MoveFrom(other); }
+
+	SmallFunction& operator=(SmallFunction&& other) noexcept {
+		if (this != &other) {
+			Reset();
+			MoveFrom(other);
+		}
+		return *this;
+	}
+
+	SmallFunction(const SmallFunction&) = delete;
+	SmallFunction& operator=(const SmallFunction&) = delete;
+
+	~SmallFunction() { Reset(); }
+
+	R operator()(Args... args) { return this->ops->invoke(&this->buffer, std::forward<Args>(args)...); }
+
+	explicit operator bool() const { return this->ops != nullptr; }
+
+	/// Checks if a callable of type F is stored without a heap allocation.
+	template <typename F> static constexpr bool IsInline() {
+		return sizeof(F) <= BUFFER_SIZE && alignof(F) <= alignof(std::max_align_t)
+			   && std::is_nothrow_move_constructible_v<F>;
+	}
+
+private:
+	struct Ops {
+		R (*invoke)(void* storage, Args&&... args);
+		void (*move)(void* from, void* to); // Leaves from destroyed.
+		void (*destroy)(void* storage);
+	};
+
+	template <typename F> struct OpsFor {
+		static F* Get(void* storage) {
+			if constexpr (IsInline<F>()) {
+				return std::launder(reinterpret_cast<F*>(storage));
+			}
+			else {
+				return *reinterpret_cast<F**>(storage);
+			}
+		}
+		static R Invoke(void* storage, Args&&... args) { return (*Get(storage))(std::forward<Args>(args)...); }
+		static void Move(void* from, void* to) {
+			if constexpr (IsInline<F>()) {
+				new (to) F(std::move(*Get(from)));
+				Get(from)->~F();
+			}
+			else {
+				*reinterpret_cast<F**>(to) = Get(from);
+			}
+		}
+		static void Destroy(void* storage) {
+			if constexpr (IsInline<F>()) {
+				Get(storage)->~F();
+			}
+			else {
+				delete Get(storage);
+			}
+		}
+		static constexpr Ops ops{&Invoke, &Move, &Destroy};
+	};
+
+	void MoveFrom(SmallFunction& other) {
+		if (other.ops) {
+			other.ops->move(&other.buffer, &this->buffer);
+			this->ops = other.ops;
+			other.ops = nullptr;
+		}
+	}
+
+	void Reset() {
+		if (this->ops) {
+			this->ops->destroy(&this->buffer);
+			this->ops = nullptr;
+		}
+	}
+
+	const Ops* ops{nullptr};
+	alignas(std::max_align_t) std::byte buffer[BUFFER_SIZE];
+};
+} // namespace tec
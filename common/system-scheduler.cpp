@@ -0,0 +1,59 @@
+#include "system-scheduler.hpp"
+
+#include <algorithm>
+
+namespace tec {
+namespace {
+bool Overlaps(const std::vector<std::type_index>& a, const std::vector<std::type_index>& b) {
+	return std::any_of(
+			a.begin(), a.end(), [&b](const std::type_index& type) { return std::find(b.begin(), b.end(), type) != b.end(); });
+}
+} // namespace
+
+bool SystemAccess::ConflictsWith(const SystemAccess& other) const {
+	return this->exclusive || other.exclusive || Overlaps(this->writes, other.writes)
+		   || Overlaps(this->writes, other.reads) || Overlaps(this->reads, other.writes);
+}
+
+SystemScheduler::SystemScheduler(const std::size_t thread_count) :
+		worker_pool(std::max<std::size_t>(thread_count, 1)) {}
+
+SystemScheduler::~SystemScheduler() {
+	worker_pool.stop();
+	worker_pool.join();
+}
+
+std::size_t SystemScheduler::Add(const char* name, SystemAccess access, std::function<void(double)> update) {
+	SystemRun run{name};
+	for (std::size_t earlier = 0; earlier < this->systems.size(); ++earlier) {
+		if (access.ConflictsWith(this->systems[earlier].access)) {
+			run.after.push_back(earlier);
+		}
+	}
+	this->systems.push_back(System{name, std::move(access), std::move(update)});
+	this->timeline.push_back(std::move(run));
+	return this->systems.size() - 1;
+}
+
+void SystemScheduler::Run(const double delta) {
+	const auto frame_start = std::chrono::steady_clock::now();
+	// task ids match system indices, as every system is added in order
+	this->graph.Clear();
+	for (std::size_t index = 0; index < this->systems.size(); ++index) {
+		System& system = this->systems[index];
+		SystemRun& run = this->timeline[index];
+		run.start = run.end = {};
+		this->graph.Add(
+				system.name,
+				[&system, &run, delta, frame_start]() {
+					run.thread = std::this_thread::get_id();
+					run.start = std::chrono::steady_clock::now() - frame_start;
+					system.update(delta);
+					run.end = std::chrono::steady_clock::now() - frame_start;
+				},
+				run.after,
+				system.access.thread);
+	}
+	this->graph.Run(this->worker_pool);
+}
+} // namespace tec
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <asio/thread_pool.hpp>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <typeindex>
+#include <vector>
+
+#include "task-graph.hpp"
+
+namespace tec {
+/**
+* \brief The shared data a system reads and writes, which decides what it may run alongside.
+*
+* Types are only used as tags, so besides components anything shared can be listed, e.g. the
+* game state queue or a resource type.
+*/
+class SystemAccess {
+public:
+	template <typename... T> SystemAccess& Reads() {
+		(this->reads.emplace_back(typeid(T)), ...);
+		return *this;
+	}
+
+	template <typename... T> SystemAccess& Writes() {
+		(this->writes.emplace_back(typeid(T)), ...);
+		return *this;
+	}
+
+	/// Conflict with every other system, for systems that may touch anything such as scripts.
+	SystemAccess& Exclusive() {
+		this->exclusive = true;
+		return *this;
+	}
+
+	/// Run on the thread calling SystemScheduler::Run(), e.g. for OpenGL calls.
+	SystemAccess& OnCallerThread() {
+		this->thread = TaskThread::Caller;
+		return *this;
+	}
+
+	/// True if one of the two writes something the other reads or writes.
+	bool ConflictsWith(const SystemAccess& other) const;
+
+private:
+	friend class SystemScheduler;
+
+	std::vector<std::type_index> reads;
+	std::vector<std::type_index> writes;
+	bool exclusive{false};
+	TaskThread thread{TaskThread::Pool};
+};
+
+/// When a system ran during the last frame, relative to the start of SystemScheduler::Run().
+struct SystemRun {
+	const char* name;
+	std::chrono::steady_clock::duration start{};
+	std::chrono::steady_clock::duration end{};
+	std::thread::id thread;
+	std::vector<std::size_t> after; // Indices of the systems it had to wait for.
+
+	std::chrono::steady_clock::duration Duration() const { return this->end - this->start; }
+};
+
+/**
+* \brief Runs a frame's systems concurrently where their declared access allows it.
+*
+* Systems are added once, in the order they would run serially. Every Run() builds a TaskGraph
+* in which each system waits for the earlier systems it conflicts with, so the serial order
+* is kept wherever two systems share data and everything else overlaps on the worker pool.
+*/
+class SystemScheduler {
+public:
+	explicit SystemScheduler(std::size_t thread_count);
+	~SystemScheduler();
+
+	/// Add a system, returning its index into the timeline. name must outlive the scheduler.
+	std::size_t Add(const char* name, SystemAccess access, std::function<void(double)> update);
+
+	/// Run every system once and wait for all of them.
+	void Run(double delta);
+
+	/// The schedule of the last Run(), one entry per system in the order they were added.
+	const std::vector<SystemRun>& GetTimeline() const { return this->timeline; }
+
+private:
+	struct System {
+		const char* name;
+		SystemAccess access;
+		std::function<void(double)> update;
+	};
+
+	asio::thread_pool worker_pool;
+	std::vector<System> systems;
+	std::vector<SystemRun> timeline;
+	TaskGraph graph;
+};
+} // namespace tec
@@ -0,0 +1,115 @@
+#include "task-graph.hpp"
+
+#include <asio/post.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+#include "tick-profiler.hpp"
+
+namespace tec {
+struct TaskGraph::RunState {
+	explicit RunState(const std::size_t count) :
+			remaining(count), pending(new std::atomic<std::size_t>[count]), skip(new std::atomic<bool>[count]) {}
+
+	std::mutex mutex;
+	std::condition_variable wake; // Signaled when a caller task is ready or the last task is done.
+	std::size_t remaining; // Tasks that haven't finished, guarded by mutex.
+	std::vector<TaskId> caller_ready; // Caller tasks waiting for Run(), guarded by mutex.
+	std::unique_ptr<std::atomic<std::size_t>[]> pending; // Dependencies of each task that haven't finished.
+	std::unique_ptr<std::atomic<bool>[]> skip; // Set when a dependency of the task failed.
+	std::exception_ptr error; // guarded by mutex
+};
+
+TaskGraph::TaskId TaskGraph::Add(
+		const char* name, std::function<void()> work, const std::vector<TaskId>& after, const TaskThread thread) {
+	const TaskId id = this->tasks.size();
+	for (const TaskId dependency : after) {
+		if (dependency >= id) {
+			throw std::invalid_argument("TaskGraph dependencies must be added before their dependents");
+		}
+	}
+	for (const TaskId dependency : after) {
+		this->tasks[dependency].dependents.push_back(id);
+	}
+	this->tasks.push_back(Task{name, std::move(work), thread});
+	this->tasks.back().dependency_count = after.size();
+	return id;
+}
+
+void TaskGraph::Run(asio::thread_pool& pool) {
+	if (this->tasks.empty()) {
+		return;
+	}
+	RunState run(this->tasks.size());
+	for (TaskId id = 0; id < this->tasks.size(); ++id) {
+		run.pending[id].store(this->tasks[id].dependency_count, std::memory_order_relaxed);
+		run.skip[id].store(false, std::memory_order_relaxed);
+	}
+	for (TaskId id = 0; id < this->tasks.size(); ++id) {
+		if (this->tasks[id].dependency_count == 0) {
+			Post(pool, run, id);
+		}
+	}
+
+	std::unique_lock lock(run.mutex);
+	while (run.remaining > 0) {
+		if (run.caller_ready.empty()) {
+			run.wake.wait(lock);
+			continue;
+		}
+		const TaskId id = run.caller_ready.back();
+		run.caller_ready.pop_back();
+		lock.unlock();
+		Execute(pool, run, id);
+		lock.lock();
+	}
+	if (run.error) {
+		std::rethrow_exception(run.error);
+	}
+}
+
+void TaskGraph::Post(asio::thread_pool& pool, RunState& run, const TaskId id) {
+	if (this->tasks[id].thread == TaskThread::Caller) {
+		std::lock_guard lock(run.mutex);
+		run.caller_ready.push_back(id);
+		run.wake.notify_one();
+		return;
+	}
+	asio::post(pool, [this, &pool, &run, id]() { Execute(pool, run, id); });
+}
+
+void TaskGraph::Execute(asio::thread_pool& pool, RunState& run, const TaskId id) {
+	Task& task = this->tasks[id];
+	bool failed = run.skip[id].load(std::memory_order_relaxed);
+	if (!failed) {
+		try {
+			ProfileScope profile(task.name);
+			task.work();
+		}
+		catch (...) {
+			failed = true;
+			std::lock_guard lock(run.mutex);
+			if (!run.error) {
+				run.error = std::current_exception();
+			}
+		}
+	}
+	for (const TaskId dependent_id : task.dependents) {
+		if (failed) {
+			// ordered by the release below, so whoever posts the dependent sees it
+			run.skip[dependent_id].store(true, std::memory_order_relaxed);
+		}
+		if (run.pending[dependent_id].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			Post(pool, run, dependent_id);
+		}
+	}
+	// last, and under the lock, the graph may be destroyed as soon as Run() sees the final count
+	std::lock_guard lock(run.mutex);
+	if (--run.remaining == 0) {
+		run.wake.notify_one();
+	}
+}
+} // namespace tec
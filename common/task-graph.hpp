@@ -0,0 +1,61 @@
+#pragma once
+
+#include <asio/thread_pool.hpp>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <vector>
+
+namespace tec {
+/// Where a TaskGraph task runs.
+enum class TaskThread {
+	Pool, // Any of the pool's threads.
+	Caller, // The thread calling Run(), for work tied to it such as OpenGL calls.
+};
+
+/**
+* \brief A batch of tasks with dependencies between them, run on a thread pool.
+*
+* Add() the tasks in any order that lists a task's dependencies before it, then Run() them.
+* Tasks without pending dependencies are posted to the pool, and finishing a task posts every
+* dependent that was only waiting on it. Caller tasks are run by Run() itself while it waits
+* for the pool. Each task is timed through the TickProfiler under its name.
+*
+* If a task throws, its dependents are skipped, everything else still runs, and Run() rethrows
+* the first exception.
+*/
+class TaskGraph {
+public:
+	using TaskId = std::size_t;
+
+	/// Add a task that runs after all of the tasks in after. name must outlive the graph, e.g. a literal.
+	TaskId Add(
+			const char* name,
+			std::function<void()> work,
+			const std::vector<TaskId>& after = {},
+			TaskThread thread = TaskThread::Pool);
+
+	/// Run every task on pool and wait until all of them are done.
+	void Run(asio::thread_pool& pool);
+
+	void Clear() { this->tasks.clear(); }
+
+	std::size_t Size() const { return this->tasks.size(); }
+
+private:
+	struct Task {
+		const char* name;
+		std::function<void()> work;
+		TaskThread thread;
+		std::vector<TaskId> dependents;
+		std::size_t dependency_count{0};
+	};
+
+	struct RunState;
+
+	void Post(asio::thread_pool& pool, RunState& run, TaskId id);
+	void Execute(asio::thread_pool& pool, RunState& run, TaskId id);
+
+	std::vector<Task> tasks;
+};
+} // namespace tec
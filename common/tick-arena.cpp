@@ -0,0 +1,122 @@
+#include "tick-arena.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+namespace tec {
+namespace {
+std::atomic<std::uint64_t> current_tick{0};
+
+std::mutex& RegistryMutex() {
+	static std::mutex registry_mutex;
+	return registry_mutex;
+}
+
+std::vector<const TickArena*>& Registry() {
+	static std::vector<const TickArena*> arenas;
+	return arenas;
+}
+
+std::size_t next_thread{0}; // guarded by RegistryMutex()
+
+std::uintptr_t AlignUp(const std::uintptr_t address, const std::size_t alignment) {
+	return (address + alignment - 1) & ~(alignment - 1);
+}
+} // namespace
+
+TickArena& TickArena::Get() {
+	thread_local TickArena arena;
+	return arena;
+}
+
+void TickArena::BeginTick() { current_tick.fetch_add(1, std::memory_order_relaxed); }
+
+std::vector<TickArenaStats> TickArena::GetAllStats() {
+	std::lock_guard lock(RegistryMutex());
+	std::vector<TickArenaStats> stats;
+	stats.reserve(Registry().size());
+	for (const TickArena* arena : Registry()) {
+		stats.push_back(arena->GetStats());
+	}
+	return stats;
+}
+
+TickArenaStats TickArena::GetStats() const {
+	TickArenaStats stats;
+	stats.thread = this->thread;
+	stats.used = this->used.load(std::memory_order_relaxed);
+	stats.high_water = this->high_water.load(std::memory_order_relaxed);
+	stats.capacity = this->capacity.load(std::memory_order_relaxed);
+	stats.block_allocations = this->block_allocations.load(std::memory_order_relaxed);
+	stats.resets = this->resets.load(std::memory_order_relaxed);
+	return stats;
+}
+
+TickArena::TickArena() :
+		tick(current_tick.load(std::memory_order_relaxed)), thread([] {
+			std::lock_guard lock(RegistryMutex());
+			return next_thread++;
+		}()) {
+	AddBlock(BLOCK_SIZE);
+	std::lock_guard lock(RegistryMutex());
+	Registry().push_back(this);
+}
+
+TickArena::~TickArena() {
+	std::lock_guard lock(RegistryMutex());
+	auto& arenas = Registry();
+	arenas.erase(std::remove(arenas.begin(), arenas.end(), this), arenas.end());
+}
+
+void* TickArena::do_allocate(const std::size_t bytes, const std::size_t alignment) {
+	if (this->tick != current_tick.load(std::memory_order_relaxed)
+		&& this->live.load(std::memory_order_acquire) == 0) {
+		Reset();
+	}
+	for (;;) {
+		Block& block = this->blocks[this->current_block];
+		const auto base = reinterpret_cast<std::uintptr_t>(block.data.get());
+		const std::size_t start = AlignUp(base + this->offset, alignment) - base;
+		if (start + bytes <= block.size) {
+			this->offset = start + bytes;
+			this->live.fetch_add(1, std::memory_order_relaxed);
+			const std::size_t now_used = this->used.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+			if (now_used > this->high_water.load(std::memory_order_relaxed)) {
+				this->high_water.store(now_used, std::memory_order_relaxed);
+			}
+			return block.data.get() + start;
+		}
+		// move on to the next block, adding one big enough if there are no more
+		if (++this->current_block == this->blocks.size()) {
+			AddBlock(std::max(BLOCK_SIZE, bytes + alignment));
+		}
+		this->offset = 0;
+	}
+}
+
+void TickArena::do_deallocate(void*, std::size_t, std::size_t) {
+	// release pairs with the acquire in do_allocate, so the memory is done with before it's reused
+	this->live.fetch_sub(1, std::memory_order_release);
+}
+
+void TickArena::Reset() {
+	this->tick = current_tick.load(std::memory_order_relaxed);
+	if (this->blocks.size() > 1) {
+		// the last tick needed several blocks, have one that holds it all from now on
+		const std::size_t total = this->capacity.load(std::memory_order_relaxed);
+		this->blocks.clear();
+		this->capacity.store(0, std::memory_order_relaxed);
+		AddBlock(total);
+	}
+	this->current_block = 0;
+	this->offset = 0;
+	this->used.store(0, std::memory_order_relaxed);
+	this->resets.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TickArena::AddBlock(const std::size_t size) {
+	this->blocks.push_back(Block{std::unique_ptr<std::byte[]>(new std::byte[size]), size});
+	this->capacity.fetch_add(size, std::memory_order_relaxed);
+	this->block_allocations.fetch_add(1, std::memory_order_relaxed);
+}
+} // namespace tec
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace tec {
+/// Usage of one thread's TickArena.
+struct TickArenaStats {
+	std::size_t thread{0}; // Order in which the threads first used their arena.
+	std::size_t used{0}; // Bytes handed out since the arena was last reset.
+	std::size_t high_water{0}; // Most bytes handed out between two resets.
+	std::size_t capacity{0}; // Bytes held in blocks, used or not.
+	std::uint64_t block_allocations{0}; // Blocks taken from the global heap since startup.
+	std::uint64_t resets{0};
+};
+
+/**
+* \brief Per-thread bump allocator for memory that only lives for one tick.
+*
+* Allocating bumps a pointer through the current block and freeing does nothing, the whole
+* arena is rewound once a new tick has begun (BeginTick()) and everything it handed out has
+* been freed. The blocks are kept, and coalesced into one if a tick needed several, so once
+* the arena has grown to a tick's worth of memory it stops touching the global heap.
+*
+* Get() is the calling thread's arena and may only be allocated from on that thread. Memory
+* from it may be read and freed on any thread, as long as it's freed during the tick it was
+* allocated in; anything kept longer just holds the arena back from resetting.
+* Containers use it through std::pmr, e.g. std::pmr::vector<eid> ids(&TickArena::Get()).
+*/
+class TickArena final : public std::pmr::memory_resource {
+public:
+	static constexpr std::size_t BLOCK_SIZE = 64 * 1024;
+
+	/// The calling thread's arena.
+	static TickArena& Get();
+
+	/// Start a new tick, every arena resets on its next allocation once it's unused.
+	static void BeginTick();
+
+	/// Get the stats of every thread's arena.
+	static std::vector<TickArenaStats> GetAllStats();
+
+	TickArenaStats GetStats() const;
+
+	TickArena(const TickArena&) = delete;
+	TickArena& operator=(const TickArena&) = delete;
+	~TickArena() override;
+
+private:
+	TickArena();
+
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+	void do_deallocate(void*, std::size_t, std::size_t) override;
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+	void Reset();
+	void AddBlock(std::size_t size);
+
+	struct Block {
+		std::unique_ptr<std::byte[]> data;
+		std::size_t size;
+	};
+
+	std::vector<Block> blocks;
+	std::size_t current_block{0};
+	std::size_t offset{0}; // Into the current block.
+	std::uint64_t tick{0}; // The tick the arena was last reset in.
+
+	const std::size_t thread;
+	std::atomic<std::size_t> live{0}; // Allocations not freed yet, freed from any thread.
+	std::atomic<std::size_t> used{0};
+	std::atomic<std::size_t> high_water{0};
+	std::atomic<std::size_t> capacity{0};
+	std::atomic<std::uint64_t> block_allocations{0};
+	std::atomic<std::uint64_t> resets{0};
+};
+} // namespace tec
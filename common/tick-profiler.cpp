@@ -0,0 +1,78 @@
+#include "tick-profiler.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace tec {
+namespace {
+double ToMilliseconds(const std::uint64_t ns) { return static_cast<double>(ns) / 1e6; }
+
+// Value at percentile p (0-1) of sorted samples, nearest rank.
+std::uint64_t Percentile(const std::vector<std::uint64_t>& sorted, const double p) {
+	if (sorted.empty()) {
+		return 0;
+	}
+	return sorted[static_cast<std::size_t>(static_cast<double>(sorted.size() - 1) * p + 0.5)];
+}
+} // namespace
+
+TickProfiler& TickProfiler::Get() {
+	// Intentionally never destroyed, worker threads may still record during static teardown.
+	static TickProfiler* profiler = new TickProfiler();
+	return *profiler;
+}
+
+TickProfiler::Phase& TickProfiler::FindPhase(const char* phase) {
+	for (Phase& existing : this->phases) {
+		// call sites pass literals, so the pointer usually matches
+		if (existing.name == phase || std::strcmp(existing.name, phase) == 0) {
+			return existing;
+		}
+	}
+	this->phases.push_back(Phase{phase});
+	this->phases.back().window_ns.reserve(WINDOW);
+	return this->phases.back();
+}
+
+void TickProfiler::Record(const char* phase, const std::chrono::steady_clock::duration duration) {
+	const auto ns = static_cast<std::uint64_t>(
+			std::max<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(), 0));
+	std::lock_guard lock(this->mutex);
+	Phase& entry = FindPhase(phase);
+	if (entry.window_ns.size() < WINDOW) {
+		entry.window_ns.push_back(ns);
+	}
+	else {
+		entry.window_ns[entry.samples % WINDOW] = ns;
+	}
+	++entry.samples;
+}
+
+std::vector<PhaseStats> TickProfiler::GetStats() const {
+	std::vector<PhaseStats> all;
+	std::vector<std::uint64_t> sorted;
+	std::lock_guard lock(this->mutex);
+	all.reserve(this->phases.size());
+	for (const Phase& phase : this->phases) {
+		PhaseStats stats;
+		stats.name = phase.name;
+		stats.samples = phase.samples;
+		if (!phase.window_ns.empty()) {
+			stats.last_ms = ToMilliseconds(phase.window_ns[(phase.samples - 1) % WINDOW]);
+		}
+		sorted = phase.window_ns;
+		std::sort(sorted.begin(), sorted.end());
+		stats.p50_ms = ToMilliseconds(Percentile(sorted, 0.5));
+		stats.p95_ms = ToMilliseconds(Percentile(sorted, 0.95));
+		stats.p99_ms = ToMilliseconds(Percentile(sorted, 0.99));
+		stats.max_ms = sorted.empty() ? 0.0 : ToMilliseconds(sorted.back());
+		all.push_back(std::move(stats));
+	}
+	return all;
+}
+
+void TickProfiler::Reset() {
+	std::lock_guard lock(this->mutex);
+	this->phases.clear();
+}
+} // namespace tec
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "tec-types.hpp"
+
+namespace tec {
+/// Rolling timings of one phase of the tick, over the last TickProfiler::WINDOW samples.
+struct PhaseStats {
+	std::string name;
+	std::uint64_t samples{0}; // Samples recorded since startup.
+	double last_ms{0.0};
+	double p50_ms{0.0};
+	double p95_ms{0.0};
+	double p99_ms{0.0};
+	double max_ms{0.0}; // Longest sample in the window.
+
+	static void RegisterLuaType(sol::state&);
+};
+
+/**
+* \brief Rolling per-phase timings of the server tick, the counterpart of the client's TimeFrameMetrics.
+*
+* Each Record() is one sample of a named phase, phases are created on first use. Phases that
+* run once per tick get one sample per tick, per-client phases one per client. GetStats()
+* reports percentiles over the most recent WINDOW samples of each phase.
+*
+* Record() may be called from any thread, e.g. from simulation worker tasks.
+*/
+class TickProfiler {
+public:
+	static constexpr std::size_t WINDOW = 600; // 10 seconds worth of 60Hz ticks.
+
+	static TickProfiler& Get();
+
+	/// Record one sample of phase, which must be a string literal or otherwise outlive the profiler.
+	void Record(const char* phase, std::chrono::steady_clock::duration duration);
+
+	/// Get the stats of every phase, in the order they were first recorded.
+	std::vector<PhaseStats> GetStats() const;
+
+	/// Forget all samples, e.g. after changing settings that affect timings.
+	void Reset();
+
+private:
+	struct Phase {
+		const char* name;
+		std::uint64_t samples{0};
+		std::vector<std::uint64_t> window_ns; // Ring of the last WINDOW samples.
+	};
+
+	Phase& FindPhase(const char* phase);
+
+	mutable std::mutex mutex;
+	std::vector<Phase> phases;
+};
+
+/// Records the time from construction to destruction, or to Stop(), as a sample of phase.
+class ProfileScope {
+public:
+	explicit ProfileScope(const char* phase) : phase(phase), start(std::chrono::steady_clock::now()) {}
+	~ProfileScope() { Stop(); }
+
+	/// End the phase before the end of the scope, later calls do nothing.
+	void Stop() {
+		if (this->phase) {
+			TickProfiler::Get().Record(this->phase, std::chrono::steady_clock::now() - this->start);
+			this->phase = nullptr;
+		}
+	}
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+	const char* phase;
+	std::chrono::steady_clock::time_point start;
+};
+} // namespace tec
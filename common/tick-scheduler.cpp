@@ -0,0 +1,99 @@
+#include "tick-scheduler.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <thread>
+
+namespace tec {
+namespace {
+void Record(std::array<std::uint64_t, TickStats::HISTOGRAM_BUCKETS>& histogram, const std::uint64_t ns) {
+	const std::uint64_t us = std::max<std::uint64_t>(ns / 1000, 1);
+	const std::size_t bucket = std::min<std::size_t>(std::bit_width(us) - 1, TickStats::HISTOGRAM_BUCKETS - 1);
+	++histogram[bucket];
+}
+
+std::uint64_t ToNanoseconds(const TickScheduler::Clock::duration duration) {
+	return static_cast<std::uint64_t>(
+			std::max<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(), 0));
+}
+} // namespace
+
+TickScheduler::TickScheduler(const Config& _config) :
+		config(_config), period(std::chrono::duration_cast<Clock::duration>(
+								 std::chrono::duration<double>(_config.tick_seconds))) {}
+
+void TickScheduler::SleepUntil(const Clock::time_point deadline) {
+	// sleeping overshoots by up to the scheduler's granularity, spin through the last part
+	if (deadline - Now() > this->config.spin) {
+		std::this_thread::sleep_until(deadline - this->config.spin);
+	}
+	while (Now() < deadline) {
+		std::this_thread::yield();
+	}
+}
+
+TickScheduler::Tick TickScheduler::WaitForTick() {
+	Clock::time_point now = Now();
+	if (!this->started) {
+		this->started = true;
+		this->next_deadline = now;
+	}
+	if (now < this->next_deadline) {
+		SleepUntil(this->next_deadline);
+		now = Now();
+	}
+	else if (const auto behind = (now - this->next_deadline) / this->period; behind > this->config.max_catch_up_ticks) {
+		// too far behind to catch up, forget about the oldest ticks and run the last ones back to back
+		const auto overflow = behind - this->config.max_catch_up_ticks;
+		this->stats.skipped += static_cast<std::uint64_t>(overflow);
+		this->window_overruns += static_cast<std::uint32_t>(overflow);
+		this->next_deadline += this->period * overflow;
+	}
+
+	const std::uint64_t lateness_ns = ToNanoseconds(now - this->next_deadline);
+	Record(this->stats.lateness_histogram, lateness_ns);
+	this->stats.max_lateness_ns = std::max(this->stats.max_lateness_ns, lateness_ns);
+
+	Tick tick;
+	tick.index = this->stats.ticks++;
+	tick.delta = this->config.tick_seconds;
+	const double send_interval = this->config.send_seconds * this->stats.send_divisor;
+	this->send_accumulator += this->config.tick_seconds;
+	// allow for rounding, so 4 ticks of 0.01 make a send interval of 0.04
+	if (this->send_accumulator >= send_interval - this->config.tick_seconds * 1e-6) {
+		tick.send = true;
+		this->send_accumulator = std::clamp(this->send_accumulator - send_interval, 0.0, send_interval);
+		++this->stats.sends;
+	}
+
+	this->tick_start = now;
+	this->next_deadline += this->period;
+	return tick;
+}
+
+void TickScheduler::EndTick() {
+	const Clock::duration duration = Now() - this->tick_start;
+	const std::uint64_t duration_ns = ToNanoseconds(duration);
+	Record(this->stats.duration_histogram, duration_ns);
+	this->stats.last_duration_ns = duration_ns;
+	this->stats.max_duration_ns = std::max(this->stats.max_duration_ns, duration_ns);
+	if (duration > this->period) {
+		++this->stats.overruns;
+		++this->window_overruns;
+	}
+	if (++this->window_ticks >= this->config.overrun_window) {
+		UpdateSendRate();
+	}
+}
+
+void TickScheduler::UpdateSendRate() {
+	if (this->window_overruns >= this->config.degrade_overruns) {
+		this->stats.send_divisor = std::min(this->stats.send_divisor * 2, std::max(this->config.max_send_divisor, 1u));
+	}
+	else if (this->window_overruns == 0 && this->stats.send_divisor > 1) {
+		this->stats.send_divisor /= 2;
+	}
+	this->window_ticks = 0;
+	this->window_overruns = 0;
+}
+} // namespace tec
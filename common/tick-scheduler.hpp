@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace tec {
+/// Timing of the ticks run by a TickScheduler.
+struct TickStats {
+	static constexpr std::size_t HISTOGRAM_BUCKETS = 24;
+
+	std::uint64_t ticks{0};
+	std::uint64_t overruns{0}; // Ticks that took longer than the tick period.
+	std::uint64_t skipped{0}; // Ticks dropped because catching up would have taken too many steps.
+	std::uint64_t sends{0}; // Ticks that sent a state update.
+	std::uint32_t send_divisor{1}; // The send interval is multiplied by this, above 1 in degraded mode.
+	std::uint64_t last_duration_ns{0};
+	std::uint64_t max_duration_ns{0};
+	std::uint64_t max_lateness_ns{0}; // Longest a tick started after its deadline.
+	// Bucket i counts ticks in [2^i, 2^(i+1)) microseconds, the first one also holds anything below 1us.
+	std::array<std::uint64_t, HISTOGRAM_BUCKETS> duration_histogram{};
+	std::array<std::uint64_t, HISTOGRAM_BUCKETS> lateness_histogram{};
+};
+
+/**
+* \brief Runs a fixed timestep loop against a monotonic clock.
+*
+* WaitForTick() sleeps until the next tick is due, then spins for the last stretch so the
+* tick starts on time despite coarse sleep granularity. Every tick advances the simulation
+* by the same delta; when the loop falls behind it runs ticks back to back to catch up, up
+* to max_catch_up_ticks, and drops the rest of the backlog.
+*
+* State updates are sent every send_seconds of simulated time. If too many ticks in a
+* window overrun, the send interval is doubled (degraded mode) to shed load, and halved
+* again after a window without overruns.
+*
+* Not thread-safe, meant to be owned by the loop's thread.
+*/
+class TickScheduler {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	struct Config {
+		double tick_seconds; // Fixed delta of every tick.
+		double send_seconds; // Interval between state updates when not degraded.
+		std::uint32_t max_catch_up_ticks{5}; // Most ticks run back to back when behind.
+		std::chrono::microseconds spin{500}; // How long before the deadline to stop sleeping and spin.
+		std::uint32_t overrun_window{60}; // Ticks per window when deciding on degraded mode.
+		std::uint32_t degrade_overruns{6}; // Overruns in a window that double the send interval.
+		std::uint32_t max_send_divisor{4}; // Longest the send interval can be stretched.
+	};
+
+	/// What to do this tick.
+	struct Tick {
+		std::uint64_t index{0};
+		double delta{0.0};
+		bool send{false}; // Send a state update after simulating.
+	};
+
+	explicit TickScheduler(const Config& config);
+	virtual ~TickScheduler() = default;
+
+	/// Wait until the next tick is due and start it.
+	Tick WaitForTick();
+
+	/// Finish the tick started by WaitForTick(), recording how long it took.
+	void EndTick();
+
+	const TickStats& GetStats() const { return this->stats; }
+
+	bool IsDegraded() const { return this->stats.send_divisor > 1; }
+
+protected:
+	virtual Clock::time_point Now() const { return Clock::now(); }
+	virtual void SleepUntil(Clock::time_point deadline);
+
+	const Config config;
+
+private:
+	void UpdateSendRate();
+
+	const Clock::duration period;
+	bool started{false};
+	Clock::time_point next_deadline;
+	Clock::time_point tick_start;
+	double send_accumulator{0.0};
+	std::uint32_t window_ticks{0};
+	std::uint32_t window_overruns{0};
+	TickStats stats;
+};
+} // namespace tec
@@ -9,6 +9,7 @@
 #include <tr3200/tr3200.hpp>
 #include <vcomputer.hpp>
 
+#include "component-pool.hpp"
 #include "entity.hpp"
 #include "events.hpp"
 #include "filesystem.hpp"
@@ -185,6 +186,26 @@ void ComputerKeyboard::Out(proto::Computer::Device*) {}
 
 VComputerSystem::VComputerSystem() { _log = spdlog::get("console_log"); };
 
+VComputerSystem::~VComputerSystem() {
+	// only release the computers this system made that still belong to their entity
+	for (const auto& [entity_id, computer] : this->created_computers) {
+		if (ComputerComponentMap::Get(entity_id) != computer) {
+			continue;
+		}
+		// The keyboard is owned by the computer's device list.
+		if (const ComputerKeyboard* keyboard = KeyboardComponentMap::Get(entity_id)) {
+			for (const auto& device : computer->devices) {
+				if (device.second.get() == keyboard) {
+					KeyboardComponentMap::Remove(entity_id);
+					break;
+				}
+			}
+		}
+		Entity(entity_id).Remove<Computer>();
+	}
+	this->created_computers.Clear();
+}
+
 void VComputerSystem::SetDevice(const eid entity_id, const unsigned int slot, std::shared_ptr<DeviceBase> device) {
 	if (this->computers.find(entity_id) != this->computers.end()) {
 		this->computers[entity_id]->vc.AddDevice(slot, device->device);
@@ -414,9 +435,10 @@ void VComputerSystem::On(eid, std::shared_ptr<EntityCreated> data) {
 		switch (comp.component_case()) {
 		case proto::Component::kComputer:
 		{
-			Computer* computer = new Computer();
+			Computer* computer = ComponentPool<Computer>::Create();
 			computer->In(comp);
-			ComputerComponentMap::Set(entity_id, computer);
+			Entity(entity_id).Update(computer);
+			this->created_computers.Set(entity_id, computer);
 			for (auto device : computer->devices) {
 				if (device.second->device->DevType() == 0x03) { // 0x03 is keyboard DevType
 					KeyboardComponentMap::Set(entity_id, static_cast<ComputerKeyboard*>(device.second.get()));
@@ -430,6 +452,9 @@ void VComputerSystem::On(eid, std::shared_ptr<EntityCreated> data) {
 }
 
 void VComputerSystem::On(eid entity_id, std::shared_ptr<EntityDestroyed> data) {
-	ComputerComponentMap::Remove(entity_id);
+	// The keyboard is owned by the computer's device list.
+	KeyboardComponentMap::Remove(entity_id);
+	Entity(entity_id).Remove<Computer>();
+	this->created_computers.Remove(entity_id);
 }
 } // namespace tec
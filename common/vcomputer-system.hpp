@@ -8,6 +8,7 @@
 #include <vcomputer.hpp>
 
 #include "command-queue.hpp"
+#include "component-store.hpp"
 #include "event-system.hpp"
 #include "multiton.hpp"
 #include "tec-types.hpp"
@@ -84,6 +85,7 @@ class VComputerSystem final :
 		public EventQueue<EntityDestroyed> {
 public:
 	VComputerSystem();
+	~VComputerSystem();
 
 	/** \brief Sets the specified device for the entity ID to device.
 	*
@@ -147,6 +149,7 @@ private:
 	eid active_entity{0}; // The entity that has focus such as for keyboard input
 
 	std::map<eid, Computer*> computers;
+	ComponentStore<Computer*> created_computers; // Made by On(EntityCreated), released with the system.
 };
 
 } // namespace tec
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace tec {
+/**
+* \brief Bounded lock-free deque of pointers, owned by one thread and stolen from by the others.
+*
+* The owner pushes and pops at the bottom, so it works on its most recent (cache warm) items,
+* while thieves take the oldest items from the top with one compare-and-swap (the Chase-Lev
+* deque, with the memory orders of Le et al. for weak memory models). The buffer is allocated
+* once and never grows, a full deque makes Push() fail so the caller can put the item elsewhere.
+*
+* Push() and Pop() may only be called by the owning thread, Steal() from any thread.
+*/
+template <class T> class WorkStealingDeque {
+public:
+	/// \param[in] const std::size_t capacity Number of items, rounded up to a power of two.
+	explicit WorkStealingDeque(const std::size_t capacity) :
+			mask(RoundUp(capacity) - 1), items(new std::atomic<T*>[mask + 1]) {}
+	WorkStealingDeque(const WorkStealingDeque&) = delete;
+	WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+	/// Push an item at the bottom, false if the deque is full.
+	bool Push(T* item) {
+		const std::int64_t b = this->bottom.load(std::memory_order_relaxed);
+		const std::int64_t t = this->top.load(std::memory_order_acquire);
+		if (b - t > static_cast<std::int64_t>(this->mask)) {
+			return false;
+		}
+		this->items[b & this->mask].store(item, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		this->bottom.store(b + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	/// Pop the most recently pushed item, nullptr if there is none.
+	T* Pop() {
+		const std::int64_t b = this->bottom.load(std::memory_order_relaxed) - 1;
+		this->bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		std::int64_t t = this->top.load(std::memory_order_relaxed);
+		if (t > b) {
+			this->bottom.store(b + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+		T* item = this->items[b & this->mask].load(std::memory_order_relaxed);
+		if (t == b) {
+			// the last item, race the thieves for it
+			if (!this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+				item = nullptr;
+			}
+			this->bottom.store(b + 1, std::memory_order_relaxed);
+		}
+		return item;
+	}
+
+	/// Take the oldest item, nullptr if there is none or another thread got it first.
+	T* Steal() {
+		std::int64_t t = this->top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const std::int64_t b = this->bottom.load(std::memory_order_acquire);
+		if (t >= b) {
+			return nullptr;
+		}
+		T* item = this->items[t & this->mask].load(std::memory_order_relaxed);
+		if (!this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			return nullptr;
+		}
+		return item;
+	}
+
+	/// Approximate number of items, exact only when called by the owner with no thieves around.
+	std::size_t Size() const {
+		const std::int64_t b = this->bottom.load(std::memory_order_relaxed);
+		const std::int64_t t = this->top.load(std::memory_order_relaxed);
+		return b > t ? static_cast<std::size_t>(b - t) : 0;
+	}
+
+private:
+	static std::size_t RoundUp(const std::size_t capacity) {
+		std::size_t size = 2;
+		while (size < capacity) {
+			size <<= 1;
+		}
+		return size;
+	}
+
+	const std::size_t mask;
+	std::unique_ptr<std::atomic<T*>[]> items;
+	// on separate cache lines, as the owner writes bottom and the thieves write top
+	alignas(64) std::atomic<std::int64_t> top{0};
+	alignas(64) std::atomic<std::int64_t> bottom{0};
+};
+} // namespace tec
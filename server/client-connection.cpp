@@ -8,11 +8,10 @@
 
 #include "event-system.hpp"
 #include "events.hpp"
+#include "proto-arena.hpp"
 #include "server.hpp"
 
 namespace tec {
-eid GetNextEntityId();
-
 namespace networking {
 ClientConnection::ClientConnection(tcp::socket _socket, tcp::endpoint _endpoint, Server* server) :
 		socket(std::move(_socket)), endpoint(std::move(_endpoint)), server(server) {
@@ -297,7 +296,38 @@ void ClientConnection::do_write() {
 	});
 }
 
+namespace {
+// Copy an entity's entry from the full state, entries it no longer has are kept like a full pass does.
+template <typename T>
+void CopyChange(const std::unordered_map<eid, T>& from, std::unordered_map<eid, T>& to, const eid entity_id) {
+	if (auto itr = from.find(entity_id); itr != from.end()) {
+		to[entity_id] = itr->second;
+	}
+}
+} // namespace
+
 void ClientConnection::UpdateGameState(const GameState& full_state) {
+	// copy only the entities that changed since the last update when the full state tracks its changes
+	if (full_state.changes) {
+		const GameStateChanges& changes = *full_state.changes;
+		const bool known = changes.positions.IsValid(this->position_cursor)
+						   && changes.orientations.IsValid(this->orientation_cursor)
+						   && changes.velocities.IsValid(this->velocity_cursor);
+		GameState& to = this->state_changes_since_confirmed;
+		if (known) {
+			changes.positions.ForEachChanged(
+					this->position_cursor, [&](const eid id) { CopyChange(full_state.positions, to.positions, id); });
+			changes.orientations.ForEachChanged(this->orientation_cursor, [&](const eid id) {
+				CopyChange(full_state.orientations, to.orientations, id);
+			});
+			changes.velocities.ForEachChanged(
+					this->velocity_cursor, [&](const eid id) { CopyChange(full_state.velocities, to.velocities, id); });
+			return;
+		}
+		this->position_cursor = changes.positions.GetCursor();
+		this->orientation_cursor = changes.orientations.GetCursor();
+		this->velocity_cursor = changes.velocities.GetCursor();
+	}
 	for (const auto& pair : full_state.positions) {
 		if (full_state.positions.find(pair.first) != full_state.positions.end()) {
 			this->state_changes_since_confirmed.positions[pair.first] = full_state.positions.at(pair.first);
@@ -312,27 +342,28 @@ void ClientConnection::UpdateGameState(const GameState& full_state) {
 }
 
 MessageOut ClientConnection::PrepareGameStateUpdateMessage(state_id_t current_state_id, uint64_t current_timestamp) {
-	tec::proto::GameStateUpdate gsu_msg;
-	gsu_msg.set_state_id(current_state_id);
-	gsu_msg.set_command_id(this->last_recv_command_id);
-	gsu_msg.set_timestamp(current_timestamp);
-	for (auto pos : this->state_changes_since_confirmed.positions) {
-		tec::proto::Entity* _entity = gsu_msg.add_entity();
-		_entity->set_id(pos.first);
-		pos.second.Out(_entity->add_components());
-		if (this->state_changes_since_confirmed.orientations.find(pos.first)
-			!= this->state_changes_since_confirmed.orientations.end()) {
-			tec::Orientation ori = this->state_changes_since_confirmed.orientations.at(pos.first);
-			ori.Out(_entity->add_components());
+	// built on this thread's arena, which is reset once the message is serialized
+	ProtoArena& arena = ProtoArena::ForThread();
+	auto* gsu_msg = google::protobuf::Arena::CreateMessage<tec::proto::GameStateUpdate>(&arena.Get());
+	gsu_msg->set_state_id(current_state_id);
+	gsu_msg->set_command_id(this->last_recv_command_id);
+	gsu_msg->set_timestamp(current_timestamp);
+	const GameState& changes = this->state_changes_since_confirmed;
+	gsu_msg->mutable_entity()->Reserve(static_cast<int>(changes.positions.size()));
+	for (const auto& [entity_id, position] : changes.positions) {
+		tec::proto::Entity* _entity = gsu_msg->add_entity();
+		_entity->set_id(entity_id);
+		position.Out(_entity->add_components());
+		if (const auto ori = changes.orientations.find(entity_id); ori != changes.orientations.end()) {
+			ori->second.Out(_entity->add_components());
 		}
-		if (this->state_changes_since_confirmed.velocities.find(pos.first)
-			!= this->state_changes_since_confirmed.velocities.end()) {
-			tec::Velocity vel = this->state_changes_since_confirmed.velocities.at(pos.first);
-			vel.Out(_entity->add_components());
+		if (const auto vel = changes.velocities.find(entity_id); vel != changes.velocities.end()) {
+			vel->second.Out(_entity->add_components());
 		}
 	}
 	MessageOut update_message(MessageType::GAME_STATE_UPDATE);
-	gsu_msg.SerializeToZeroCopyStream(&update_message);
+	gsu_msg->SerializeToZeroCopyStream(&update_message);
+	arena.Reset();
 	return update_message;
 }
 
@@ -90,6 +90,10 @@ private:
 	state_id_t last_confirmed_state_id{0}; // That last state_id the client confirmed it received.
 	state_id_t last_recv_command_id{0};
 	GameState state_changes_since_confirmed; // That state changes that happened since last_confirmed_state_id.
+	// How far into the full state's change history UpdateGameState() has read.
+	ChangeTracker::Cursor position_cursor;
+	ChangeTracker::Cursor orientation_cursor;
+	ChangeTracker::Cursor velocity_cursor;
 
 	bool ready_to_recv_states{false};
 };
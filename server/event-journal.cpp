@@ -0,0 +1,239 @@
+#include "event-journal.hpp"
+
+#include <cstring>
+
+#include <commands.pb.h>
+#include <components.pb.h>
+
+#include "controllers/fps-controller.hpp"
+#include "event-system.hpp"
+
+namespace tec {
+namespace {
+template <typename T> void AppendLE(std::string& buffer, const T value) {
+	static_assert(std::is_unsigned_v<T>);
+	for (std::size_t i = 0; i < sizeof(T); ++i) {
+		buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+	}
+}
+
+template <typename T> bool ReadLE(std::istream& in, T& value) {
+	static_assert(std::is_unsigned_v<T>);
+	unsigned char bytes[sizeof(T)];
+	if (!in.read(reinterpret_cast<char*>(bytes), sizeof(T))) {
+		return false;
+	}
+	value = 0;
+	for (std::size_t i = 0; i < sizeof(T); ++i) {
+		value |= static_cast<T>(bytes[i]) << (8 * i);
+	}
+	return true;
+}
+
+constexpr std::uint64_t FNV_OFFSET = 14695981039346656037ull;
+constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+
+std::uint64_t Fnv1a(std::uint64_t hash, const void* data, const std::size_t size) {
+	const auto* bytes = static_cast<const unsigned char*>(data);
+	for (std::size_t i = 0; i < size; ++i) {
+		hash = (hash ^ bytes[i]) * FNV_PRIME;
+	}
+	return hash;
+}
+
+// Hash of one component, summed with the others so the map iteration order doesn't matter.
+template <typename... Floats>
+std::uint64_t HashComponent(const eid entity_id, const std::uint8_t kind, const Floats... values) {
+	std::uint64_t hash = Fnv1a(FNV_OFFSET, &entity_id, sizeof(entity_id));
+	hash = Fnv1a(hash, &kind, sizeof(kind));
+	for (const float value : {values...}) {
+		hash = Fnv1a(hash, &value, sizeof(value));
+	}
+	return hash;
+}
+} // namespace
+
+EventJournalWriter::EventJournalWriter(std::ostream& _out) : out(_out), start(std::chrono::steady_clock::now()) {
+	this->buffer.append(MAGIC, sizeof(MAGIC));
+	AppendLE(this->buffer, VERSION);
+	this->out.write(this->buffer.data(), static_cast<std::streamsize>(this->buffer.size()));
+	this->buffer.clear();
+}
+
+EventJournalWriter::~EventJournalWriter() {
+	ProcessEvents();
+	this->out.write(this->buffer.data(), static_cast<std::streamsize>(this->buffer.size()));
+	this->out.flush();
+	EventSystem<EntityCreated>::Get()->Unsubscribe(this);
+	EventSystem<EntityDestroyed>::Get()->Unsubscribe(this);
+	EventSystem<ClientCommandsEvent>::Get()->Unsubscribe(this);
+	EventSystem<ChatCommandEvent>::Get()->Unsubscribe(this);
+	EventSystem<ControllerAddedEvent>::Get()->Unsubscribe(this);
+	EventSystem<ControllerRemovedEvent>::Get()->Unsubscribe(this);
+}
+
+void EventJournalWriter::ProcessEvents() {
+	EventQueue<EntityCreated>::ProcessEventQueue();
+	EventQueue<EntityDestroyed>::ProcessEventQueue();
+	EventQueue<ControllerAddedEvent>::ProcessEventQueue();
+	EventQueue<ControllerRemovedEvent>::ProcessEventQueue();
+	EventQueue<ClientCommandsEvent>::ProcessEventQueue();
+	EventQueue<ChatCommandEvent>::ProcessEventQueue();
+}
+
+void EventJournalWriter::RecordTick(const double delta) {
+	ProcessEvents();
+	const auto timestamp_ns = static_cast<std::uint64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->start)
+					.count());
+	std::uint64_t delta_bits;
+	static_assert(sizeof(delta_bits) == sizeof(delta));
+	std::memcpy(&delta_bits, &delta, sizeof(delta));
+
+	this->buffer.push_back(static_cast<char>(JournalRecordType::TICK));
+	AppendLE(this->buffer, timestamp_ns);
+	AppendLE(this->buffer, delta_bits);
+	this->out.write(this->buffer.data(), static_cast<std::streamsize>(this->buffer.size()));
+	this->buffer.clear();
+}
+
+void EventJournalWriter::WriteRecord(const JournalRecordType type, const eid entity_id, const std::string& payload) {
+	this->buffer.push_back(static_cast<char>(type));
+	AppendLE(this->buffer, static_cast<std::uint64_t>(entity_id));
+	AppendLE(this->buffer, static_cast<std::uint32_t>(payload.size()));
+	this->buffer.append(payload);
+}
+
+void EventJournalWriter::On(eid, std::shared_ptr<EntityCreated> data) {
+	WriteRecord(JournalRecordType::ENTITY_CREATED, data->entity.id(), data->entity.SerializeAsString());
+}
+
+void EventJournalWriter::On(eid entity_id, std::shared_ptr<EntityDestroyed>) {
+	WriteRecord(JournalRecordType::ENTITY_DESTROYED, entity_id, {});
+}
+
+void EventJournalWriter::On(eid, std::shared_ptr<ClientCommandsEvent> data) {
+	WriteRecord(
+			JournalRecordType::CLIENT_COMMANDS, data->client_commands.id(), data->client_commands.SerializeAsString());
+}
+
+void EventJournalWriter::On(eid, std::shared_ptr<ChatCommandEvent> data) {
+	WriteRecord(JournalRecordType::CHAT_COMMAND, 0, data->Out().SerializeAsString());
+}
+
+void EventJournalWriter::On(eid, std::shared_ptr<ControllerAddedEvent> data) {
+	if (data->controller) {
+		WriteRecord(JournalRecordType::CONTROLLER_ADDED, data->controller->entity_id, {});
+	}
+}
+
+void EventJournalWriter::On(eid, std::shared_ptr<ControllerRemovedEvent> data) {
+	if (data->controller) {
+		WriteRecord(JournalRecordType::CONTROLLER_REMOVED, data->controller->entity_id, {});
+	}
+}
+
+EventJournalReader::EventJournalReader(std::istream& _in) : in(_in) {
+	char magic[sizeof(EventJournalWriter::MAGIC)];
+	std::uint32_t version = 0;
+	this->valid = this->in.read(magic, sizeof(magic)) && ReadLE(this->in, version)
+				  && std::memcmp(magic, EventJournalWriter::MAGIC, sizeof(magic)) == 0
+				  && version == EventJournalWriter::VERSION;
+}
+
+bool EventJournalReader::Next(JournalRecord& record) {
+	char type;
+	if (!this->valid || !this->in.get(type)) {
+		return false;
+	}
+	// the record is reused across calls, so nothing from the previous one may leak into this one
+	record.type = static_cast<JournalRecordType>(type);
+	record.entity_id = 0;
+	record.payload.clear();
+	record.delta = 0.0;
+	record.timestamp_ns = 0;
+	if (record.type == JournalRecordType::TICK) {
+		std::uint64_t delta_bits = 0;
+		if (!ReadLE(this->in, record.timestamp_ns) || !ReadLE(this->in, delta_bits)) {
+			return false;
+		}
+		std::memcpy(&record.delta, &delta_bits, sizeof(record.delta));
+		return true;
+	}
+	if (record.type < JournalRecordType::ENTITY_CREATED || record.type > JournalRecordType::CONTROLLER_REMOVED) {
+		this->valid = false; // nothing after an unknown record can be trusted
+		return false;
+	}
+	std::uint64_t entity_id = 0;
+	std::uint32_t size = 0;
+	if (!ReadLE(this->in, entity_id) || !ReadLE(this->in, size)) {
+		return false;
+	}
+	record.entity_id = static_cast<eid>(entity_id);
+	record.payload.resize(size);
+	return size == 0 || static_cast<bool>(this->in.read(record.payload.data(), size));
+}
+
+void EventJournalReader::Emit(const JournalRecord& record) {
+	switch (record.type) {
+	case JournalRecordType::ENTITY_CREATED:
+	{
+		auto data = std::make_shared<EntityCreated>();
+		data->entity.ParseFromString(record.payload);
+		EventSystem<EntityCreated>::Get()->Emit(data);
+	} break;
+	case JournalRecordType::ENTITY_DESTROYED:
+		EventSystem<EntityDestroyed>::Get()->Emit(record.entity_id, std::make_shared<EntityDestroyed>());
+		break;
+	case JournalRecordType::CLIENT_COMMANDS:
+	{
+		auto data = std::make_shared<ClientCommandsEvent>();
+		data->client_commands.ParseFromString(record.payload);
+		EventSystem<ClientCommandsEvent>::Get()->Emit(data);
+	} break;
+	case JournalRecordType::CHAT_COMMAND:
+	{
+		proto::ChatCommand chat_command;
+		chat_command.ParseFromString(record.payload);
+		EventSystem<ChatCommandEvent>::Get()->Emit(std::make_shared<ChatCommandEvent>(chat_command));
+	} break;
+	case JournalRecordType::CONTROLLER_ADDED:
+	{
+		auto data = std::make_shared<ControllerAddedEvent>();
+		data->controller = std::make_shared<FPSController>(record.entity_id);
+		this->controllers[record.entity_id] = data->controller;
+		EventSystem<ControllerAddedEvent>::Get()->Emit(data);
+	} break;
+	case JournalRecordType::CONTROLLER_REMOVED:
+	{
+		auto controller = this->controllers.find(record.entity_id);
+		if (controller != this->controllers.end()) {
+			auto data = std::make_shared<ControllerRemovedEvent>();
+			data->controller = std::move(controller->second);
+			this->controllers.erase(controller);
+			EventSystem<ControllerRemovedEvent>::Get()->Emit(data);
+		}
+	} break;
+	case JournalRecordType::TICK:
+		break;
+	}
+}
+
+std::uint64_t HashGameState(const GameState& state) {
+	std::uint64_t hash = 0;
+	for (const auto& [entity_id, position] : state.positions) {
+		const glm::vec3& v = position.value;
+		hash += HashComponent(entity_id, 1, v.x, v.y, v.z);
+	}
+	for (const auto& [entity_id, orientation] : state.orientations) {
+		const glm::quat& q = orientation.value;
+		hash += HashComponent(entity_id, 2, q.w, q.x, q.y, q.z);
+	}
+	for (const auto& [entity_id, velocity] : state.velocities) {
+		const glm::vec3& l = velocity.linear;
+		const glm::vec3& a = velocity.angular;
+		hash += HashComponent(entity_id, 3, l.x, l.y, l.z, a.x, a.y, a.z);
+	}
+	return hash;
+}
+} // namespace tec
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+#include "event-queue.hpp"
+#include "events.hpp"
+#include "game-state.hpp"
+#include "tec-types.hpp"
+
+namespace tec {
+/// What a single journal record holds.
+enum class JournalRecordType : std::uint8_t {
+	TICK = 1, // Simulate() ran with delta, after the events recorded before it.
+	ENTITY_CREATED, // payload is a serialized proto::Entity.
+	ENTITY_DESTROYED, // entity_id is the destroyed entity.
+	CLIENT_COMMANDS, // payload is a serialized proto::ClientCommands.
+	CHAT_COMMAND, // payload is a serialized proto::ChatCommand.
+	CONTROLLER_ADDED, // an FPSController was added for entity_id.
+	CONTROLLER_REMOVED, // the controller of entity_id was removed.
+};
+
+struct JournalRecord {
+	JournalRecordType type{JournalRecordType::TICK};
+	eid entity_id{0};
+	std::string payload;
+	double delta{0.0}; // TICK only.
+	std::uint64_t timestamp_ns{0}; // TICK only, time since the journal was started.
+};
+
+/**
+* \brief Records everything entering the server simulation to a compact binary journal.
+*
+* The journal starts with a small header and is followed by one record per event. Events
+* are written in the order they are drained by RecordTick(), followed by a TICK record,
+* so a reader replays them by emitting everything up to a TICK and then simulating once.
+* Integers are written little-endian regardless of the host.
+*
+* An event that arrives while the tick is running is handled by the simulation in that
+* tick but journaled with the next one, so a replay can differ by a tick for such events.
+*/
+class EventJournalWriter :
+		public EventQueue<EntityCreated>,
+		public EventQueue<EntityDestroyed>,
+		public EventQueue<ClientCommandsEvent>,
+		public EventQueue<ChatCommandEvent>,
+		public EventQueue<ControllerAddedEvent>,
+		public EventQueue<ControllerRemovedEvent> {
+public:
+	static constexpr char MAGIC[4] = {'T', 'E', 'C', 'J'};
+	static constexpr std::uint32_t VERSION = 1;
+
+	/// Starts recording to out, which must outlive the writer.
+	explicit EventJournalWriter(std::ostream& out);
+	~EventJournalWriter() override;
+
+	/**
+	* \brief Write the events received since the last tick, then a tick record.
+	*
+	* Call on the simulation thread right before the events are processed for a tick.
+	* \param[in] const double delta The delta about to be passed to Simulation::Simulate().
+	*/
+	void RecordTick(double delta);
+
+	void On(eid, std::shared_ptr<EntityCreated> data) override;
+	void On(eid entity_id, std::shared_ptr<EntityDestroyed> data) override;
+	void On(eid, std::shared_ptr<ClientCommandsEvent> data) override;
+	void On(eid, std::shared_ptr<ChatCommandEvent> data) override;
+	void On(eid, std::shared_ptr<ControllerAddedEvent> data) override;
+	void On(eid, std::shared_ptr<ControllerRemovedEvent> data) override;
+
+private:
+	void ProcessEvents();
+	void WriteRecord(JournalRecordType type, eid entity_id, const std::string& payload);
+
+	std::ostream& out;
+	std::string buffer; // Records of the current tick, written to out in one go.
+	std::chrono::steady_clock::time_point start;
+};
+
+/// Reads back a journal written by EventJournalWriter.
+class EventJournalReader {
+public:
+	/// Reads the header from in, check IsValid() before calling Next().
+	explicit EventJournalReader(std::istream& in);
+
+	bool IsValid() const { return this->valid; }
+
+	/**
+	* \brief Read the next record.
+	* \param[out] JournalRecord& record Filled in with the record read.
+	* \return bool False at the end of the journal or if it is truncated.
+	*/
+	bool Next(JournalRecord& record);
+
+	/**
+	* \brief Emits the event held by record to its EventSystem, TICK records are ignored.
+	*
+	* Controllers are recreated as FPSControllers, which the reader keeps alive until removed.
+	*/
+	void Emit(const JournalRecord& record);
+
+private:
+	std::istream& in;
+	bool valid{false};
+	std::unordered_map<eid, std::shared_ptr<Controller>> controllers;
+};
+
+/// Order independent hash of the transforms and velocities in a GameState, for comparing runs.
+std::uint64_t HashGameState(const GameState& state);
+} // namespace tec
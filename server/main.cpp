@@ -1,6 +1,10 @@
 #include <algorithm>
+#include <charconv>
 #include <chrono>
+#include <fstream>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <thread>
 
 #include <asio.hpp>
@@ -9,12 +13,19 @@
 #include <file-factories.hpp>
 
 #include "client-connection.hpp"
+#include "entity-id-allocator.hpp"
+#include "event-journal.hpp"
 #include "filesystem.hpp"
+#include "proto-arena.hpp"
 #include "proto-load.hpp"
 #include "server-game-state-queue.hpp"
 #include "server-stats.hpp"
 #include "server.hpp"
 #include "simulation.hpp"
+#include "state-update-builder.hpp"
+#include "tick-arena.hpp"
+#include "tick-profiler.hpp"
+#include "tick-scheduler.hpp"
 
 #include "resources/script-file.hpp"
 #include <save-game.hpp>
@@ -23,6 +34,7 @@
 #include <spdlog/spdlog.h>
 
 const double SERVER_SIMULATE_RATE = 1.0 / 60.0;
+const std::uint64_t PROFILE_LOG_TICKS = 60 * 60; // Log the tick profile once a minute.
 std::shared_ptr<spdlog::logger> server_log;
 
 using asio::ip::tcp;
@@ -31,12 +43,44 @@ tec::state_id_t current_state_id = 0;
 
 namespace tec {
 void RegisterFileFactories() { AddFileFactory<ScriptFile>(); }
-eid GetNextEntityId() {
-	static eid entity_id = 10000;
-	return entity_id++;
+EntityIdAllocator& GetEntityIdAllocator() {
+	static EntityIdAllocator entity_id_allocator(10000);
+	return entity_id_allocator;
 }
 } // namespace tec
 
+void LogTickProfile(const std::uint64_t tick_index) {
+	server_log->info("tick {} profile, ms at p50 p95 p99 max:", tick_index);
+	for (const tec::PhaseStats& phase : tec::TickProfiler::Get().GetStats()) {
+		server_log->info(
+				"  {:<36} {:7.3f} {:7.3f} {:7.3f} {:7.3f}",
+				phase.name,
+				phase.p50_ms,
+				phase.p95_ms,
+				phase.p99_ms,
+				phase.max_ms);
+	}
+	for (const tec::TickArenaStats& arena : tec::TickArena::GetAllStats()) {
+		server_log->info(
+				"  tick arena {}: {} bytes high water, {} bytes in blocks, {} block allocations",
+				arena.thread,
+				arena.high_water,
+				arena.capacity,
+				arena.block_allocations);
+	}
+}
+
+// Parses the value of a thread count option, logs an error and returns nothing if it isn't one.
+std::optional<std::size_t> ParseThreadCount(const std::string_view option, const std::string_view value) {
+	std::size_t count = 0;
+	const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), count);
+	if (error != std::errc() || end != value.data() + value.size()) {
+		server_log->error("{} expects a thread count, not {}", option, value);
+		return std::nullopt;
+	}
+	return count;
+}
+
 void InitializeLogger() {
 	std::vector<spdlog::sink_ptr> sinks;
 	sinks.push_back(std::make_shared<spdlog::sinks::stdout_sink_mt>());
@@ -46,24 +90,56 @@ void InitializeLogger() {
 	spdlog::register_logger(server_log);
 }
 
-int main() {
+int main(int argc, char* argv[]) {
 	InitializeLogger();
 	tec::RegisterFileFactories();
-	std::chrono::high_resolution_clock::time_point last_time, next_time;
-	std::chrono::duration<double> elapsed_seconds;
 	bool closing = false;
 
-	// Accumulated deltas since the last update send and physics simulation.
-	double delta_accumulator = 0.0;
-	double step_accumulator = 0.0;
-
 	tec::ServerStats stats;
 	tec::ServerGameStateQueue game_state_queue(stats);
-	tec::Simulation simulation;
+	// --simulation-threads <n> sizes the pool the controllers, physics and vcomputers run on
+	// --physics-threads <n> opts into stepping the physics world on n threads of the job system
+	std::size_t simulation_threads = 2;
+	tec::PhysicsThreading physics_threading;
+	for (int i = 1; i + 1 < argc; i++) {
+		if (std::string(argv[i]) == "--simulation-threads") {
+			const std::optional<std::size_t> count = ParseThreadCount(argv[i], argv[i + 1]);
+			if (!count) {
+				return 1;
+			}
+			simulation_threads = std::max<std::size_t>(*count, 1);
+		}
+		else if (std::string(argv[i]) == "--physics-threads") {
+			const std::optional<std::size_t> count = ParseThreadCount(argv[i], argv[i + 1]);
+			if (!count) {
+				return 1;
+			}
+			physics_threading.thread_count = *count;
+		}
+	}
+	tec::Simulation simulation(simulation_threads, physics_threading);
+	if (physics_threading.thread_count > 0 && !simulation.GetPhysicsSystem().IsThreaded()) {
+		server_log->warn("Bullet can't number all job system workers, stepping the physics world on one thread");
+	}
 
 	// use constant mode stepping, because we don't need interpolated states on the server
 	simulation.GetPhysicsSystem().SetSubstepping(0);
 
+	// --record <file> journals everything entering the simulation, play it back with trillek-replay
+	std::ofstream journal_file;
+	std::unique_ptr<tec::EventJournalWriter> journal;
+	for (int i = 1; i + 1 < argc; i++) {
+		if (std::string(argv[i]) == "--record") {
+			journal_file.open(argv[i + 1], std::ios_base::out | std::ios_base::binary);
+			if (!journal_file) {
+				server_log->error("Can't open {} to record the event journal", argv[i + 1]);
+				return 1;
+			}
+			journal = std::make_unique<tec::EventJournalWriter>(journal_file);
+			server_log->info("Recording the event journal to {}", argv[i + 1]);
+		}
+	}
+
 	tec::Path save_directory = tec::Path("assets:/save");
 
 	if (!save_directory.DirExists()) {
@@ -79,6 +155,7 @@ int main() {
 		tec::SaveGame save;
 		save.Load(tec::Path("assets:/save/save1.json"));
 		lua_sys->GetGlobalState()["save"] = &save;
+		lua_sys->GetGlobalState()["physics"] = &simulation.GetPhysicsSystem();
 
 		auto& authenticator = server.GetAuthenticator();
 		auto user_list_data_source = tec::UserListDataSource(*save.GetUserList());
@@ -90,74 +167,104 @@ int main() {
 			lua_sys->LoadFile(fp);
 		}
 
-		last_time = std::chrono::high_resolution_clock::now();
+		tec::TickScheduler scheduler({SERVER_SIMULATE_RATE, tec::UPDATE_RATE});
+		// the simulation thread joins in by waiting, so leave it a core
+		tec::networking::StateUpdateBuilder state_update_builder(
+				std::max(std::thread::hardware_concurrency(), 2u) - 1);
 		std::thread simulation_thread([&]() {
 			while (!closing) {
-				next_time = std::chrono::high_resolution_clock::now();
-				uint64_t current_timestamp =
-						std::chrono::duration_cast<std::chrono::milliseconds>(next_time.time_since_epoch()).count();
-				elapsed_seconds = next_time - last_time;
-				last_time = next_time;
-				double delta = elapsed_seconds.count();
-				delta_accumulator += delta;
-				step_accumulator += delta;
-
-				if (step_accumulator >= SERVER_SIMULATE_RATE) {
+				const tec::TickScheduler::Tick tick = scheduler.WaitForTick();
+				const bool was_degraded = scheduler.IsDegraded();
+				tec::ProfileScope tick_profile("tick");
+				tec::TickArena::BeginTick();
+
+				if (journal) {
+					journal->RecordTick(tick.delta);
+				}
+				{
+					tec::ProfileScope profile("server.ProcessEvents");
 					server.ProcessEvents();
-					step_accumulator -= SERVER_SIMULATE_RATE;
+				}
+				{
+					tec::ProfileScope profile("game_state_queue.ProcessEventQueue");
 					game_state_queue.ProcessEventQueue();
-					tec::GameState full_state =
-							simulation.Simulate(SERVER_SIMULATE_RATE, game_state_queue.GetBaseState());
-
-					if (delta_accumulator >= tec::UPDATE_RATE) {
-						current_state_id++;
-						full_state.state_id = current_state_id;
-						full_state.timestamp = current_timestamp;
-						tec::proto::GameStateUpdate full_state_update;
-						full_state_update.set_command_id(current_state_id);
-						full_state.Out(&full_state_update);
-						tec::networking::MessageOut full_state_update_message(tec::networking::GAME_STATE_UPDATE);
-						full_state_update.SerializeToZeroCopyStream(&full_state_update_message);
-
-						{
-							std::lock_guard lg(server.client_list_mutex);
-							for (std::shared_ptr<tec::networking::ClientConnection> client : server.GetClients()) {
-								if (!client->ReadyToReceive()) {
-									client->ConfirmStateID(current_state_id);
-									continue; // Don't send them state updates yet, the client is still loading
-								}
-								client->UpdateGameState(full_state);
-								if (current_state_id - client->GetLastConfirmedStateID()
-									> tec::TICKS_PER_SECOND * 2.0) {
-									server.Deliver(client, full_state_update_message);
-									server_log->debug(
-											"sending full state {} to: {} client state ID was: {}",
-											current_state_id,
-											client->GetID(),
-											client->GetLastConfirmedStateID());
-								}
-								else {
-									server.Deliver(
-											client,
-											client->PrepareGameStateUpdateMessage(current_state_id, current_timestamp));
-								}
-							}
-						}
+				}
+				tec::ProfileScope simulate_profile("simulate");
+				tec::GameState full_state = simulation.Simulate(tick.delta, game_state_queue.GetBaseState());
+				simulate_profile.Stop();
+
+				if (tick.send) {
+					tec::ProfileScope send_profile("send");
+					uint64_t current_timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+														 std::chrono::system_clock::now().time_since_epoch())
+														 .count();
+					current_state_id++;
+					full_state.state_id = current_state_id;
+					full_state.timestamp = current_timestamp;
+					tec::networking::MessageOut full_state_update_message(tec::networking::GAME_STATE_UPDATE);
+					{
+						tec::ProfileScope profile("send.full_state");
+						tec::ProtoArena& arena = tec::ProtoArena::ForThread();
+						auto* full_state_update =
+								google::protobuf::Arena::CreateMessage<tec::proto::GameStateUpdate>(&arena.Get());
+						full_state_update->set_command_id(current_state_id);
+						full_state.Out(full_state_update);
+						full_state_update->SerializeToZeroCopyStream(&full_state_update_message);
+						arena.Reset();
+					}
 
-						delta_accumulator -= tec::UPDATE_RATE;
+					tec::ProfileScope build_profile("send.BuildClientUpdates");
+					auto& updates = state_update_builder.Build(server, full_state, current_state_id, current_timestamp);
+					build_profile.Stop();
+					for (tec::networking::ClientStateUpdate& update : updates) {
+						tec::ProfileScope profile("send.Deliver");
+						if (update.message) {
+							server.Deliver(update.client, std::move(*update.message));
+						}
+						else {
+							server.Deliver(update.client, full_state_update_message);
+							server_log->debug(
+									"sending full state {} to: {} client state ID was: {}",
+									current_state_id,
+									update.client->GetID(),
+									update.client->GetLastConfirmedStateID());
+						}
 					}
+				}
+				{
+					tec::ProfileScope profile("game_state_queue.SetBaseState");
 					game_state_queue.SetBaseState(std::move(full_state));
+				}
 
-					// Processing events in LuaSystem
+				// Processing events in LuaSystem
+				{
+					tec::ProfileScope profile("lua.ProcessEvents");
 					tec::LuaSystem* lua_sys = server.GetLuaSystem();
 					lua_sys->ProcessEvents();
 				}
-				else {
-					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				// an index is only handed out again once every system has let go of the entity using it
+				for (const tec::eid entity_id : simulation.GetDestroyedEntities()) {
+					tec::GetEntityIdAllocator().Release(entity_id);
+				}
+				tick_profile.Stop();
+
+				scheduler.EndTick();
+				const tec::TickStats& tick_stats = scheduler.GetStats();
+				if (scheduler.IsDegraded() != was_degraded || (was_degraded && tick.index % 600 == 0)) {
+					server_log->warn(
+							"tick {}: {} of {} ticks overran, {} skipped, sending every {}s",
+							tick.index,
+							tick_stats.overruns,
+							tick_stats.ticks,
+							tick_stats.skipped,
+							tec::UPDATE_RATE * tick_stats.send_divisor);
+				}
+				if (tick.index > 0 && tick.index % PROFILE_LOG_TICKS == 0) {
+					LogTickProfile(tick.index);
 				}
 			}
 		});
-		server_log->info("Starting time: {}", last_time.time_since_epoch().count());
+		server_log->info("Starting time: {}", std::chrono::system_clock::now().time_since_epoch().count());
 		server.Start();
 
 		closing = true;
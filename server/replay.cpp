@@ -0,0 +1,147 @@
+// Headless replay of a journal recorded with `trillekd --record <file>`. Every recorded event
+// is fed back through the simulation as fast as possible, without any sockets, to measure
+// how long the server ticks take on real traffic.
+//
+// Usage: trillek-replay <journal> [--csv <file>]
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <file-factories.hpp>
+
+#include "entity-id-allocator.hpp"
+#include "event-journal.hpp"
+#include "filesystem.hpp"
+#include "lua-system.hpp"
+#include "server-game-state-queue.hpp"
+#include "server-stats.hpp"
+#include "simulation.hpp"
+#include "tick-arena.hpp"
+
+#include "resources/script-file.hpp"
+
+#include <spdlog/sinks/stdout_sinks.h>
+#include <spdlog/spdlog.h>
+
+std::shared_ptr<spdlog::logger> replay_log;
+
+namespace tec {
+void RegisterFileFactories() { AddFileFactory<ScriptFile>(); }
+EntityIdAllocator& GetEntityIdAllocator() {
+	static EntityIdAllocator entity_id_allocator(10000);
+	return entity_id_allocator;
+}
+} // namespace tec
+
+void InitializeLogger() {
+	std::vector<spdlog::sink_ptr> sinks;
+	sinks.push_back(std::make_shared<spdlog::sinks::stdout_sink_mt>());
+	replay_log = std::make_shared<spdlog::logger>("console_log", begin(sinks), end(sinks));
+	replay_log->set_level(spdlog::level::info);
+	replay_log->set_pattern("[%l] %v");
+	spdlog::register_logger(replay_log);
+}
+
+struct TickTiming {
+	std::uint64_t recorded_ns; // When the tick ran while recording, since the start.
+	double delta;
+	std::uint64_t replay_ns; // How long the tick took to replay.
+	std::uint64_t state_hash;
+};
+
+int main(int argc, char* argv[]) {
+	InitializeLogger();
+	if (argc < 2) {
+		replay_log->error("usage: {} <journal> [--csv <file>]", argv[0]);
+		return 1;
+	}
+	std::string csv_file;
+	for (int i = 2; i + 1 < argc; i++) {
+		if (std::string(argv[i]) == "--csv") {
+			csv_file = argv[++i];
+		}
+	}
+	tec::RegisterFileFactories();
+
+	std::ifstream journal_file(argv[1], std::ios_base::in | std::ios_base::binary);
+	tec::EventJournalReader journal(journal_file);
+	if (!journal.IsValid()) {
+		replay_log->error("{} is not an event journal", argv[1]);
+		return 1;
+	}
+
+	tec::ServerStats stats;
+	tec::ServerGameStateQueue game_state_queue(stats);
+	tec::Simulation simulation;
+	simulation.GetPhysicsSystem().SetSubstepping(0);
+	tec::LuaSystem lua_sys;
+
+	tec::Path fp = tec::Path::scripts / "server-test.lua";
+	if (fp.FileExists()) {
+		lua_sys.LoadFile(fp);
+	}
+
+	std::vector<TickTiming> timings;
+	tec::JournalRecord record;
+	const auto replay_start = std::chrono::steady_clock::now();
+	while (journal.Next(record)) {
+		if (record.type != tec::JournalRecordType::TICK) {
+			journal.Emit(record);
+			continue;
+		}
+		// the same steps as the simulation thread of the server, minus sending the updates
+		const auto tick_start = std::chrono::steady_clock::now();
+		tec::TickArena::BeginTick();
+		game_state_queue.ProcessEventQueue();
+		tec::GameState full_state = simulation.Simulate(record.delta, game_state_queue.GetBaseState());
+		game_state_queue.SetBaseState(std::move(full_state));
+		lua_sys.ProcessEvents();
+		const auto tick_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - tick_start);
+
+		timings.push_back(
+				{record.timestamp_ns,
+				 record.delta,
+				 static_cast<std::uint64_t>(tick_ns.count()),
+				 tec::HashGameState(game_state_queue.GetBaseState())});
+	}
+	const std::chrono::duration<double> replay_seconds = std::chrono::steady_clock::now() - replay_start;
+
+	if (!csv_file.empty()) {
+		std::ofstream csv(csv_file);
+		csv << "tick,recorded_ns,delta,replay_ns,state_hash\n";
+		for (std::size_t i = 0; i < timings.size(); i++) {
+			csv << i << ',' << timings[i].recorded_ns << ',' << timings[i].delta << ',' << timings[i].replay_ns << ','
+				<< timings[i].state_hash << '\n';
+		}
+	}
+
+	if (timings.empty()) {
+		replay_log->warn("the journal holds no ticks");
+		return 0;
+	}
+	std::vector<std::uint64_t> sorted;
+	sorted.reserve(timings.size());
+	std::uint64_t total_ns = 0;
+	for (const TickTiming& timing : timings) {
+		sorted.push_back(timing.replay_ns);
+		total_ns += timing.replay_ns;
+	}
+	std::sort(sorted.begin(), sorted.end());
+	const auto percentile = [&sorted](const double p) {
+		return sorted[static_cast<std::size_t>(static_cast<double>(sorted.size() - 1) * p)] / 1000.0;
+	};
+
+	replay_log->info("replayed {} ticks in {:.3f}s", timings.size(), replay_seconds.count());
+	replay_log->info(
+			"tick us: mean {:.1f} p50 {:.1f} p99 {:.1f} max {:.1f}",
+			static_cast<double>(total_ns) / static_cast<double>(timings.size()) / 1000.0,
+			percentile(0.5),
+			percentile(0.99),
+			sorted.back() / 1000.0);
+	replay_log->info("game state hash: {:016x}", timings.back().state_hash);
+	return 0;
+}
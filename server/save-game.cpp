@@ -3,6 +3,8 @@
 #include <algorithm>
 #include <fstream>
 #include <iterator>
+#include <memory>
+#include <vector>
 
 #include <google/protobuf/util/json_util.h>
 #include <spdlog/spdlog.h>
@@ -117,14 +119,16 @@ void SaveGame::SaveUsers() {
 void SaveGame::LoadWorld() {
 	auto _log = spdlog::get("console_log");
 	auto world = this->save.world();
+	std::vector<std::shared_ptr<EntityCreated>> entities;
+	entities.reserve(world.entity_file_list_size());
 	for (int i = 0; i < world.entity_file_list_size(); i++) {
 		Path entity_filename = Path::assets / world.entity_file_list(i);
 		if (entity_filename && entity_filename.FileExists()) {
 			std::string json_string = LoadAsString(entity_filename);
-			proto::Entity entity;
-			auto status = google::protobuf::util::JsonStringToMessage(json_string, &entity);
+			auto data = std::make_shared<EntityCreated>();
+			auto status = google::protobuf::util::JsonStringToMessage(json_string, &data->entity);
 			if (status.ok()) {
-				EventSystem<EntityCreated>::Get()->Emit(std::make_shared<EntityCreated>(EntityCreated{entity}));
+				entities.push_back(std::move(data));
 			}
 			else {
 				_log->error("Failed to parse entity data from file: {}", entity_filename);
@@ -134,6 +138,7 @@ void SaveGame::LoadWorld() {
 			_log->error("File does not exist or path is invalid: {}", entity_filename);
 		}
 	}
+	EventSystem<EntityCreated>::Get()->EmitMany(entities);
 }
 
 void SaveGame::SaveWorld() {
@@ -2,7 +2,7 @@
 
 namespace tec {
 
-ServerGameStateQueue::ServerGameStateQueue(ServerStats& s) : stats(s) {}
+ServerGameStateQueue::ServerGameStateQueue(ServerStats& s) : stats(s) { this->base_state.TrackChanges(); }
 
 void ServerGameStateQueue::ProcessEventQueue() {
 	EventQueue<EntityCreated>::ProcessEventQueue();
@@ -19,21 +19,21 @@ void ServerGameStateQueue::On(eid, std::shared_ptr<EntityCreated> data) {
 		{
 			Position pos;
 			pos.In(comp);
-			this->base_state.positions[entity_id] = pos;
+			this->base_state.SetPosition(entity_id, pos);
 			break;
 		}
 		case proto::Component::kOrientation:
 		{
 			Orientation orientation;
 			orientation.In(comp);
-			this->base_state.orientations[entity_id] = orientation;
+			this->base_state.SetOrientation(entity_id, orientation);
 			break;
 		}
 		case proto::Component::kVelocity:
 		{
 			Velocity vel;
 			vel.In(comp);
-			this->base_state.velocities[entity_id] = vel;
+			this->base_state.SetVelocity(entity_id, vel);
 			break;
 		}
 		default: break;
@@ -42,9 +42,7 @@ void ServerGameStateQueue::On(eid, std::shared_ptr<EntityCreated> data) {
 }
 
 void ServerGameStateQueue::On(eid entity_id, std::shared_ptr<EntityDestroyed> data) {
-	this->base_state.positions.erase(entity_id);
-	this->base_state.orientations.erase(entity_id);
-	this->base_state.velocities.erase(entity_id);
+	this->base_state.RemoveEntity(entity_id);
 }
 
 } // end namespace tec
@@ -7,6 +7,7 @@
 
 #include "event-queue.hpp"
 #include "event-system.hpp"
+#include "game-state-snapshot.hpp"
 #include "game-state.hpp"
 #include "server-stats.hpp"
 #include "tec-types.hpp"
@@ -15,6 +16,8 @@ namespace tec {
 
 class ServerGameStateQueue : public EventQueue<EntityCreated>, public EventQueue<EntityDestroyed> {
 public:
+	static constexpr std::size_t HISTORY_SIZE = 120; // Two seconds worth of ticks.
+
 	ServerGameStateQueue(ServerStats& s);
 
 	virtual void On(eid, std::shared_ptr<EntityCreated> data) override;
@@ -24,13 +27,26 @@ public:
 
 	GameState& GetBaseState() { return this->base_state; }
 
-	void SetBaseState(GameState&& new_state) { this->base_state = std::move(new_state); }
+	// The simulation result carries on the base state's change history, which also makes
+	// keeping a snapshot of every tick cost only the entities that changed.
+	void SetBaseState(GameState&& new_state) {
+		auto changes = this->base_state.changes;
+		this->base_state = std::move(new_state);
+		if (!this->base_state.changes) {
+			this->base_state.changes = std::move(changes);
+		}
+		this->history.Capture(this->base_state);
+	}
+
+	// Snapshots of the most recent ticks, for lag compensation and rollback.
+	const GameStateHistory& GetHistory() const { return this->history; }
 
 public:
 	ServerStats& stats;
 
 private:
 	GameState base_state;
+	GameStateHistory history{HISTORY_SIZE};
 };
 
 } // end namespace tec
@@ -0,0 +1,55 @@
+#include "state-update-builder.hpp"
+
+#include <asio/post.hpp>
+#include <latch>
+#include <mutex>
+
+#include "client-connection.hpp"
+#include "server.hpp"
+#include "simulation.hpp"
+#include "tick-profiler.hpp"
+
+namespace tec {
+namespace networking {
+StateUpdateBuilder::StateUpdateBuilder(const std::size_t thread_count) : worker_pool(thread_count) {}
+
+StateUpdateBuilder::~StateUpdateBuilder() {
+	this->worker_pool.stop();
+	this->worker_pool.join();
+}
+
+std::vector<ClientStateUpdate>& StateUpdateBuilder::Build(
+		Server& server, const GameState& full_state, const state_id_t current_state_id,
+		const uint64_t current_timestamp) {
+	this->updates.clear();
+	{
+		std::lock_guard lg(server.client_list_mutex);
+		for (const std::shared_ptr<ClientConnection>& client : server.GetClients()) {
+			if (!client->ReadyToReceive()) {
+				client->ConfirmStateID(current_state_id);
+				continue; // Don't send them state updates yet, the client is still loading
+			}
+			this->updates.push_back(ClientStateUpdate{client});
+		}
+	}
+
+	std::latch done(static_cast<std::ptrdiff_t>(this->updates.size()));
+	for (ClientStateUpdate& update : this->updates) {
+		asio::post(this->worker_pool, [&]() {
+			{
+				ProfileScope profile("send.UpdateGameState");
+				update.client->UpdateGameState(full_state);
+			}
+			if (current_state_id - update.client->GetLastConfirmedStateID() <= TICKS_PER_SECOND * 2.0) {
+				ProfileScope profile("send.PrepareGameStateUpdateMessage");
+				update.message.emplace(
+						update.client->PrepareGameStateUpdateMessage(current_state_id, current_timestamp));
+			}
+			done.count_down();
+		});
+	}
+	done.wait();
+	return this->updates;
+}
+} // namespace networking
+} // namespace tec
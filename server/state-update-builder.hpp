@@ -0,0 +1,47 @@
+#pragma once
+
+#include <asio/thread_pool.hpp>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "game-state.hpp"
+#include "net-message.hpp"
+#include "tec-types.hpp"
+
+namespace tec {
+namespace networking {
+class ClientConnection;
+class Server;
+
+/// The update built for one client.
+struct ClientStateUpdate {
+	std::shared_ptr<ClientConnection> client;
+	// The client's delta update, empty when it is too far behind and needs the full state.
+	std::optional<MessageOut> message;
+};
+
+/**
+* \brief Builds every client's state update on a worker pool.
+*
+* Each client's UpdateGameState() and PrepareGameStateUpdateMessage() only touch that
+* client's own state, so they run as one task per client. Build() returns once all of them
+* have finished, leaving the messages to be delivered by the caller's thread. The server's
+* client list is only locked while the ready clients are handed out.
+*/
+class StateUpdateBuilder {
+public:
+	explicit StateUpdateBuilder(std::size_t thread_count);
+	~StateUpdateBuilder();
+
+	/// Build the updates for full_state, the result is valid until the next call.
+	std::vector<ClientStateUpdate>&
+	Build(Server& server, const GameState& full_state, state_id_t current_state_id, uint64_t current_timestamp);
+
+private:
+	asio::thread_pool worker_pool;
+	std::vector<ClientStateUpdate> updates;
+};
+} // namespace networking
+} // namespace tec
@@ -3,22 +3,23 @@
 #include "components/collision-body.hpp"
 #include "components/velocity.hpp"
 #include "controllers/fps-controller.hpp"
+#include "entity-id-allocator.hpp"
 #include "event-system.hpp"
 #include "events.hpp"
 
 namespace tec {
-eid GetNextEntityId();
+EntityIdAllocator& GetEntityIdAllocator();
 
 namespace user {
 User::~User() {}
 
 void User::AddEntityToWorld() {
-	this->entity_id = GetNextEntityId();
+	this->entity_id = GetEntityIdAllocator().Allocate();
 	Entity entity(this->entity_id);
 
 	entity.Add<Position, Orientation, Velocity>(entity_data.position, entity_data.orientation, Velocity());
 
-	CollisionBody* body = new CollisionBody();
+	CollisionBody* body = ComponentPool<CollisionBody>::Create();
 	body->mass = 10.0f;
 	body->disable_deactivation = true;
 	body->disable_rotation = true;
@@ -44,6 +45,7 @@ void User::RemoveEntityFromWorld() {
 		if (this->entity_id != 0) {
 			std::shared_ptr<EntityDestroyed> data = std::make_shared<EntityDestroyed>();
 			EventSystem<EntityDestroyed>::Get()->Emit(this->entity_id, data);
+			// The ID is released by the simulation thread once the systems handled the destruction.
 			this->entity_id = 0;
 		}
 	}
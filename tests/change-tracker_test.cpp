@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "change-tracker.hpp"
+#include "game-state.hpp"
+#include "multiton.hpp"
+
+namespace tec {
+namespace {
+std::vector<eid> Changed(const ChangeTracker& tracker, ChangeTracker::Cursor& cursor) {
+	std::vector<eid> changed;
+	EXPECT_TRUE(tracker.ForEachChanged(cursor, [&changed](const eid entity_id) { changed.push_back(entity_id); }));
+	std::sort(changed.begin(), changed.end());
+	return changed;
+}
+
+struct TrackedTestComponent {
+	int value{0};
+};
+} // namespace
+
+TEST(ChangeTracker, ReportsEachChangeOncePerCursor) {
+	ChangeTracker tracker;
+	ChangeTracker::Cursor first = tracker.GetCursor();
+	tracker.MarkChanged(1);
+	tracker.MarkChanged(2);
+	tracker.MarkChanged(1);
+	ChangeTracker::Cursor second = tracker.GetCursor();
+	tracker.MarkChanged(3);
+
+	EXPECT_EQ(Changed(tracker, first), (std::vector<eid>{1, 2, 3}));
+	EXPECT_EQ(Changed(tracker, second), (std::vector<eid>{3}));
+	// both readers are caught up now
+	EXPECT_TRUE(Changed(tracker, first).empty());
+	EXPECT_TRUE(Changed(tracker, second).empty());
+
+	EXPECT_TRUE(tracker.ChangedSince(3, ChangeTracker::Cursor{}));
+	EXPECT_FALSE(tracker.ChangedSince(3, first));
+}
+
+TEST(ChangeTracker, ReportsRemovals) {
+	ChangeTracker tracker;
+	tracker.MarkChanged(1);
+	ChangeTracker::Cursor cursor = tracker.GetCursor();
+	tracker.MarkRemoved(1);
+	EXPECT_FALSE(tracker.ChangedSince(1, cursor));
+	EXPECT_EQ(Changed(tracker, cursor), (std::vector<eid>{1}));
+}
+
+TEST(ChangeTracker, UnknownCursorNeedsFullPass) {
+	ChangeTracker tracker;
+	tracker.MarkChanged(1);
+
+	ChangeTracker::Cursor cursor;
+	EXPECT_FALSE(tracker.IsValid(cursor));
+	EXPECT_FALSE(tracker.ForEachChanged(cursor, [](eid) { FAIL(); }));
+	EXPECT_TRUE(tracker.IsValid(cursor));
+
+	// a reader that falls behind the trimmed log is told to do a full pass as well
+	ChangeTracker::Cursor stale = tracker.GetCursor();
+	for (int i = 0; i < 10000; ++i) {
+		tracker.MarkChanged(static_cast<eid>(i % 10));
+	}
+	EXPECT_FALSE(tracker.IsValid(stale));
+	EXPECT_TRUE(tracker.ChangedSince(5, stale));
+
+	tracker.Clear();
+	EXPECT_FALSE(tracker.IsValid(cursor));
+}
+
+TEST(ChangeTracker, MultitonRecordsWrites) {
+	using TestMap = Multiton<eid, TrackedTestComponent*>;
+	TrackedTestComponent a, b;
+	ChangeTracker::Cursor cursor = TestMap::Changes().GetCursor();
+	TestMap::Set(10, &a);
+	TestMap::Set(20, &b);
+	EXPECT_EQ(Changed(TestMap::Changes(), cursor), (std::vector<eid>{10, 20}));
+
+	a.value = 1;
+	TestMap::MarkChanged(10);
+	TestMap::Remove(20);
+	EXPECT_EQ(Changed(TestMap::Changes(), cursor), (std::vector<eid>{10, 20}));
+	TestMap::Clear();
+	EXPECT_FALSE(TestMap::Changes().IsValid(cursor));
+}
+
+TEST(ChangeTracker, GameStateCopiesHaveOwnHistory) {
+	GameState state;
+	state.SetPosition(1, Position(glm::vec3(1.f)));
+	EXPECT_FALSE(state.changes);
+	GameState untracked = state;
+	EXPECT_FALSE(untracked.changes);
+
+	state.TrackChanges();
+	ChangeTracker::Cursor cursor = state.changes->positions.GetCursor();
+	GameState copy = state;
+	ASSERT_TRUE(copy.changes);
+	EXPECT_NE(copy.changes, state.changes);
+	copy.SetPosition(2, Position(glm::vec3(2.f)));
+	EXPECT_TRUE(Changed(state.changes->positions, cursor).empty());
+	EXPECT_FALSE(copy.changes->positions.IsValid(cursor));
+}
+
+TEST(ChangeTracker, GameStateSharesHistoryOnRequest) {
+	GameState state;
+	state.SetPosition(1, Position(glm::vec3(1.f)));
+	state.TrackChanges();
+	ChangeTracker::Cursor cursor = state.changes->positions.GetCursor();
+	GameState copy = state;
+	copy.ShareChanges(state);
+	copy.SetPosition(2, Position(glm::vec3(2.f)));
+	state.RemoveEntity(1);
+	EXPECT_EQ(Changed(state.changes->positions, cursor), (std::vector<eid>{1, 2}));
+	EXPECT_EQ(state.positions.count(1), 0);
+	EXPECT_EQ(copy.positions.count(1), 1);
+}
+} // namespace tec
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <btBulletCollisionCommon.h>
+
+#include "collision-shape-cache.hpp"
+
+namespace tec {
+TEST(CollisionShapeCache, SharesShapesOfTheSameDimensions) {
+	CollisionShapeCache& cache = CollisionShapeCache::Get();
+	const auto box = cache.GetBox(0.5f, 1.f, 2.f);
+	EXPECT_EQ(cache.GetBox(0.5f, 1.f, 2.f), box);
+	// float noise below the quantum doesn't make a new shape
+	EXPECT_EQ(cache.GetBox(0.5f + CollisionShapeCache::DIMENSION_QUANTUM * 0.1f, 1.f, 2.f), box);
+	EXPECT_NE(cache.GetBox(0.5f, 1.f, 2.5f), box);
+
+	const auto sphere = cache.GetSphere(0.5f);
+	EXPECT_EQ(cache.GetSphere(0.5f), sphere);
+	EXPECT_NE(sphere, box);
+	EXPECT_EQ(sphere->getShapeType(), SPHERE_SHAPE_PROXYTYPE);
+
+	const auto capsule = cache.GetCapsule(0.5f, 1.6f);
+	EXPECT_EQ(cache.GetCapsule(0.5f, 1.6f), capsule);
+	EXPECT_NE(cache.GetCapsule(0.5f, 1.8f), capsule);
+	EXPECT_EQ(capsule->getShapeType(), CAPSULE_SHAPE_PROXYTYPE);
+}
+
+TEST(CollisionShapeCache, KeepsDimensions) {
+	CollisionShapeCache& cache = CollisionShapeCache::Get();
+	const auto box = std::static_pointer_cast<btBoxShape>(cache.GetBox(0.25f, 1.5f, 3.f));
+	const btVector3 half_extents = box->getHalfExtentsWithMargin();
+	EXPECT_FLOAT_EQ(half_extents.x(), 0.25f);
+	EXPECT_FLOAT_EQ(half_extents.y(), 1.5f);
+	EXPECT_FLOAT_EQ(half_extents.z(), 3.f);
+
+	const auto capsule = std::static_pointer_cast<btCapsuleShape>(cache.GetCapsule(0.4f, 0.8f));
+	EXPECT_NEAR(capsule->getRadius(), 0.4f, CollisionShapeCache::DIMENSION_QUANTUM);
+	EXPECT_NEAR(capsule->getHalfHeight() * 2.f, 0.8f, CollisionShapeCache::DIMENSION_QUANTUM);
+}
+
+TEST(CollisionShapeCache, ReleasesUnusedShapes) {
+	CollisionShapeCache& cache = CollisionShapeCache::Get();
+	cache.Evict();
+	const CollisionShapeCacheStats before = cache.GetStats();
+	{
+		const auto sphere = cache.GetSphere(12.75f);
+		EXPECT_EQ(cache.GetStats().live_shapes, before.live_shapes + 1);
+		EXPECT_EQ(cache.GetStats().live_bytes, before.live_bytes + sizeof(btSphereShape));
+	}
+	const CollisionShapeCacheStats after = cache.GetStats();
+	EXPECT_EQ(after.live_shapes, before.live_shapes);
+	EXPECT_EQ(after.live_bytes, before.live_bytes);
+	EXPECT_EQ(after.releases, before.releases + 1);
+	EXPECT_EQ(after.entries, before.entries + 1);
+
+	EXPECT_EQ(cache.Evict(), 1u);
+	EXPECT_EQ(cache.GetStats().entries, before.entries);
+}
+
+TEST(CollisionShapeCache, SharesAcrossThreads) {
+	CollisionShapeCache& cache = CollisionShapeCache::Get();
+	std::vector<std::shared_ptr<btCollisionShape>> shapes(4);
+	std::vector<std::thread> threads;
+	for (std::size_t i = 0; i < shapes.size(); ++i) {
+		threads.emplace_back([&cache, &shapes, i]() {
+			for (int j = 0; j < 1000; ++j) {
+				shapes[i] = cache.GetBox(7.f, 7.f, 7.f);
+			}
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	for (const auto& shape : shapes) {
+		EXPECT_EQ(shape, shapes[0]);
+	}
+}
+} // namespace tec
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "command-queue.hpp"
+#include "small-function.hpp"
+
+namespace tec {
+namespace {
+class OrderSystem : public CommandQueue<OrderSystem> {
+public:
+	std::vector<int> ran;
+};
+
+class DropSystem : public CommandQueue<DropSystem> {
+public:
+	int ran{0};
+};
+
+class ConcurrentSystem : public CommandQueue<ConcurrentSystem> {
+public:
+	bool ordered{true};
+	std::array<int, 4> next{};
+	int total{0};
+};
+} // namespace
+
+TEST(SmallFunction, StoresSmallCallablesInline) {
+	int value = 0;
+	auto small = [&value](const int add) { value += add; };
+	std::array<char, 128> big_capture{};
+	auto big = [&value, big_capture](const int add) { value += add + big_capture[0]; };
+	EXPECT_TRUE(SmallFunction<void(int)>::IsInline<decltype(small)>());
+	EXPECT_FALSE(SmallFunction<void(int)>::IsInline<decltype(big)>());
+	EXPECT_TRUE(SmallFunction<void(int)>::IsInline<std::function<void(int)>>());
+
+	SmallFunction<void(int)> a(small);
+	SmallFunction<void(int)> b(big);
+	SmallFunction<void(int)> moved(std::move(b));
+	a(1);
+	moved(2);
+	EXPECT_EQ(value, 3);
+	EXPECT_FALSE(b);
+}
+
+TEST(SmallFunction, DestroysMoveOnlyCaptures) {
+	auto counter = std::make_shared<int>(0);
+	{
+		SmallFunction<int()> function([owned = std::make_unique<int>(5), counter] { return *owned; });
+		SmallFunction<int()> other;
+		other = std::move(function);
+		EXPECT_EQ(other(), 5);
+		EXPECT_EQ(counter.use_count(), 2);
+	}
+	EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(CommandQueue, RunsCommandsInOrderPastCapacity) {
+	OrderSystem system;
+	const int count = static_cast<int>(OrderSystem::DEFAULT_CAPACITY) + 10;
+	for (int i = 0; i < count; ++i) {
+		EXPECT_TRUE(OrderSystem::QueueCommand([i](OrderSystem* s) { s->ran.push_back(i); }));
+	}
+	EXPECT_EQ(OrderSystem::GetStats().depth, count);
+	system.ProcessCommandQueue();
+	ASSERT_EQ(system.ran.size(), count);
+	for (int i = 0; i < count; ++i) {
+		EXPECT_EQ(system.ran[i], i);
+	}
+
+	const CommandQueueStats stats = OrderSystem::GetStats();
+	EXPECT_EQ(stats.depth, 0);
+	EXPECT_EQ(stats.high_water, count);
+	EXPECT_EQ(stats.processed, count);
+	EXPECT_EQ(stats.dropped, 0);
+}
+
+TEST(CommandQueue, ReleasesCapturesOnceRun) {
+	OrderSystem system;
+	auto counter = std::make_shared<int>(0);
+	OrderSystem::QueueCommand([counter](OrderSystem*) { ++*counter; });
+	EXPECT_EQ(counter.use_count(), 2);
+	system.ProcessCommandQueue();
+	EXPECT_EQ(*counter, 1);
+	// the ring cell doesn't hold on to the command until a later push reuses it
+	EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(CommandQueue, CommandsQueuedWhileProcessingRunNextTime) {
+	OrderSystem system;
+	OrderSystem::QueueCommand([](OrderSystem* s) {
+		s->ran.push_back(1);
+		OrderSystem::QueueCommand([](OrderSystem* s) { s->ran.push_back(2); });
+	});
+	system.ProcessCommandQueue();
+	EXPECT_EQ(system.ran, (std::vector<int>{1}));
+	system.ProcessCommandQueue();
+	EXPECT_EQ(system.ran, (std::vector<int>{1, 2}));
+}
+
+TEST(CommandQueue, DropPolicyDiscardsWhenFull) {
+	DropSystem::SetOverflowPolicy(OverflowPolicy::DROP);
+	DropSystem system;
+	const std::size_t capacity = DropSystem::GetStats().capacity;
+	for (std::size_t i = 0; i < capacity; ++i) {
+		EXPECT_TRUE(DropSystem::QueueCommand([](DropSystem* s) { ++s->ran; }));
+	}
+	EXPECT_FALSE(DropSystem::QueueCommand([](DropSystem* s) { ++s->ran; }));
+	system.ProcessCommandQueue();
+	EXPECT_EQ(system.ran, capacity);
+	EXPECT_EQ(DropSystem::GetStats().dropped, 1);
+}
+
+TEST(CommandQueue, ConcurrentProducersKeepPerProducerOrder) {
+	ConcurrentSystem system;
+	const int per_producer = 20000;
+	std::vector<std::thread> producers;
+	for (int p = 0; p < 4; ++p) {
+		producers.emplace_back([p] {
+			for (int i = 0; i < per_producer; ++i) {
+				ConcurrentSystem::QueueCommand([p, i](ConcurrentSystem* s) {
+					s->ordered = s->ordered && s->next[p] == i;
+					++s->next[p];
+					++s->total;
+				});
+			}
+		});
+	}
+	while (system.total < 4 * per_producer) {
+		system.ProcessCommandQueue();
+	}
+	for (auto& producer : producers) {
+		producer.join();
+	}
+	EXPECT_TRUE(system.ordered);
+}
+} // namespace tec
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <set>
+
+#include "component-pool.hpp"
+#include "entity.hpp"
+
+namespace tec {
+namespace {
+int live_components = 0;
+
+struct PoolTestComponent {
+	PoolTestComponent() { ++live_components; }
+	explicit PoolTestComponent(int value) : value(value) { ++live_components; }
+	~PoolTestComponent() { --live_components; }
+	int value{0};
+};
+
+struct alignas(16) AlignedPoolTestComponent {
+	float values[4]{};
+};
+} // namespace
+
+TEST(ComponentPool, CreateDestroyReusesSlots) {
+	using Pool = ComponentPool<PoolTestComponent>;
+	const auto before = Pool::Get().GetStats();
+
+	PoolTestComponent* first = Pool::Create(42);
+	EXPECT_EQ(first->value, 42);
+	EXPECT_EQ(live_components, 1);
+	Pool::Destroy(first);
+	EXPECT_EQ(live_components, 0);
+
+	// the freed slot is handed out again
+	PoolTestComponent* second = Pool::Create();
+	EXPECT_EQ(second, first);
+	Pool::Destroy(second);
+	Pool::Destroy(nullptr);
+
+	const auto after = Pool::Get().GetStats();
+	EXPECT_EQ(after.live, before.live);
+	EXPECT_EQ(after.allocations - before.allocations, 2);
+	EXPECT_EQ(after.releases - before.releases, 2);
+}
+
+TEST(ComponentPool, DoubleDestroyIsIgnored) {
+	using Pool = ComponentPool<PoolTestComponent>;
+	const auto before = Pool::Get().GetStats();
+
+	PoolTestComponent* component = Pool::Create();
+	Pool::Destroy(component);
+	Pool::Destroy(component);
+	EXPECT_EQ(live_components, 0);
+	EXPECT_EQ(Pool::Get().GetStats().live, before.live);
+	EXPECT_EQ(Pool::Get().GetStats().releases, before.releases + 1);
+
+	// the slot went on the free list once, so it isn't handed out twice
+	PoolTestComponent* first = Pool::Create();
+	PoolTestComponent* second = Pool::Create();
+	EXPECT_NE(first, second);
+	Pool::Destroy(first);
+	Pool::Destroy(second);
+}
+
+TEST(ComponentPool, AddressesStayStableAcrossChunks) {
+	using Pool = ComponentPool<PoolTestComponent, 8>;
+	std::vector<PoolTestComponent*> components;
+	for (int i = 0; i < 100; ++i) {
+		components.push_back(Pool::Create(i));
+	}
+	EXPECT_GE(Pool::Get().GetStats().chunks, 100 / 8);
+	std::set<PoolTestComponent*> unique(components.begin(), components.end());
+	EXPECT_EQ(unique.size(), components.size());
+	for (int i = 0; i < 100; ++i) {
+		EXPECT_EQ(components[i]->value, i);
+	}
+	for (auto* component : components) {
+		Pool::Destroy(component);
+	}
+	EXPECT_EQ(Pool::Get().GetStats().live, 0);
+}
+
+TEST(ComponentPool, HonorsAlignment) {
+	for (int i = 0; i < 10; ++i) {
+		auto* component = ComponentPool<AlignedPoolTestComponent>::Create();
+		EXPECT_EQ(reinterpret_cast<std::uintptr_t>(component) % alignof(AlignedPoolTestComponent), 0);
+	}
+	ComponentPool<AlignedPoolTestComponent>::Get().ReleaseAll();
+}
+
+TEST(ComponentPool, EntityReturnsComponentsToPool) {
+	Entity entity(1234);
+	entity.Add<PoolTestComponent>(1);
+	EXPECT_EQ(live_components, 1);
+	// replacing a component destroys the old one
+	entity.Update(ComponentPool<PoolTestComponent>::Create(2));
+	EXPECT_EQ(live_components, 1);
+	EXPECT_EQ(entity.Get<PoolTestComponent>()->value, 2);
+	entity.Remove<PoolTestComponent>();
+	EXPECT_EQ(live_components, 0);
+	EXPECT_FALSE(entity.Has<PoolTestComponent>());
+}
+
+TEST(ComponentPool, ReleaseAllDropsMultitonEntries) {
+	using Pool = ComponentPool<PoolTestComponent>;
+	for (eid entity_id = 1; entity_id <= 10; ++entity_id) {
+		Entity(entity_id).Add<PoolTestComponent>(static_cast<int>(entity_id));
+	}
+	EXPECT_EQ(live_components, 10);
+	Pool::Get().ReleaseAll();
+	EXPECT_EQ(live_components, 0);
+	EXPECT_EQ(Pool::Get().GetStats().live, 0);
+	EXPECT_EQ((Multiton<eid, PoolTestComponent*>::Size()), 0);
+
+	bool listed = false;
+	for (const auto& stats : ComponentPoolBase::GetAllStats()) {
+		listed |= stats.allocations > 0 && stats.live == 0 && stats.capacity >= 10;
+	}
+	EXPECT_TRUE(listed);
+}
+} // namespace tec
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "component-store.hpp"
+#include "multiton.hpp"
+
+namespace tec {
+struct StoreTestComponent {
+	StoreTestComponent() = default;
+	StoreTestComponent(int value, std::string name) : value(value), name(std::move(name)) {}
+	int value{0};
+	std::string name;
+};
+
+TEST(ComponentStore, EmplaceFindRemove) {
+	ComponentStore<StoreTestComponent> store;
+	EXPECT_TRUE(store.Empty());
+	EXPECT_EQ(store.Find(10000), nullptr);
+
+	store.Emplace(10000, 1, "one");
+	store.Emplace(10001, 2, "two");
+	store.Set(5, StoreTestComponent{3, "three"});
+	ASSERT_EQ(store.Size(), 3);
+	ASSERT_TRUE(store.Has(10001));
+	EXPECT_EQ(store.Find(10001)->value, 2);
+	EXPECT_EQ(store.Find(5)->name, "three");
+
+	EXPECT_TRUE(store.Remove(10000));
+	EXPECT_FALSE(store.Remove(10000));
+	EXPECT_FALSE(store.Has(10000));
+	EXPECT_EQ(store.Size(), 2);
+	// the remaining components are still reachable after the swap
+	EXPECT_EQ(store.Find(10001)->value, 2);
+	EXPECT_EQ(store.Find(5)->value, 3);
+}
+
+TEST(ComponentStore, EmplaceReplacesExisting) {
+	ComponentStore<StoreTestComponent> store;
+	store.Emplace(42, 1, "first");
+	const auto version = store.GetVersion();
+	store.Emplace(42, 2, "second");
+	EXPECT_EQ(store.Size(), 1);
+	EXPECT_EQ(store.Find(42)->name, "second");
+	// overwriting a value isn't a structural change
+	EXPECT_EQ(store.GetVersion(), version);
+}
+
+TEST(ComponentStore, DenseIterationMatchesContents) {
+	ComponentStore<int> store;
+	for (eid id = 0; id < 10000; id += 3) {
+		store.Set(id, static_cast<int>(id));
+	}
+	for (eid id = 0; id < 10000; id += 6) {
+		store.Remove(id);
+	}
+	std::size_t count = 0;
+	for (const auto& [entity_id, value] : store) {
+		EXPECT_EQ(static_cast<eid>(value), entity_id);
+		EXPECT_EQ(entity_id % 6, 3);
+		++count;
+	}
+	EXPECT_EQ(count, store.Size());
+}
+
+TEST(ComponentStore, DistinguishesIdsSharingSparseKey) {
+	ComponentStore<int> store;
+	const eid low = 7;
+	const eid high = (static_cast<eid>(1) << 32) | low;
+	store.Set(low, 1);
+	EXPECT_FALSE(store.Has(high));
+	store.Overwrite(high, 2);
+	EXPECT_FALSE(store.Has(low));
+	EXPECT_EQ(*store.Find(high), 2);
+	EXPECT_EQ(store.Size(), 1);
+}
+
+TEST(ComponentStoreDeathTest, SetRefusesSlotOfLiveGeneration) {
+	ComponentStore<int> store;
+	const eid low = 7;
+	const eid high = (static_cast<eid>(1) << 32) | low;
+	store.Set(low, 1);
+	// the entity of the older generation was never removed, its slot must not be taken over
+	EXPECT_DEBUG_DEATH(store.Set(high, 2), "another generation");
+	store.Remove(low);
+	store.Set(high, 2);
+	EXPECT_EQ(*store.Find(high), 2);
+}
+
+TEST(ComponentStore, Clear) {
+	ComponentStore<int> store;
+	store.Set(1, 1);
+	store.Set(2, 2);
+	store.Clear();
+	EXPECT_TRUE(store.Empty());
+	EXPECT_FALSE(store.Has(1));
+	store.Set(2, 3);
+	EXPECT_EQ(*store.Find(2), 3);
+}
+
+TEST(ComponentStore, MultitonPointerApi) {
+	using TestMap = Multiton<eid, StoreTestComponent*>;
+	StoreTestComponent a{1, "a"}, b{2, "b"};
+	TestMap::Set(100, &a);
+	TestMap::Set(200, &b);
+	EXPECT_TRUE(TestMap::Has(100));
+	EXPECT_EQ(TestMap::Get(200), &b);
+	EXPECT_EQ(TestMap::Get(300), nullptr);
+	EXPECT_EQ(TestMap::Size(), 2);
+	EXPECT_EQ(TestMap::Keys().size(), 2);
+
+	int sum = 0;
+	for (auto itr = TestMap::Begin(); itr != TestMap::End(); ++itr) {
+		sum += itr->second->value;
+	}
+	EXPECT_EQ(sum, 3);
+
+	TestMap::Remove(100);
+	EXPECT_FALSE(TestMap::Has(100));
+	ASSERT_EQ(TestMap::Keys().size(), 1);
+	EXPECT_EQ(TestMap::Keys()[0], 200);
+	TestMap::Remove(200);
+}
+} // namespace tec
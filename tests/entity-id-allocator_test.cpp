@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "component-store.hpp"
+#include "entity-id-allocator.hpp"
+
+namespace tec {
+TEST(EntityIdAllocator, FreshIdsAreSequentialIndices) {
+	EntityIdAllocator allocator(10000);
+	EXPECT_EQ(allocator.Allocate(), 10000);
+	EXPECT_EQ(allocator.Allocate(), 10001);
+	EXPECT_EQ(allocator.GetLiveCount(), 2);
+	EXPECT_EQ(allocator.GetIndexCount(), 2);
+}
+
+TEST(EntityIdAllocator, RecyclesIndicesWithNewGeneration) {
+	EntityIdAllocator allocator;
+	const eid first = allocator.Allocate();
+	ASSERT_TRUE(allocator.Release(first));
+	EXPECT_FALSE(allocator.IsAlive(first));
+
+	const eid second = allocator.Allocate();
+	EXPECT_NE(second, first);
+	EXPECT_EQ(GetEntityIndex(second), GetEntityIndex(first));
+	EXPECT_EQ(GetEntityGeneration(second), GetEntityGeneration(first) + 1);
+	EXPECT_TRUE(allocator.IsAlive(second));
+	EXPECT_EQ(allocator.GetIndexCount(), 1);
+}
+
+TEST(EntityIdAllocator, DetectsStaleHandles) {
+	EntityIdAllocator allocator;
+	const eid id = allocator.Allocate();
+	EXPECT_TRUE(allocator.Release(id));
+	EXPECT_FALSE(allocator.Release(id));
+	EXPECT_FALSE(allocator.IsAlive(0));
+	EXPECT_FALSE(allocator.IsAlive(MakeEntityId(12345, 0)));
+
+	// a stale ID doesn't find the component of the entity that reused its index
+	const eid reused = allocator.Allocate();
+	ComponentStore<int> store;
+	store.Set(reused, 1);
+	EXPECT_EQ(store.Find(id), nullptr);
+	EXPECT_FALSE(store.Remove(id));
+	EXPECT_EQ(*store.Find(reused), 1);
+}
+
+TEST(EntityIdAllocator, ConcurrentAllocationIsUnique) {
+	EntityIdAllocator allocator;
+	const int thread_count = 4;
+	const int per_thread = 1000;
+	std::vector<std::vector<eid>> results(thread_count);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < thread_count; ++t) {
+		threads.emplace_back([&allocator, &results, t] {
+			for (int i = 0; i < per_thread; ++i) {
+				const eid id = allocator.Allocate();
+				results[t].push_back(id);
+				if (i % 2 == 0) {
+					allocator.Release(id);
+				}
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	std::vector<eid> all;
+	for (const auto& ids : results) {
+		all.insert(all.end(), ids.begin(), ids.end());
+	}
+	std::sort(all.begin(), all.end());
+	EXPECT_EQ(std::adjacent_find(all.begin(), all.end()), all.end());
+	EXPECT_EQ(allocator.GetLiveCount(), thread_count * per_thread / 2);
+	EXPECT_LE(allocator.GetIndexCount(), all.size());
+}
+} // namespace tec
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "event-bus.hpp"
+#include "event-system.hpp"
+#include "mpsc-ring.hpp"
+
+namespace tec {
+namespace {
+struct BusTestEvent {
+	int producer{0};
+	int value{0};
+};
+
+class BusTestReceiver : public BufferedEventQueue<BusTestEvent> {
+public:
+	explicit BusTestReceiver(const std::size_t capacity = DEFAULT_CAPACITY) :
+			BufferedEventQueue<BusTestEvent>(capacity) {}
+	BusTestReceiver(const eid entity_id, const std::size_t capacity) :
+			BufferedEventQueue<BusTestEvent>(entity_id, capacity) {}
+	void On(const eid entity_id, const BusTestEvent& data) override {
+		this->received.emplace_back(entity_id, data.value);
+	}
+	std::vector<std::pair<eid, int>> received;
+};
+
+struct SystemTestEvent {
+	int value{0};
+};
+
+class SystemTestReceiver : public EventQueue<SystemTestEvent> {
+public:
+	void On(const eid, std::shared_ptr<SystemTestEvent> data) override { this->received.push_back(data->value); }
+	std::vector<int> received;
+};
+} // namespace
+
+TEST(MPSCRing, FailsWhenFullAndKeepsOrder) {
+	MPSCRing<int> ring(3);
+	EXPECT_EQ(ring.Capacity(), 4);
+	for (int i = 0; i < 4; ++i) {
+		EXPECT_TRUE(ring.TryPush(i));
+	}
+	EXPECT_FALSE(ring.TryPush(4));
+	EXPECT_EQ(ring.Size(), 4);
+
+	std::vector<int> drained;
+	EXPECT_EQ(ring.ConsumeAll([&drained](int&& value) { drained.push_back(value); }), 4);
+	EXPECT_EQ(drained, (std::vector<int>{0, 1, 2, 3}));
+	EXPECT_TRUE(ring.TryPush(4));
+	EXPECT_EQ(ring.Size(), 1);
+}
+
+TEST(EventBus, DeliversToAllAndEntitySubscribers) {
+	BusTestReceiver all;
+	BusTestReceiver filtered(42, 16);
+	EventBus<BusTestEvent>::Get().Emit(42, BusTestEvent{0, 1});
+	EventBus<BusTestEvent>::Get().Emit(7, BusTestEvent{0, 2});
+	EventBus<BusTestEvent>::Get().Emit(BusTestEvent{0, 3});
+
+	all.ProcessEventQueue();
+	filtered.ProcessEventQueue();
+	EXPECT_EQ(all.received, (std::vector<std::pair<eid, int>>{{42, 1}, {7, 2}, {0, 3}}));
+	EXPECT_EQ(filtered.received, (std::vector<std::pair<eid, int>>{{42, 1}}));
+}
+
+TEST(EventBus, BurstsSpillOverInOrder) {
+	BusTestReceiver receiver(4);
+	std::vector<BusTestEvent> burst;
+	for (int i = 0; i < 10; ++i) {
+		burst.push_back(BusTestEvent{0, i});
+	}
+	EventBus<BusTestEvent>::Get().EmitMany(burst);
+	receiver.ProcessEventQueue();
+	ASSERT_EQ(receiver.received.size(), 10);
+	for (int i = 0; i < 10; ++i) {
+		EXPECT_EQ(receiver.received[i].second, i);
+	}
+
+	// back to the ring once the overflow was drained
+	receiver.received.clear();
+	EventBus<BusTestEvent>::Get().Emit(BusTestEvent{0, 10});
+	receiver.ProcessEventQueue();
+	EXPECT_EQ(receiver.received, (std::vector<std::pair<eid, int>>{{0, 10}}));
+}
+
+TEST(EventBus, DestroyedSubscribersAreForgotten) {
+	{
+		BusTestReceiver receiver;
+	}
+	// would write into the destroyed receiver if it were still subscribed
+	EventBus<BusTestEvent>::Get().Emit(BusTestEvent{0, 1});
+}
+
+TEST(EventBus, ConcurrentProducersKeepPerProducerOrder) {
+	class OrderReceiver : public BufferedEventQueue<BusTestEvent> {
+	public:
+		OrderReceiver() : BufferedEventQueue<BusTestEvent>(64) {}
+		void On(const eid, const BusTestEvent& data) override {
+			this->ordered = this->ordered && data.value == this->next[data.producer];
+			++this->next[data.producer];
+			++this->total;
+		}
+		bool ordered{true};
+		int next[4]{0, 0, 0, 0};
+		int total{0};
+	};
+	OrderReceiver receiver;
+	const int per_producer = 20000;
+	std::vector<std::thread> producers;
+	for (int p = 0; p < 4; ++p) {
+		producers.emplace_back([p] {
+			for (int i = 0; i < per_producer; ++i) {
+				EventBus<BusTestEvent>::Get().Emit(BusTestEvent{p, i});
+			}
+		});
+	}
+	while (receiver.total < 4 * per_producer) {
+		receiver.ProcessEventQueue();
+	}
+	for (auto& producer : producers) {
+		producer.join();
+	}
+	EXPECT_TRUE(receiver.ordered);
+	EXPECT_EQ(receiver.total, 4 * per_producer);
+}
+
+TEST(EventSystem, EmitManyKeepsOrder) {
+	SystemTestReceiver receiver;
+	std::vector<std::shared_ptr<SystemTestEvent>> batch;
+	for (int i = 0; i < 3; ++i) {
+		batch.push_back(std::make_shared<SystemTestEvent>(SystemTestEvent{i}));
+	}
+	EventSystem<SystemTestEvent>::Get()->EmitMany(batch);
+	receiver.ProcessEventQueue();
+	EXPECT_EQ(receiver.received, (std::vector<int>{0, 1, 2}));
+	EventSystem<SystemTestEvent>::Get()->Unsubscribe(&receiver);
+}
+} // namespace tec
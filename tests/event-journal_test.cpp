@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "event-journal.hpp"
+#include "event-system.hpp"
+
+namespace tec {
+namespace {
+class ReplayedCommands : public EventQueue<ClientCommandsEvent>, public EventQueue<EntityDestroyed> {
+public:
+	~ReplayedCommands() {
+		EventSystem<ClientCommandsEvent>::Get()->Unsubscribe(this);
+		EventSystem<EntityDestroyed>::Get()->Unsubscribe(this);
+	}
+	void On(eid, std::shared_ptr<ClientCommandsEvent> data) override {
+		command_ids.push_back(data->client_commands.commandid());
+	}
+	void On(eid entity_id, std::shared_ptr<EntityDestroyed>) override { destroyed.push_back(entity_id); }
+
+	std::vector<state_id_t> command_ids;
+	std::vector<eid> destroyed;
+};
+} // namespace
+
+TEST(EventJournal, RoundTripsEventsAndTicks) {
+	std::stringstream journal_data;
+	{
+		EventJournalWriter writer(journal_data);
+		auto created = std::make_shared<EntityCreated>();
+		created->entity.set_id(42);
+		EventSystem<EntityCreated>::Get()->Emit(created);
+		writer.RecordTick(0.25);
+
+		auto commands = std::make_shared<ClientCommandsEvent>();
+		commands->client_commands.set_id(42);
+		commands->client_commands.set_commandid(7);
+		EventSystem<ClientCommandsEvent>::Get()->Emit(commands);
+		EventSystem<EntityDestroyed>::Get()->Emit(42, std::make_shared<EntityDestroyed>());
+		writer.RecordTick(0.5);
+	}
+
+	EventJournalReader reader(journal_data);
+	ASSERT_TRUE(reader.IsValid());
+	std::vector<JournalRecord> records;
+	JournalRecord record;
+	while (reader.Next(record)) {
+		records.push_back(record);
+	}
+	ASSERT_EQ(records.size(), 5);
+	EXPECT_EQ(records[0].type, JournalRecordType::ENTITY_CREATED);
+	EXPECT_EQ(records[0].entity_id, 42);
+	EXPECT_EQ(records[1].type, JournalRecordType::TICK);
+	EXPECT_EQ(records[1].delta, 0.25);
+	EXPECT_EQ(records[1].entity_id, 0);
+	EXPECT_TRUE(records[1].payload.empty());
+	EXPECT_EQ(records[2].type, JournalRecordType::ENTITY_DESTROYED);
+	EXPECT_EQ(records[2].delta, 0.0);
+	EXPECT_EQ(records[2].timestamp_ns, 0);
+	EXPECT_EQ(records[3].type, JournalRecordType::CLIENT_COMMANDS);
+	EXPECT_EQ(records[4].type, JournalRecordType::TICK);
+	EXPECT_EQ(records[4].delta, 0.5);
+	EXPECT_GE(records[4].timestamp_ns, records[1].timestamp_ns);
+
+	ReplayedCommands replayed;
+	reader.Emit(records[2]);
+	reader.Emit(records[3]);
+	replayed.EventQueue<ClientCommandsEvent>::ProcessEventQueue();
+	replayed.EventQueue<EntityDestroyed>::ProcessEventQueue();
+	EXPECT_EQ(replayed.command_ids, (std::vector<state_id_t>{7}));
+	EXPECT_EQ(replayed.destroyed, (std::vector<eid>{42}));
+}
+
+TEST(EventJournal, RejectsOtherFiles) {
+	std::stringstream not_a_journal("{\"users\": []}");
+	EventJournalReader reader(not_a_journal);
+	EXPECT_FALSE(reader.IsValid());
+	JournalRecord record;
+	EXPECT_FALSE(reader.Next(record));
+}
+
+TEST(EventJournal, StopsAtTruncatedRecord) {
+	std::stringstream journal_data;
+	{
+		EventJournalWriter writer(journal_data);
+		auto created = std::make_shared<EntityCreated>();
+		created->entity.set_id(1);
+		EventSystem<EntityCreated>::Get()->Emit(created);
+		writer.RecordTick(0.25);
+	}
+	std::string data = journal_data.str();
+	data.resize(data.size() - 20); // cut into the entity record
+	std::stringstream truncated(data);
+	EventJournalReader reader(truncated);
+	ASSERT_TRUE(reader.IsValid());
+	JournalRecord record;
+	EXPECT_FALSE(reader.Next(record));
+}
+
+TEST(EventJournal, GameStateHashIgnoresInsertionOrder) {
+	GameState a, b;
+	a.positions[1] = Position(glm::vec3(1.f, 2.f, 3.f));
+	a.positions[2] = Position(glm::vec3(4.f, 5.f, 6.f));
+	b.positions[2] = Position(glm::vec3(4.f, 5.f, 6.f));
+	b.positions[1] = Position(glm::vec3(1.f, 2.f, 3.f));
+	EXPECT_EQ(HashGameState(a), HashGameState(b));
+	b.positions[1].value.x = 1.5f;
+	EXPECT_NE(HashGameState(a), HashGameState(b));
+}
+} // namespace tec
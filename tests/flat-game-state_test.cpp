@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "flat-game-state.hpp"
+
+namespace tec {
+namespace {
+GameState MakeGameState() {
+	GameState state;
+	state.positions[30] = Position(glm::vec3(3.f, 0.f, 0.f));
+	state.positions[10] = Position(glm::vec3(1.f, 0.f, 0.f));
+	state.positions[20] = Position(glm::vec3(2.f, 0.f, 0.f));
+	state.orientations[20] = Orientation(glm::quat(0.f, 1.f, 0.f, 0.f));
+	state.velocities[10] = Velocity(glm::vec3(0.f, 1.f, 0.f), glm::vec3(0.f));
+	state.velocities[40] = Velocity(glm::vec3(0.f, 4.f, 0.f), glm::vec3(0.f));
+	state.state_id = 5;
+	return state;
+}
+} // namespace
+
+TEST(FlatGameState, ConvertsFromAndToGameState) {
+	const FlatGameState flat = FlatGameState::From(MakeGameState());
+	EXPECT_EQ(flat.entity_ids, (std::vector<eid>{10, 20, 30, 40}));
+	EXPECT_EQ(flat.present[0], FlatGameState::HAS_POSITION | FlatGameState::HAS_VELOCITY);
+	EXPECT_EQ(flat.present[1], FlatGameState::HAS_POSITION | FlatGameState::HAS_ORIENTATION);
+	EXPECT_EQ(flat.present[3], FlatGameState::HAS_VELOCITY);
+	EXPECT_EQ(flat.GetPosition(30)->value.x, 3.f);
+	EXPECT_EQ(flat.GetOrientation(10), nullptr);
+	EXPECT_EQ(flat.GetPosition(50), nullptr);
+	EXPECT_EQ(flat.state_id, 5);
+
+	const GameState back = flat.ToGameState();
+	EXPECT_EQ(back.positions.size(), 3);
+	EXPECT_EQ(back.orientations.size(), 1);
+	EXPECT_EQ(back.velocities.size(), 2);
+	EXPECT_EQ(back.velocities.at(40).linear.y, 4.f);
+}
+
+TEST(FlatGameState, SetKeepsIdsSorted) {
+	FlatGameState flat;
+	flat.SetPosition(20, Position(glm::vec3(2.f)));
+	flat.SetPosition(10, Position(glm::vec3(1.f)));
+	flat.SetVelocity(30, Velocity());
+	flat.SetOrientation(20, Orientation());
+	EXPECT_EQ(flat.entity_ids, (std::vector<eid>{10, 20, 30}));
+	EXPECT_EQ(flat.GetPosition(20)->value.x, 2.f);
+	EXPECT_NE(flat.GetOrientation(20), nullptr);
+
+	flat.RemoveEntity(20);
+	EXPECT_EQ(flat.entity_ids, (std::vector<eid>{10, 30}));
+	EXPECT_EQ(flat.Find(20), FlatGameState::npos);
+	EXPECT_EQ(flat.GetPosition(10)->value.x, 1.f);
+}
+
+TEST(FlatGameState, MergeJoinVisitsTheUnionInOrder) {
+	FlatGameState a, b;
+	a.SetPosition(1, Position());
+	a.SetPosition(3, Position());
+	b.SetPosition(2, Position());
+	b.SetPosition(3, Position());
+	std::vector<eid> visited;
+	std::vector<bool> in_both;
+	FlatGameState::MergeJoin(a, b, [&](const eid entity_id, const std::size_t i, const std::size_t j) {
+		visited.push_back(entity_id);
+		in_both.push_back(i != FlatGameState::npos && j != FlatGameState::npos);
+	});
+	EXPECT_EQ(visited, (std::vector<eid>{1, 2, 3}));
+	EXPECT_EQ(in_both, (std::vector<bool>{false, false, true}));
+}
+
+TEST(FlatGameState, MergeOverlaysNewerComponents) {
+	FlatGameState base = FlatGameState::From(MakeGameState());
+	FlatGameState newer;
+	newer.SetPosition(20, Position(glm::vec3(9.f)));
+	newer.SetPosition(25, Position(glm::vec3(7.f)));
+	newer.state_id = 6;
+
+	base.Merge(newer);
+	EXPECT_EQ(base.entity_ids, (std::vector<eid>{10, 20, 25, 30, 40}));
+	EXPECT_EQ(base.GetPosition(20)->value.x, 9.f);
+	EXPECT_NE(base.GetOrientation(20), nullptr); // kept, newer didn't hold one
+	EXPECT_EQ(base.GetPosition(25)->value.x, 7.f);
+	EXPECT_EQ(base.state_id, 6);
+
+	// only known entities, merged in place
+	newer.Clear();
+	newer.SetPosition(40, Position(glm::vec3(4.f)));
+	base.Merge(newer);
+	EXPECT_EQ(base.Size(), 5);
+	EXPECT_EQ(base.GetPosition(40)->value.x, 4.f);
+	EXPECT_NE(base.GetVelocity(40), nullptr);
+}
+
+TEST(FlatGameState, ProtoRoundTripMatchesGameState) {
+	const GameState state = MakeGameState();
+	proto::GameStateUpdate from_map, from_flat;
+	state.Out(&from_map);
+	FlatGameState::From(state).Out(&from_flat);
+	EXPECT_EQ(from_map.entity_size(), from_flat.entity_size());
+
+	FlatGameState flat;
+	flat.In(from_map);
+	GameState map;
+	map.In(from_flat);
+	EXPECT_EQ(flat.Size(), map.positions.size());
+	EXPECT_EQ(flat.GetPosition(30)->value.x, map.positions.at(30).value.x);
+	EXPECT_EQ(flat.GetOrientation(20)->value.x, map.orientations.at(20).value.x);
+	EXPECT_EQ(flat.GetVelocity(10)->linear.y, map.velocities.at(10).linear.y);
+	// like GameState::Out(), an entity with only a velocity isn't sent
+	EXPECT_EQ(flat.Find(40), FlatGameState::npos);
+}
+} // namespace tec
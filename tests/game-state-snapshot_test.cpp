@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include "game-state-snapshot.hpp"
+
+namespace tec {
+TEST(GameStateSnapshot, BuilderSharesUntouchedPages) {
+	GameStateSnapshot::Builder builder;
+	for (eid entity_id = 1; entity_id <= 1000; ++entity_id) {
+		builder.SetPosition(entity_id, Position(glm::vec3(static_cast<float>(entity_id))));
+	}
+	const GameStateSnapshot first = builder.Build();
+	EXPECT_EQ(first.Size(), 1000);
+
+	GameStateSnapshot::Builder next(first);
+	next.SetPosition(5, Position(glm::vec3(-1.f)));
+	next.SetVelocity(6, Velocity());
+	const GameStateSnapshot second = next.Build();
+
+	EXPECT_EQ(second.GetVersion(), first.GetVersion() + 1);
+	EXPECT_EQ(first.GetPosition(5)->value.x, 5.f); // the older snapshot doesn't change
+	EXPECT_EQ(second.GetPosition(5)->value.x, -1.f);
+	EXPECT_EQ(first.GetVelocity(6), nullptr);
+	EXPECT_NE(second.GetVelocity(6), nullptr);
+
+	// 1000 entities take 16 pages, both writes landed in the first one
+	const std::size_t pages = (1000 / GameStateSnapshot::PAGE_SIZE) + 1;
+	EXPECT_EQ(second.CountSharedPages(first), pages - 1);
+}
+
+TEST(GameStateSnapshot, RemovesComponentsAndEntities) {
+	GameStateSnapshot::Builder builder;
+	builder.SetPosition(3, Position());
+	builder.SetOrientation(3, Orientation());
+	builder.SetPosition(4, Position());
+	const GameStateSnapshot first = builder.Build();
+
+	GameStateSnapshot::Builder next(first);
+	next.RemoveOrientation(3);
+	next.RemoveEntity(4);
+	next.RemoveEntity(100); // not there, ignored
+	const GameStateSnapshot second = next.Build();
+	EXPECT_EQ(second.Size(), 1);
+	EXPECT_NE(second.GetPosition(3), nullptr);
+	EXPECT_EQ(second.GetOrientation(3), nullptr);
+	EXPECT_EQ(second.Find(4), nullptr);
+	EXPECT_NE(first.Find(4), nullptr);
+}
+
+TEST(GameStateSnapshot, ReusedIndexReplacesOldEntity) {
+	const eid old_entity = MakeEntityId(7, 0);
+	const eid new_entity = MakeEntityId(7, 1);
+	GameStateSnapshot::Builder builder;
+	builder.SetPosition(old_entity, Position(glm::vec3(1.f)));
+	builder.SetVelocity(new_entity, Velocity());
+	const GameStateSnapshot snapshot = builder.Build();
+	EXPECT_EQ(snapshot.Size(), 1);
+	EXPECT_EQ(snapshot.Find(old_entity), nullptr);
+	EXPECT_EQ(snapshot.GetPosition(new_entity), nullptr);
+	EXPECT_NE(snapshot.GetVelocity(new_entity), nullptr);
+}
+
+TEST(GameStateHistory, CapturesOnlyChangedEntities) {
+	GameState state;
+	state.TrackChanges();
+	for (eid entity_id = 1; entity_id <= 1000; ++entity_id) {
+		state.SetPosition(entity_id, Position(glm::vec3(static_cast<float>(entity_id))));
+	}
+	GameStateHistory history(2);
+	const GameStateSnapshot& first = history.Capture(state);
+	EXPECT_EQ(first.Size(), 1000);
+
+	state.SetPosition(900, Position(glm::vec3(0.f)));
+	state.RemoveEntity(901);
+	state.state_id = 2;
+	const GameStateSnapshot second = history.Capture(state);
+	EXPECT_EQ(second.Size(), 999);
+	EXPECT_EQ(second.GetPosition(900)->value.x, 0.f);
+	EXPECT_EQ(second.Find(901), nullptr);
+	EXPECT_EQ(second.state_id, 2);
+	EXPECT_EQ(second.CountSharedPages(*history.Find(0)), 1000 / GameStateSnapshot::PAGE_SIZE);
+
+	// a state with another change history is captured in full
+	GameState other;
+	other.SetPosition(1, Position());
+	other.state_id = 3;
+	const GameStateSnapshot& third = history.Capture(other);
+	EXPECT_EQ(third.Size(), 1);
+	EXPECT_EQ(history.Size(), 2);
+	EXPECT_EQ(history.Find(0), nullptr);
+	EXPECT_EQ(third.ToGameState().positions.size(), 1);
+}
+} // namespace tec
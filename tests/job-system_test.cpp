@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "job-system.hpp"
+#include "work-stealing-deque.hpp"
+
+namespace tec {
+TEST(WorkStealingDeque, OwnerPopsNewestThievesStealOldest) {
+	WorkStealingDeque<int> deque(4);
+	int items[5] = {0, 1, 2, 3, 4};
+	for (int i = 0; i < 4; ++i) {
+		EXPECT_TRUE(deque.Push(&items[i]));
+	}
+	EXPECT_FALSE(deque.Push(&items[4]));
+	EXPECT_EQ(deque.Size(), 4);
+	EXPECT_EQ(deque.Pop(), &items[3]);
+	EXPECT_EQ(deque.Steal(), &items[0]);
+	EXPECT_EQ(deque.Steal(), &items[1]);
+	EXPECT_EQ(deque.Pop(), &items[2]);
+	EXPECT_EQ(deque.Pop(), nullptr);
+	EXPECT_EQ(deque.Steal(), nullptr);
+}
+
+TEST(WorkStealingDeque, EveryItemIsTakenOnce) {
+	constexpr int COUNT = 100000;
+	WorkStealingDeque<int> deque(64);
+	std::vector<int> items(COUNT);
+	std::vector<std::atomic<int>> taken(COUNT);
+	std::atomic<bool> done{false};
+	auto take = [&](int* item) { taken[item - items.data()].fetch_add(1); };
+
+	std::vector<std::thread> thieves;
+	for (int t = 0; t < 3; ++t) {
+		thieves.emplace_back([&]() {
+			while (!done) {
+				if (int* item = deque.Steal()) {
+					take(item);
+				}
+			}
+		});
+	}
+	for (int i = 0; i < COUNT; ++i) {
+		while (!deque.Push(&items[i])) {
+			if (int* item = deque.Pop()) {
+				take(item);
+			}
+		}
+	}
+	while (int* item = deque.Pop()) {
+		take(item);
+	}
+	done = true;
+	for (std::thread& thief : thieves) {
+		thief.join();
+	}
+	while (int* item = deque.Steal()) {
+		take(item);
+	}
+	for (int i = 0; i < COUNT; ++i) {
+		ASSERT_EQ(taken[i], 1) << "item " << i;
+	}
+}
+
+TEST(JobSystem, RunsEveryJobOfAGroup) {
+	JobSystem jobs(3);
+	JobGroup group;
+	std::atomic<int> count{0};
+	for (int i = 0; i < 1000; ++i) {
+		jobs.Run(group, [&count]() { ++count; });
+	}
+	jobs.Wait(group);
+	EXPECT_EQ(count, 1000);
+	EXPECT_TRUE(group.Done());
+}
+
+TEST(JobSystem, ParallelForCoversTheRangeOnce) {
+	JobSystem jobs(3);
+	std::vector<int> hits(10007, 0);
+	jobs.ParallelFor(0, hits.size(), 64, [&hits](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; ++i) {
+			++hits[i];
+		}
+	});
+	EXPECT_EQ(std::accumulate(hits.begin(), hits.end(), 0), static_cast<int>(hits.size()));
+	EXPECT_EQ(*std::min_element(hits.begin(), hits.end()), 1);
+}
+
+TEST(JobSystem, NestedParallelForOnOneWorker) {
+	// waiting inside a job must run the nested jobs rather than block the only worker
+	JobSystem jobs(1);
+	std::atomic<int> count{0};
+	jobs.ParallelFor(0, 8, 1, [&](std::size_t, std::size_t) {
+		jobs.ParallelFor(0, 100, 10, [&](std::size_t begin, std::size_t end) {
+			count += static_cast<int>(end - begin);
+		});
+	});
+	EXPECT_EQ(count, 800);
+}
+
+TEST(JobSystem, ContinuationsRunAfterTheirGroup) {
+	JobSystem jobs(2);
+	JobGroup first, second;
+	std::atomic<int> finished{0};
+	int seen_by_continuation = -1;
+	for (int i = 0; i < 100; ++i) {
+		jobs.Run(first, [&finished]() { ++finished; });
+	}
+	jobs.RunAfter(first, second, [&]() { seen_by_continuation = finished; });
+	jobs.Wait(second);
+	EXPECT_EQ(seen_by_continuation, 100);
+
+	// a finished group runs the continuation right away
+	jobs.Wait(first);
+	jobs.RunAfter(first, second, [&]() { seen_by_continuation = 0; });
+	jobs.Wait(second);
+	EXPECT_EQ(seen_by_continuation, 0);
+}
+
+TEST(JobSystem, WaitRethrowsJobExceptions) {
+	JobSystem jobs(2);
+	JobGroup group;
+	std::atomic<int> count{0};
+	jobs.Run(group, []() { throw std::runtime_error("failed"); });
+	jobs.Run(group, [&count]() { ++count; });
+	EXPECT_THROW(jobs.Wait(group), std::runtime_error);
+	EXPECT_EQ(count, 1);
+	EXPECT_NO_THROW(jobs.Wait(group));
+}
+} // namespace tec
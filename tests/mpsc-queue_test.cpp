@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "event-queue.hpp"
+#include "event-system.hpp"
+#include "mpsc-queue.hpp"
+
+namespace tec {
+namespace {
+struct MPSCTestEvent {
+	int value{0};
+};
+
+class MPSCTestReceiver : public EventQueue<MPSCTestEvent> {
+public:
+	MPSCTestReceiver() = default;
+	explicit MPSCTestReceiver(const eid entity_id) : EventQueue<MPSCTestEvent>(entity_id) {}
+	void On(const eid entity_id, std::shared_ptr<MPSCTestEvent> data) override {
+		this->received.emplace_back(entity_id, data->value);
+	}
+	std::vector<std::pair<eid, int>> received;
+};
+} // namespace
+
+TEST(MPSCQueue, DrainsInPushOrder) {
+	MPSCQueue<std::unique_ptr<int>> queue;
+	for (int i = 0; i < 5; ++i) {
+		queue.Push(std::make_unique<int>(i));
+	}
+	std::vector<int> drained;
+	EXPECT_EQ(queue.ConsumeAll([&drained](std::unique_ptr<int>&& item) { drained.push_back(*item); }), 5);
+	EXPECT_EQ(drained, (std::vector<int>{0, 1, 2, 3, 4}));
+	EXPECT_TRUE(queue.Empty());
+}
+
+TEST(MPSCQueue, ItemsPushedWhileDrainingWaitForTheNextDrain) {
+	MPSCQueue<int> queue;
+	queue.Push(1);
+	EXPECT_EQ(queue.ConsumeAll([&queue](int&& item) { queue.Push(item + 1); }), 1);
+	int drained = 0;
+	EXPECT_EQ(queue.ConsumeAll([&drained](int&& item) { drained = item; }), 1);
+	EXPECT_EQ(drained, 2);
+}
+
+TEST(MPSCQueue, ConcurrentProducersKeepPerProducerOrder) {
+	MPSCQueue<std::pair<int, int>> queue;
+	const int producer_count = 4;
+	const int per_producer = 20000;
+	std::vector<std::thread> producers;
+	for (int p = 0; p < producer_count; ++p) {
+		producers.emplace_back([&queue, p] {
+			for (int i = 0; i < per_producer; ++i) {
+				queue.Push({p, i});
+			}
+		});
+	}
+
+	std::vector<int> next(producer_count, 0);
+	int total = 0;
+	bool ordered = true;
+	const auto check = [&](std::pair<int, int>&& item) {
+		ordered = ordered && item.second == next[item.first];
+		++next[item.first];
+		++total;
+	};
+	while (total < producer_count * per_producer) {
+		queue.ConsumeAll(check);
+	}
+	for (auto& producer : producers) {
+		producer.join();
+	}
+	queue.ConsumeAll(check);
+	EXPECT_TRUE(ordered);
+	EXPECT_EQ(total, producer_count * per_producer);
+}
+
+TEST(EventQueue, EntityFilteredSubscriberOnlyGetsItsEntity) {
+	MPSCTestReceiver all;
+	MPSCTestReceiver filtered(42);
+	auto events = EventSystem<MPSCTestEvent>::Get();
+	events->Emit(42, std::make_shared<MPSCTestEvent>(MPSCTestEvent{1}));
+	events->Emit(7, std::make_shared<MPSCTestEvent>(MPSCTestEvent{2}));
+
+	all.ProcessEventQueue();
+	filtered.ProcessEventQueue();
+	EXPECT_EQ(all.received, (std::vector<std::pair<eid, int>>{{42, 1}, {7, 2}}));
+	EXPECT_EQ(filtered.received, (std::vector<std::pair<eid, int>>{{42, 1}}));
+
+	events->Unsubscribe(&all);
+	events->Unsubscribe(42, &filtered);
+}
+} // namespace tec
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+#include "game-state.hpp"
+#include "physics-system.hpp"
+#include "physics-test-scene.hpp"
+
+namespace tec {
+namespace {
+const eid FLOOR_ENTITY_ID = 1;
+const eid BLOCK_ENTITY_ID = 2;
+
+// The floor, and a static 2x2x2 block standing on it at the origin.
+void BuildScene(PhysicsSystem& physics) {
+	GameState state;
+	SpawnFloor(state, FLOOR_ENTITY_ID);
+	SpawnBox(state, BLOCK_ENTITY_ID, glm::vec3(0.f, 1.f, 0.f), glm::vec3(1.f));
+	physics.Update(1.0 / 60.0, state);
+}
+
+PhysicsQuery DownwardRay(const float x) {
+	PhysicsQuery query;
+	query.from = glm::vec3(x, 10.f, 0.f);
+	query.to = glm::vec3(x, -10.f, 0.f);
+	return query;
+}
+} // namespace
+
+TEST(PhysicsQuery, RayFindsClosestHit) {
+	PhysicsSystem physics;
+	BuildScene(physics);
+	const std::vector<PhysicsQuery> queries{DownwardRay(0.f), DownwardRay(10.f)};
+	std::vector<PhysicsQueryHit> results(queries.size());
+	physics.Query(queries, results);
+
+	ASSERT_TRUE(results[0].hit);
+	EXPECT_EQ(results[0].entity_id, BLOCK_ENTITY_ID);
+	EXPECT_NEAR(results[0].point.y, 2.f, 0.05f);
+	EXPECT_NEAR(results[0].normal.y, 1.f, 0.01f);
+	EXPECT_NEAR(results[0].fraction, 0.4f, 0.01f);
+
+	ASSERT_TRUE(results[1].hit);
+	EXPECT_EQ(results[1].entity_id, FLOOR_ENTITY_ID);
+	EXPECT_NEAR(results[1].point.y, 0.f, 0.05f);
+}
+
+TEST(PhysicsQuery, SkipsIgnoredEntity) {
+	PhysicsSystem physics;
+	BuildScene(physics);
+	PhysicsQuery query = DownwardRay(0.f);
+	query.ignore_entity = BLOCK_ENTITY_ID;
+	PhysicsQueryHit result;
+	physics.Query({&query, 1}, {&result, 1});
+
+	ASSERT_TRUE(result.hit);
+	EXPECT_EQ(result.entity_id, FLOOR_ENTITY_ID);
+}
+
+TEST(PhysicsQuery, MissLeavesEmptyResult) {
+	PhysicsSystem physics;
+	BuildScene(physics);
+	PhysicsQuery query;
+	query.from = glm::vec3(0.f, 10.f, 0.f);
+	query.to = glm::vec3(0.f, 20.f, 0.f);
+	PhysicsQueryHit result;
+	physics.Query({&query, 1}, {&result, 1});
+
+	EXPECT_FALSE(result.hit);
+	EXPECT_EQ(result.entity_id, eid{0});
+}
+
+TEST(PhysicsQuery, SweepsStopAtContact) {
+	PhysicsSystem physics;
+	BuildScene(physics);
+	PhysicsQuery sphere = DownwardRay(0.f);
+	sphere.shape = PhysicsQuery::Shape::Sphere;
+	sphere.radius = 0.5f;
+	PhysicsQuery box = DownwardRay(0.f);
+	box.shape = PhysicsQuery::Shape::Box;
+	box.half_extents = glm::vec3(0.5f);
+	const std::vector<PhysicsQuery> queries{sphere, box};
+	std::vector<PhysicsQueryHit> results(queries.size());
+	physics.Query(queries, results);
+
+	for (const PhysicsQueryHit& result : results) {
+		ASSERT_TRUE(result.hit);
+		EXPECT_EQ(result.entity_id, BLOCK_ENTITY_ID);
+		// the shape's center stops half a unit above the block's top
+		EXPECT_NEAR(result.fraction, 0.375f, 0.01f);
+		EXPECT_NEAR(result.point.y, 2.f, 0.05f);
+	}
+}
+
+TEST(PhysicsQuery, ParallelBatchMatchesSerial) {
+	PhysicsSystem physics;
+	BuildScene(physics);
+	std::vector<PhysicsQuery> queries;
+	for (int i = 0; i < 200; ++i) {
+		queries.push_back(DownwardRay(static_cast<float>(i % 40) * 0.1f - 2.f));
+	}
+	std::vector<PhysicsQueryHit> serial(queries.size());
+	std::vector<PhysicsQueryHit> parallel(queries.size());
+	physics.Query(queries, serial);
+	physics.Query(queries, parallel, true);
+
+	for (std::size_t i = 0; i < queries.size(); ++i) {
+		EXPECT_EQ(parallel[i].hit, serial[i].hit);
+		EXPECT_EQ(parallel[i].entity_id, serial[i].entity_id);
+		EXPECT_FLOAT_EQ(parallel[i].fraction, serial[i].fraction);
+	}
+}
+
+TEST(PhysicsQuery, RejectsShortResults) {
+	PhysicsSystem physics;
+	const std::vector<PhysicsQuery> queries(2);
+	std::vector<PhysicsQueryHit> results(1);
+	EXPECT_THROW(physics.Query(queries, results), std::invalid_argument);
+}
+} // namespace tec
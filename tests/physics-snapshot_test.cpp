@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "game-state.hpp"
+#include "physics-system.hpp"
+#include "physics-test-scene.hpp"
+#include "tick-arena.hpp"
+
+namespace tec {
+namespace {
+const eid FLOOR_ENTITY_ID = 1;
+const eid BOX_ENTITY_ID = 2;
+const eid OTHER_BOX_ENTITY_ID = 3;
+const double STEP = 1.0 / 60.0;
+
+// The floor, and two boxes falling onto it from y = 3 well apart from each other.
+void BuildScene(PhysicsSystem& physics) {
+	GameState state;
+	SpawnFloor(state, FLOOR_ENTITY_ID);
+	SpawnBox(state, BOX_ENTITY_ID, glm::vec3(0.f, 3.f, 0.f), glm::vec3(0.5f), 1.f);
+	SpawnBox(state, OTHER_BOX_ENTITY_ID, glm::vec3(10.f, 3.f, 0.f), glm::vec3(0.5f), 1.f);
+	physics.SetSubstepping(0);
+	physics.Update(STEP, state);
+}
+} // namespace
+
+TEST(PhysicsSnapshot, RestoresBodies) {
+	PhysicsSystem physics;
+	BuildScene(physics);
+	const glm::vec3 saved = physics.GetPosition(BOX_ENTITY_ID).value;
+	physics.SaveSnapshot(1);
+
+	TickArena::BeginTick();
+	physics.Resimulate(20, STEP);
+	ASSERT_LT(physics.GetPosition(BOX_ENTITY_ID).value.y, saved.y);
+
+	ASSERT_TRUE(physics.RestoreSnapshot(1));
+	EXPECT_NEAR(physics.GetPosition(BOX_ENTITY_ID).value.y, saved.y, 1e-4f);
+}
+
+TEST(PhysicsSnapshot, ResimulationRepeatsTheFirstRun) {
+	PhysicsSystem physics;
+	BuildScene(physics);
+	physics.SaveSnapshot(1);
+
+	// long enough for the box to land and come to rest on the floor
+	TickArena::BeginTick();
+	const auto moved = physics.Resimulate(90, STEP);
+	EXPECT_EQ(moved.size(), 2u);
+	const glm::vec3 first = physics.GetPosition(BOX_ENTITY_ID).value;
+	EXPECT_NEAR(first.y, 0.5f, 0.05f);
+
+	ASSERT_TRUE(physics.RestoreSnapshot(1));
+	physics.Resimulate(90, STEP);
+	const glm::vec3 second = physics.GetPosition(BOX_ENTITY_ID).value;
+	EXPECT_NEAR(second.x, first.x, 1e-4f);
+	EXPECT_NEAR(second.y, first.y, 1e-4f);
+	EXPECT_NEAR(second.z, first.z, 1e-4f);
+}
+
+TEST(PhysicsSnapshot, RollsBackOnlyListedBodies) {
+	PhysicsSystem physics;
+	BuildScene(physics);
+	const glm::vec3 saved = physics.GetPosition(BOX_ENTITY_ID).value;
+	physics.SaveSnapshot(1);
+
+	TickArena::BeginTick();
+	physics.Resimulate(20, STEP);
+	const glm::vec3 other = physics.GetPosition(OTHER_BOX_ENTITY_ID).value;
+	const std::vector<eid> listed{BOX_ENTITY_ID};
+	ASSERT_TRUE(physics.RestoreSnapshot(1, listed));
+	EXPECT_NEAR(physics.GetPosition(BOX_ENTITY_ID).value.y, saved.y, 1e-4f);
+	EXPECT_FLOAT_EQ(physics.GetPosition(OTHER_BOX_ENTITY_ID).value.y, other.y);
+
+	// the other box falls along during the steps, but is put back afterwards
+	const auto moved = physics.Resimulate(20, STEP, listed);
+	EXPECT_EQ(moved, (std::pmr::vector<eid>{BOX_ENTITY_ID}));
+	EXPECT_LT(physics.GetPosition(BOX_ENTITY_ID).value.y, saved.y);
+	EXPECT_FLOAT_EQ(physics.GetPosition(OTHER_BOX_ENTITY_ID).value.y, other.y);
+}
+
+TEST(PhysicsSnapshot, ApplyStateSnapsBodies) {
+	PhysicsSystem physics;
+	BuildScene(physics);
+	GameState server_state;
+	server_state.positions[BOX_ENTITY_ID] = Position(glm::vec3(4.f, 2.f, -1.f));
+	physics.ApplyState(server_state);
+
+	const glm::vec3 position = physics.GetPosition(BOX_ENTITY_ID).value;
+	EXPECT_FLOAT_EQ(position.x, 4.f);
+	EXPECT_FLOAT_EQ(position.y, 2.f);
+	EXPECT_FLOAT_EQ(position.z, -1.f);
+}
+
+TEST(PhysicsSnapshot, DropsOldestSnapshots) {
+	PhysicsSystem physics;
+	BuildScene(physics);
+	for (state_id_t id = 1; id <= PhysicsSystem::SNAPSHOT_CAPACITY + 1; ++id) {
+		physics.SaveSnapshot(id);
+	}
+	EXPECT_FALSE(physics.RestoreSnapshot(1));
+	EXPECT_TRUE(physics.RestoreSnapshot(2));
+	EXPECT_TRUE(physics.RestoreSnapshot(PhysicsSystem::SNAPSHOT_CAPACITY + 1));
+	EXPECT_FALSE(physics.RestoreSnapshot(PhysicsSystem::SNAPSHOT_CAPACITY + 2));
+}
+} // namespace tec
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <memory>
+
+#include <components.pb.h>
+
+#include "event-system.hpp"
+#include "events.hpp"
+#include "game-state.hpp"
+
+namespace tec {
+/// Emit the EntityCreated of a box body and put its transform in the state, a mass of 0 makes it static.
+inline void SpawnBox(
+		GameState& state,
+		const eid entity_id,
+		const glm::vec3& position,
+		const glm::vec3& half_extents,
+		const float mass = 0.f) {
+	auto data = std::make_shared<EntityCreated>();
+	data->entity.set_id(entity_id);
+	proto::CollisionBody* body = data->entity.add_components()->mutable_collision_body();
+	body->set_mass(mass);
+	body->mutable_box()->set_x(half_extents.x);
+	body->mutable_box()->set_y(half_extents.y);
+	body->mutable_box()->set_z(half_extents.z);
+	EventSystem<EntityCreated>::Get()->Emit(data);
+	state.positions[entity_id] = Position(position);
+	state.orientations[entity_id] = Orientation();
+}
+
+/// A static floor whose top is at y = 0.
+inline void SpawnFloor(GameState& state, const eid entity_id) {
+	SpawnBox(state, entity_id, glm::vec3(0.f, -1.f, 0.f), glm::vec3(50.f, 1.f, 50.f));
+}
+} // namespace tec
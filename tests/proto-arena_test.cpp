@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+
+#include <game_state.pb.h>
+
+#include "proto-arena.hpp"
+
+namespace tec {
+namespace {
+proto::GameStateUpdate* BuildUpdate(ProtoArena& arena, const int entity_count) {
+	auto* gsu = google::protobuf::Arena::CreateMessage<proto::GameStateUpdate>(&arena.Get());
+	for (int i = 0; i < entity_count; ++i) {
+		proto::Entity* entity = gsu->add_entity();
+		entity->set_id(i);
+		entity->add_components()->mutable_position()->set_x(static_cast<float>(i));
+		entity->add_components()->mutable_orientation()->set_r(1.f);
+	}
+	return gsu;
+}
+} // namespace
+
+TEST(ProtoArena, CreatesMessagesOnTheArena) {
+	ProtoArena arena(1024);
+	proto::GameStateUpdate* gsu = BuildUpdate(arena, 10);
+	EXPECT_EQ(gsu->GetArena(), &arena.Get());
+	EXPECT_EQ(gsu->entity(0).GetArena(), &arena.Get());
+	EXPECT_EQ(gsu->entity_size(), 10);
+	arena.Reset();
+	EXPECT_EQ(arena.Get().SpaceUsed(), 0);
+}
+
+TEST(ProtoArena, GrowsItsBlockToFitTheLastMessage) {
+	ProtoArena arena(1024);
+	BuildUpdate(arena, 1000);
+	const auto needed = static_cast<std::size_t>(arena.Get().SpaceAllocated());
+	EXPECT_GT(needed, 1024);
+	arena.Reset();
+	EXPECT_GE(arena.GetBlockSize(), needed);
+
+	// the same message again fits in the block
+	BuildUpdate(arena, 1000);
+	EXPECT_EQ(static_cast<std::size_t>(arena.Get().SpaceAllocated()), arena.GetBlockSize());
+	arena.Reset();
+}
+
+TEST(ProtoArena, OnePerThread) { EXPECT_EQ(&ProtoArena::ForThread(), &ProtoArena::ForThread()); }
+} // namespace tec
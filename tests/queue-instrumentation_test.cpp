@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+#include "command-queue.hpp"
+#include "event-bus.hpp"
+#include "event-system.hpp"
+#include "queue-instrumentation.hpp"
+
+namespace tec {
+namespace {
+struct InstrumentedEvent {
+	int value{0};
+};
+
+struct InstrumentedBusEvent {
+	int value{0};
+};
+
+class InstrumentedReceiver : public EventQueue<InstrumentedEvent>, public BufferedEventQueue<InstrumentedBusEvent> {
+public:
+	~InstrumentedReceiver() { EventSystem<InstrumentedEvent>::Get()->Unsubscribe(this); }
+	void On(const eid, std::shared_ptr<InstrumentedEvent>) override {}
+	void On(const eid, const InstrumentedBusEvent&) override {}
+};
+
+class InstrumentedSystem : public CommandQueue<InstrumentedSystem> {};
+
+QueueStats FindStats(const char* kind, const char* name) {
+	const auto all = QueueInstrument::GetAll();
+	const auto itr = std::find_if(all.begin(), all.end(), [kind, name](const QueueStats& stats) {
+		return stats.kind == kind && stats.name == name;
+	});
+	EXPECT_NE(itr, all.end()) << kind << " " << name;
+	return itr != all.end() ? *itr : QueueStats{};
+}
+} // namespace
+
+TEST(QueueInstrumentation, CountsEventsAndLatency) {
+	if constexpr (!QUEUE_INSTRUMENTATION) {
+		GTEST_SKIP() << "built without TEC_EVENT_INSTRUMENTATION";
+	}
+	InstrumentedReceiver first, second;
+	EventSystem<InstrumentedEvent>::Get()->Emit(std::make_shared<InstrumentedEvent>());
+	EventSystem<InstrumentedEvent>::Get()->Emit(std::make_shared<InstrumentedEvent>());
+	EventBus<InstrumentedBusEvent>::Get().EmitMany(std::vector<InstrumentedBusEvent>(3));
+
+	QueueStats stats = FindStats("event", "InstrumentedEvent");
+	EXPECT_EQ(stats.emitted, 2);
+	EXPECT_EQ(stats.queued, 4);
+	EXPECT_EQ(stats.depth, 4);
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	first.EventQueue<InstrumentedEvent>::ProcessEventQueue();
+	second.EventQueue<InstrumentedEvent>::ProcessEventQueue();
+	first.BufferedEventQueue<InstrumentedBusEvent>::ProcessEventQueue();
+
+	stats = FindStats("event", "InstrumentedEvent");
+	EXPECT_EQ(stats.handled, 4);
+	EXPECT_EQ(stats.depth, 0);
+	EXPECT_EQ(stats.max_depth, 2);
+	EXPECT_GE(stats.latency_p50_ns, 1000000);
+	EXPECT_GE(stats.latency_max_ns, 1000000);
+
+	stats = FindStats("event", "InstrumentedBusEvent");
+	EXPECT_EQ(stats.emitted, 3);
+	EXPECT_EQ(stats.queued, 6);
+	EXPECT_EQ(stats.handled, 3);
+	EXPECT_EQ(stats.depth, 3);
+	second.BufferedEventQueue<InstrumentedBusEvent>::ProcessEventQueue();
+}
+
+TEST(QueueInstrumentation, CountsCommands) {
+	if constexpr (!QUEUE_INSTRUMENTATION) {
+		GTEST_SKIP() << "built without TEC_EVENT_INSTRUMENTATION";
+	}
+	InstrumentedSystem system;
+	InstrumentedSystem::QueueCommand([](InstrumentedSystem*) {});
+	InstrumentedSystem::QueueCommand([](InstrumentedSystem*) {});
+	system.ProcessCommandQueue();
+
+	const QueueStats stats = FindStats("command", "InstrumentedSystem");
+	EXPECT_EQ(stats.emitted, 2);
+	EXPECT_EQ(stats.handled, 2);
+	EXPECT_EQ(stats.last_depth, 2);
+	std::uint64_t histogram_total = 0;
+	for (const auto count : stats.latency_histogram) {
+		histogram_total += count;
+	}
+	EXPECT_EQ(histogram_total, 2);
+}
+} // namespace tec
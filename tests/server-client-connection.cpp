@@ -8,6 +8,7 @@
 #include "server-stats.hpp"
 #include "server/client-connection.hpp"
 #include "server/server.hpp"
+#include "entity-id-allocator.hpp"
 #include "tec-types.hpp"
 #include <asio.hpp>
 #include <file-factories.hpp>
@@ -19,9 +20,9 @@
 const tec::eid BASE_ENTITY_ID = 10000;
 
 namespace tec {
-eid GetNextEntityId() {
-	static eid entity_id = BASE_ENTITY_ID;
-	return entity_id++;
+EntityIdAllocator& GetEntityIdAllocator() {
+	static EntityIdAllocator entity_id_allocator(BASE_ENTITY_ID);
+	return entity_id_allocator;
 }
 namespace networking {
 
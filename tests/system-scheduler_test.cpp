@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "system-scheduler.hpp"
+
+namespace tec {
+namespace {
+struct Foo {};
+struct Bar {};
+
+// Waits for the other system to arrive too, false if it didn't within a second.
+bool Rendezvous(std::atomic<int>& arrived) {
+	++arrived;
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+	while (arrived < 2) {
+		if (std::chrono::steady_clock::now() > deadline) {
+			return false;
+		}
+		std::this_thread::yield();
+	}
+	return true;
+}
+} // namespace
+
+TEST(SystemAccess, ConflictsOnSharedWrites) {
+	EXPECT_FALSE(SystemAccess().Reads<Foo>().ConflictsWith(SystemAccess().Reads<Foo>()));
+	EXPECT_FALSE(SystemAccess().Writes<Foo>().ConflictsWith(SystemAccess().Writes<Bar>()));
+	EXPECT_TRUE(SystemAccess().Writes<Foo>().ConflictsWith(SystemAccess().Reads<Foo>()));
+	EXPECT_TRUE((SystemAccess().Reads<Bar, Foo>().ConflictsWith(SystemAccess().Writes<Foo>())));
+	EXPECT_TRUE(SystemAccess().Writes<Foo>().ConflictsWith(SystemAccess().Writes<Foo>()));
+	EXPECT_TRUE(SystemAccess().Exclusive().ConflictsWith(SystemAccess()));
+}
+
+TEST(SystemScheduler, RunsReadersConcurrently) {
+	SystemScheduler scheduler(2);
+	std::atomic<int> arrived{0};
+	bool first_met = false, second_met = false;
+	scheduler.Add("test.first", SystemAccess().Reads<Foo>(), [&](double) { first_met = Rendezvous(arrived); });
+	scheduler.Add("test.second", SystemAccess().Reads<Foo>(), [&](double) { second_met = Rendezvous(arrived); });
+	scheduler.Run(0.0);
+	EXPECT_TRUE(first_met);
+	EXPECT_TRUE(second_met);
+}
+
+TEST(SystemScheduler, KeepsTheOrderOfConflictingSystems) {
+	SystemScheduler scheduler(4);
+	std::vector<int> order;
+	scheduler.Add("test.writer", SystemAccess().Writes<Foo>(), [&](double) { order.push_back(1); });
+	scheduler.Add("test.other", SystemAccess().Writes<Bar>(), [](double) {});
+	scheduler.Add("test.reader", SystemAccess().Reads<Foo>(), [&](double) { order.push_back(2); });
+	scheduler.Add("test.exclusive", SystemAccess().Exclusive(), [&](double) { order.push_back(3); });
+	for (int frame = 0; frame < 10; ++frame) {
+		order.clear();
+		scheduler.Run(0.0);
+		EXPECT_EQ(order, std::vector<int>({1, 2, 3}));
+	}
+
+	const std::vector<SystemRun>& timeline = scheduler.GetTimeline();
+	ASSERT_EQ(timeline.size(), 4);
+	EXPECT_TRUE(timeline[1].after.empty());
+	EXPECT_EQ(timeline[2].after, std::vector<std::size_t>({0}));
+	EXPECT_EQ(timeline[3].after, std::vector<std::size_t>({0, 1, 2}));
+	EXPECT_GE(timeline[2].start, timeline[0].end);
+	EXPECT_GE(timeline[3].start, timeline[2].end);
+}
+
+TEST(SystemScheduler, RunsCallerSystemsOnTheCallingThread) {
+	SystemScheduler scheduler(2);
+	scheduler.Add("test.pool", SystemAccess().Writes<Foo>(), [](double) {});
+	scheduler.Add("test.caller", SystemAccess().Reads<Foo>().OnCallerThread(), [](double) {});
+	scheduler.Run(0.0);
+	EXPECT_NE(scheduler.GetTimeline()[0].thread, std::this_thread::get_id());
+	EXPECT_EQ(scheduler.GetTimeline()[1].thread, std::this_thread::get_id());
+}
+} // namespace tec
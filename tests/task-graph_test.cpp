@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <asio/thread_pool.hpp>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "task-graph.hpp"
+
+namespace tec {
+TEST(TaskGraph, RunsTasksAfterTheirDependencies) {
+	asio::thread_pool pool(4);
+	std::mutex order_mutex;
+	std::vector<int> order;
+	auto record = [&](int value) {
+		std::lock_guard lock(order_mutex);
+		order.push_back(value);
+	};
+
+	TaskGraph graph;
+	const TaskGraph::TaskId first = graph.Add("test.first", [&]() { record(1); });
+	const TaskGraph::TaskId left = graph.Add("test.left", [&]() { record(2); }, {first});
+	const TaskGraph::TaskId right = graph.Add("test.right", [&]() { record(2); }, {first});
+	graph.Add("test.last", [&]() { record(3); }, {left, right});
+	graph.Run(pool);
+
+	ASSERT_EQ(order.size(), 4);
+	EXPECT_EQ(order, std::vector<int>({1, 2, 2, 3}));
+	pool.join();
+}
+
+TEST(TaskGraph, CanRunAgain) {
+	asio::thread_pool pool(2);
+	std::atomic<int> runs{0};
+	TaskGraph graph;
+	const TaskGraph::TaskId first = graph.Add("test.first", [&]() { ++runs; });
+	graph.Add("test.second", [&]() { ++runs; }, {first});
+	graph.Run(pool);
+	graph.Run(pool);
+	EXPECT_EQ(runs, 4);
+
+	graph.Clear();
+	EXPECT_EQ(graph.Size(), 0);
+	graph.Run(pool);
+	EXPECT_EQ(runs, 4);
+	pool.join();
+}
+
+TEST(TaskGraph, SkipsDependentsOfAFailedTask) {
+	asio::thread_pool pool(2);
+	bool dependent_ran = false;
+	bool independent_ran = false;
+	TaskGraph graph;
+	const TaskGraph::TaskId failing = graph.Add("test.failing", []() { throw std::runtime_error("failed"); });
+	graph.Add("test.dependent", [&]() { dependent_ran = true; }, {failing});
+	graph.Add("test.independent", [&]() { independent_ran = true; });
+
+	EXPECT_THROW(graph.Run(pool), std::runtime_error);
+	EXPECT_FALSE(dependent_ran);
+	EXPECT_TRUE(independent_ran);
+	pool.join();
+}
+
+TEST(TaskGraph, RejectsDependenciesAddedLater) {
+	TaskGraph graph;
+	EXPECT_THROW(graph.Add("test.task", []() {}, {0}), std::invalid_argument);
+}
+} // namespace tec
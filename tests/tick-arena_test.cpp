@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory_resource>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "tick-arena.hpp"
+
+namespace tec {
+TEST(TickArena, ReusesMemoryOnceATickEnds) {
+	TickArena& arena = TickArena::Get();
+	TickArena::BeginTick();
+	const void* first = nullptr;
+	{
+		std::pmr::vector<int> values(&arena);
+		values.resize(100);
+		first = values.data();
+		EXPECT_GE(arena.GetStats().used, 100 * sizeof(int));
+	}
+	TickArena::BeginTick();
+	{
+		std::pmr::vector<int> values(&arena);
+		values.resize(100);
+		EXPECT_EQ(values.data(), first);
+	}
+	EXPECT_GE(arena.GetStats().high_water, 100 * sizeof(int));
+}
+
+TEST(TickArena, KeepsLiveMemoryAcrossTicks) {
+	TickArena& arena = TickArena::Get();
+	TickArena::BeginTick();
+	std::pmr::vector<int> kept({1, 2, 3}, &arena);
+	TickArena::BeginTick();
+	std::pmr::vector<int> other({4, 5, 6}, &arena);
+	EXPECT_NE(kept.data(), other.data());
+	EXPECT_EQ(kept, std::pmr::vector<int>({1, 2, 3}));
+}
+
+TEST(TickArena, StopsAllocatingBlocksInTheSteadyState) {
+	TickArena& arena = TickArena::Get();
+	auto tick = [&arena]() {
+		TickArena::BeginTick();
+		std::pmr::set<std::uint64_t> ids(&arena);
+		for (std::uint64_t id = 0; id < 10000; ++id) {
+			ids.insert(id);
+		}
+		std::pmr::vector<char> big(TickArena::BLOCK_SIZE * 2, 'x', &arena);
+	};
+	tick();
+	tick(); // coalesces the blocks the first tick needed into one
+	const std::uint64_t blocks = arena.GetStats().block_allocations;
+	for (int i = 0; i < 10; ++i) {
+		tick();
+	}
+	EXPECT_EQ(arena.GetStats().block_allocations, blocks);
+}
+
+TEST(TickArena, HonorsAlignment) {
+	TickArena& arena = TickArena::Get();
+	TickArena::BeginTick();
+	std::pmr::polymorphic_allocator<std::byte> allocator(&arena);
+	void* unaligned = allocator.allocate_bytes(1, 1);
+	void* aligned = allocator.allocate_bytes(64, 64);
+	EXPECT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 64, 0);
+	allocator.deallocate_bytes(aligned, 64, 64);
+	allocator.deallocate_bytes(unaligned, 1, 1);
+}
+
+TEST(TickArena, OnePerThread) {
+	const TickArena* main_arena = &TickArena::Get();
+	const TickArena* other_arena = nullptr;
+	std::thread([&other_arena]() { other_arena = &TickArena::Get(); }).join();
+	EXPECT_NE(main_arena, other_arena);
+}
+} // namespace tec
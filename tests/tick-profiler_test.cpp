@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "tick-profiler.hpp"
+
+namespace tec {
+namespace {
+using namespace std::chrono_literals;
+
+const PhaseStats* FindPhase(const std::vector<PhaseStats>& all, const std::string& name) {
+	for (const PhaseStats& stats : all) {
+		if (stats.name == name) {
+			return &stats;
+		}
+	}
+	return nullptr;
+}
+} // namespace
+
+TEST(TickProfiler, ReportsPercentilesPerPhase) {
+	TickProfiler& profiler = TickProfiler::Get();
+	profiler.Reset();
+	for (int i = 1; i <= 100; ++i) {
+		profiler.Record("test.linear", std::chrono::milliseconds(i));
+		profiler.Record("test.constant", 2ms);
+	}
+
+	const std::vector<PhaseStats> all = profiler.GetStats();
+	ASSERT_EQ(all.size(), 2);
+	EXPECT_EQ(all[0].name, "test.linear"); // in order of first use
+	const PhaseStats* linear = FindPhase(all, "test.linear");
+	EXPECT_EQ(linear->samples, 100);
+	EXPECT_DOUBLE_EQ(linear->last_ms, 100.0);
+	EXPECT_DOUBLE_EQ(linear->p50_ms, 51.0);
+	EXPECT_DOUBLE_EQ(linear->p95_ms, 95.0);
+	EXPECT_DOUBLE_EQ(linear->p99_ms, 99.0);
+	EXPECT_DOUBLE_EQ(linear->max_ms, 100.0);
+	const PhaseStats* constant = FindPhase(all, "test.constant");
+	EXPECT_DOUBLE_EQ(constant->p50_ms, 2.0);
+	EXPECT_DOUBLE_EQ(constant->p99_ms, 2.0);
+}
+
+TEST(TickProfiler, KeepsOnlyTheLastWindow) {
+	TickProfiler& profiler = TickProfiler::Get();
+	profiler.Reset();
+	profiler.Record("test.window", 50ms);
+	for (std::size_t i = 0; i < TickProfiler::WINDOW; ++i) {
+		profiler.Record("test.window", 1ms);
+	}
+
+	const std::vector<PhaseStats> all = profiler.GetStats();
+	const PhaseStats* window = FindPhase(all, "test.window");
+	ASSERT_NE(window, nullptr);
+	EXPECT_EQ(window->samples, TickProfiler::WINDOW + 1);
+	EXPECT_DOUBLE_EQ(window->max_ms, 1.0); // the 50ms sample has rolled out
+}
+
+TEST(TickProfiler, ScopeRecordsOnceFromAnyThread) {
+	TickProfiler& profiler = TickProfiler::Get();
+	profiler.Reset();
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; ++t) {
+		threads.emplace_back([] {
+			for (int i = 0; i < 10; ++i) {
+				ProfileScope scope("test.scope");
+				scope.Stop();
+				scope.Stop();
+			}
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	const std::vector<PhaseStats> all = profiler.GetStats();
+	const PhaseStats* scope = FindPhase(all, "test.scope");
+	ASSERT_NE(scope, nullptr);
+	EXPECT_EQ(scope->samples, 40);
+}
+} // namespace tec
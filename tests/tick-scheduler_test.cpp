@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+
+#include "tick-scheduler.hpp"
+
+namespace tec {
+namespace {
+using namespace std::chrono_literals;
+
+// Runs on a fake clock that only moves when told to, or when sleeping.
+class FakeClockScheduler : public TickScheduler {
+public:
+	using TickScheduler::TickScheduler;
+
+	void Advance(const Clock::duration amount) { this->now += amount; }
+
+	std::uint32_t sleeps{0};
+
+protected:
+	Clock::time_point Now() const override { return this->now; }
+	void SleepUntil(const Clock::time_point deadline) override {
+		++this->sleeps;
+		this->now = deadline;
+	}
+
+private:
+	Clock::time_point now{};
+};
+
+TickScheduler::Config MakeConfig() {
+	TickScheduler::Config config{0.010, 0.040};
+	config.max_catch_up_ticks = 3;
+	config.overrun_window = 4;
+	config.degrade_overruns = 2;
+	config.max_send_divisor = 2;
+	return config;
+}
+} // namespace
+
+TEST(TickScheduler, SleepsUntilEachDeadline) {
+	FakeClockScheduler scheduler(MakeConfig());
+	int sends = 0;
+	for (int i = 0; i < 8; ++i) {
+		const TickScheduler::Tick tick = scheduler.WaitForTick();
+		EXPECT_EQ(tick.index, i);
+		EXPECT_EQ(tick.delta, 0.010);
+		sends += tick.send;
+		scheduler.Advance(2ms);
+		scheduler.EndTick();
+	}
+	EXPECT_EQ(scheduler.sleeps, 7); // the first tick starts right away
+	EXPECT_EQ(sends, 2); // one every 4 ticks
+	EXPECT_EQ(scheduler.GetStats().overruns, 0);
+	EXPECT_EQ(scheduler.GetStats().max_lateness_ns, 0);
+	EXPECT_EQ(scheduler.GetStats().max_duration_ns, 2000000);
+	EXPECT_EQ(scheduler.GetStats().duration_histogram[10], 8); // 2000us is in [1024, 2048)
+}
+
+TEST(TickScheduler, CatchesUpThenDropsBacklog) {
+	FakeClockScheduler scheduler(MakeConfig());
+	scheduler.WaitForTick();
+	scheduler.EndTick();
+
+	// 25ms late: two ticks due, run back to back without sleeping
+	scheduler.Advance(25ms);
+	scheduler.WaitForTick();
+	scheduler.EndTick();
+	scheduler.WaitForTick();
+	scheduler.EndTick();
+	EXPECT_EQ(scheduler.sleeps, 0);
+	EXPECT_EQ(scheduler.GetStats().skipped, 0);
+
+	// 95ms behind the next deadline is 9 ticks, more than 3 to catch up: 6 are dropped
+	scheduler.Advance(100ms);
+	for (int i = 0; i < 4; ++i) {
+		scheduler.WaitForTick();
+		scheduler.EndTick();
+	}
+	EXPECT_EQ(scheduler.GetStats().skipped, 6);
+	EXPECT_EQ(scheduler.sleeps, 0);
+	scheduler.WaitForTick();
+	EXPECT_EQ(scheduler.sleeps, 1);
+}
+
+TEST(TickScheduler, DropsOnlyBacklogBeyondCap) {
+	FakeClockScheduler scheduler(MakeConfig());
+	scheduler.WaitForTick();
+	scheduler.EndTick();
+
+	// 21 ticks are due from 10ms to 210ms, the last one and 3 before it are run
+	scheduler.Advance(215ms);
+	std::uint64_t index = 0;
+	for (int i = 0; i < 4; ++i) {
+		index = scheduler.WaitForTick().index;
+		scheduler.EndTick();
+	}
+	EXPECT_EQ(index, 4);
+	EXPECT_EQ(scheduler.GetStats().skipped, 17);
+	EXPECT_EQ(scheduler.sleeps, 0);
+	// caught up, the next one is due at 220ms
+	scheduler.WaitForTick();
+	EXPECT_EQ(scheduler.sleeps, 1);
+	EXPECT_EQ(scheduler.GetStats().skipped, 17);
+}
+
+TEST(TickScheduler, DegradesSendRateOnOverruns) {
+	FakeClockScheduler scheduler(MakeConfig());
+	for (int i = 0; i < 4; ++i) {
+		scheduler.WaitForTick();
+		scheduler.Advance(15ms); // longer than the 10ms period
+		scheduler.EndTick();
+	}
+	EXPECT_TRUE(scheduler.IsDegraded());
+	EXPECT_EQ(scheduler.GetStats().send_divisor, 2);
+	EXPECT_EQ(scheduler.GetStats().overruns, 4);
+
+	int sends = 0;
+	for (int i = 0; i < 4; ++i) {
+		sends += scheduler.WaitForTick().send;
+		scheduler.EndTick();
+	}
+	EXPECT_LE(sends, 1); // every 8 ticks instead of 4
+	EXPECT_FALSE(scheduler.IsDegraded()); // a clean window restores it
+}
+} // namespace tec